@@ -19,6 +19,8 @@ typedef struct {
   double drive_correction_cutoff; ///< the distance at which to stop trying to turn towards the target. If we are less
                                   ///< than this value, we can continue driving forward to minimize our distance but
                                   ///< will not try to spin around to point directly at the target
+  double drive_max_vel;           ///< how fast the robot drives at full power (inch/s). Turns a drive's end_speed into
+                                  ///< a velocity so consecutive drives flow into each other. 0 to stop between drives
 
   Feedback *drive_feedback;         ///< the default feedback for autonomous driving
   Feedback *turn_feedback;          ///< the defualt feedback for autonomous turning
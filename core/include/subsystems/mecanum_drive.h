@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../core/include/subsystems/odometry/odometry_base.h"
 #include "../core/include/utils/controls/pid.h"
 #include "vex.h"
 
@@ -10,6 +11,7 @@
 /**
  * A class representing the Mecanum drivetrain.
  * Contains 4 motors, a possible IMU (intertial), and a possible undriven perpendicular wheel.
+ * With odometry (such as OdometryHolonomic), it can also drive relative to the field instead of the robot.
  */
 class MecanumDrive {
 
@@ -35,9 +37,12 @@ public:
 
   /**
    * Create the Mecanum drivetrain object
+   *
+   * @param odom odometry, for field-centric driving and auto_drive_to_pose. NULL if there is none
    */
   MecanumDrive(vex::motor &left_front, vex::motor &right_front, vex::motor &left_rear, vex::motor &right_rear,
-               vex::rotation *lateral_wheel = NULL, vex::inertial *imu = NULL, mecanumdrive_config_t *config = NULL);
+               vex::rotation *lateral_wheel = NULL, vex::inertial *imu = NULL, mecanumdrive_config_t *config = NULL,
+               OdometryBase *odom = NULL);
 
   /**
    * Drive the robot using vectors. This handles all the math required for mecanum control.
@@ -61,6 +66,17 @@ public:
    */
   void drive(double left_y, double left_x, double right_x, int power = 2);
 
+  /**
+   * Drive the robot like drive(), but relative to the field: pushing the left joystick forward drives toward +Y on the
+   * field, whichever way the robot is facing. Needs odometry; without it this is the same as drive().
+   *
+   * @param left_y left joystick, Y axis (toward +Y on the field)
+   * @param left_x left joystick, X axis (toward +X on the field)
+   * @param right_x right joystick, X axis (rotation left / right)
+   * @param power =2 how much of a "curve" there should be on drive controls
+   */
+  void drive_field_centric(double left_y, double left_x, double right_x, int power = 2);
+
   /**
    * Drive the robot in a straight line automatically.
    * If the inertial was declared in the constructor, use it to correct while driving.
@@ -87,16 +103,33 @@ public:
    */
   bool auto_turn(double degrees, double speed, bool ignore_imu = false);
 
+  /**
+   * Autonomously drive to a position and rotation on the field, strafing and turning at the same time.
+   * Uses the odometry from the constructor, drive_pid_conf for the distance and turn_pid_conf for the rotation.
+   *
+   * @param target where to end up. Rotation in degrees, CCW positive, like odometry
+   * @param speed the maximum speed to drive and turn at, in percent: 0.0 -> 1.0
+   *
+   * @return whether or not the robot has finished the maneuver
+   */
+  bool auto_drive_to_pose(pose_t target, double speed);
+
+  /**
+   * Stop any automatic maneuver in progress, so the next one starts fresh
+   */
+  void reset_auto();
+
 private:
   vex::motor &left_front, &right_front, &left_rear, &right_rear;
 
   mecanumdrive_config_t *config;
   vex::rotation *lateral_wheel;
   vex::inertial *imu;
+  OdometryBase *odom;
 
   PID *drive_pid = NULL;
   PID *drive_gyro_pid = NULL;
   PID *turn_pid = NULL;
 
   bool init = true;
-};
\ No newline at end of file
+};
\ No newline at end of file
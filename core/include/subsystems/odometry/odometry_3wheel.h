@@ -2,6 +2,7 @@
 #include "../core/include/subsystems/custom_encoder.h"
 #include "../core/include/subsystems/odometry/odometry_base.h"
 #include "../core/include/subsystems/tank_drive.h"
+#include "../core/include/utils/derivative_estimator.h"
 
 /**
  * Odometry3Wheel
@@ -42,6 +43,34 @@ public:
 
   } odometry3wheel_cfg_t;
 
+  /**
+   * One reading of every encoder odometry uses
+   */
+  typedef struct {
+    double lside_deg; ///< left encoder position (degrees)
+    double rside_deg; ///< right encoder position (degrees)
+    double offax_deg; ///< off-axis encoder position (degrees)
+  } odometry3wheel_sample_t;
+
+  /**
+   * Everything odometry remembers between updates. Copy it to run another estimator from the same point
+   */
+  typedef struct {
+    pose_t pos = zero_pos; ///< current position
+
+    double lside_deg; ///< left encoder position at the previous sample
+    double rside_deg; ///< right encoder position at the previous sample
+    double offax_deg; ///< off-axis encoder position at the previous sample
+
+    double speed;         ///< the speed at which we are travelling (inch/s)
+    double accel;         ///< the rate at which we are accelerating (inch/s^2)
+    double ang_speed_deg; ///< the speed at which we are turning (deg/s)
+    double ang_accel_deg; ///< the rate at which we are accelerating our turn (deg/s^2)
+
+    double time;                    ///< total of every dt so far (sec)
+    PoseDerivativeEstimator motion; ///< fits recent positions for the speeds and accelerations
+  } odometry3wheel_state_t;
+
   /**
    * Construct a new Odometry 3 Wheel object
    *
@@ -62,6 +91,30 @@ public:
    */
   pose_t update() override;
 
+  /**
+   * Sets the current position of the robot
+   * @param newpos the new position that the odometry will believe it is at
+   */
+  void set_position(const pose_t &newpos = zero_pos) override;
+
+  /**
+   * Read every encoder odometry uses
+   * @return the current encoder values
+   */
+  odometry3wheel_sample_t read_sensors();
+
+  /**
+   * Advance odometry by one sensor sample. Doesn't touch hardware or anything outside its arguments, so logged
+   * samples can be replayed through it on a computer, or several configurations run side by side.
+   *
+   * @param state the state after the previous sample, updated in place
+   * @param sample the encoder values
+   * @param dt time since the previous sample (sec)
+   * @param cfg the robot's odometry measurements
+   */
+  static void integrate(odometry3wheel_state_t &state, const odometry3wheel_sample_t &sample, double dt,
+                        const odometry3wheel_cfg_t &cfg);
+
   /**
    * A guided tuning process to automatically find tuning parameters.
    * This method is blocking, and returns when tuning has finished. Follow
@@ -75,8 +128,8 @@ public:
 private:
   /**
    * Calculation method for the robot's new position using the change in encoders, the old position, and the robot's
-   * configuration. This uses a series of arclength formulae for finding distance driven and change in angle. Then
-   * vector math is used to combine it with the robot's old position data
+   * configuration. This uses a series of arclength formulae for finding distance driven and change in angle. Then the
+   * old position is moved along the arc those describe (see integrate_arc)
    *
    * @param lside_delta_deg Left encoder change in rotation, in degrees
    * @param rside_delta_deg Right encoder change in rotation, in degrees
@@ -90,4 +143,7 @@ private:
 
   CustomEncoder &lside_fwd, &rside_fwd, &off_axis;
   odometry3wheel_cfg_t &cfg;
+
+  odometry3wheel_state_t state = {};
+  uint64_t last_sample_us = 0; // when the previous sample was read
 };
\ No newline at end of file
@@ -1,14 +1,30 @@
 #pragma once
 
 #include "../core/include/robot_specs.h"
+#include "../core/include/subsystems/odometry/pose_history.h"
 #include "../core/include/utils/command_structure/auto_command.h"
 #include "../core/include/utils/geometry.h"
 #include "vex.h"
+#include <atomic>
+#include <stdint.h>
 
 #ifndef PI
 #define PI 3.141592654
 #endif
 
+/**
+ * Everything odometry knows about the robot at one instant. Published as a unit so readers never see the position
+ * from one update mixed with the speed from another.
+ */
+typedef struct {
+  pose_t pos;           ///< position and rotation
+  double speed;         ///< the speed at which we are travelling (inch/s)
+  double accel;         ///< the rate at which we are accelerating (inch/s^2)
+  double ang_speed_deg; ///< the speed at which we are turning (deg/s)
+  double ang_accel_deg; ///< the rate at which we are accelerating our turn (deg/s^2)
+  uint64_t timestamp_us; ///< vex::timer::systemHighResolution() when this was published
+} odometry_snapshot_t;
+
 /**
  * OdometryBase
  *
@@ -17,6 +33,11 @@
  * holds positional types specific to field orientation.
  *
  * All future odometry implementations should extend this file and redefine update() function.
+ * update() must call publish() once it has written the new position, speed and acceleration.
+ *
+ * There is one writer (update() / set_position(), serialized by mut) and any number of readers. Readers copy the
+ * latest published snapshot through a sequence lock and never take the mutex, so a slow reader can't hold up the
+ * odometry task.
  *
  * @author Ryan McGee
  * @date Aug 11 2021
@@ -36,6 +57,31 @@ public:
    */
   pose_t get_position(void);
 
+  /**
+   * Gets the position, speed and acceleration from the same update, without blocking the odometry task
+   * @return the latest published odometry state
+   */
+  odometry_snapshot_t get_snapshot();
+
+  /**
+   * Gets the position the robot was at some time in the past, for comparing against sensors with latency.
+   * Interpolated from the pose history, which covers about the last 1.28 seconds and is cleared by set_position().
+   * Times older than the history return the oldest pose recorded.
+   *
+   * @param timestamp_us when to look up, from vex::timer::systemHighResolution()
+   * @return the position that the odometry believed the robot was at, at that time
+   */
+  pose_t get_position_at(uint64_t timestamp_us);
+
+  /**
+   * Gets the position the robot was at some time in the past, with its speed
+   *
+   * @param timestamp_us when to look up, from vex::timer::systemHighResolution()
+   * @param out the interpolated position and speed
+   * @return true if timestamp_us was inside the recorded history, false if the result was clamped
+   */
+  bool get_history_at(uint64_t timestamp_us, pose_history_entry_t &out);
+
   /**
    * Sets the current position of the robot
    * @param newpos the new position that the odometry will believe it is at
@@ -48,6 +94,12 @@ public:
    */
   virtual pose_t update() = 0;
 
+  /**
+   * Wait until update() has something new to work from. The background task calls this between updates, without the
+   * mutex held. By default it returns straight away, for odometry that reads its sensors on every update
+   */
+  virtual void wait_for_update();
+
   /**
    * Function that runs in the background task. This function pointer is passed
    * to the vex::task constructor.
@@ -143,4 +195,15 @@ protected:
   double accel;         /**< the rate at which we are accelerating (inch/s^2)*/
   double ang_speed_deg; /**< the speed at which we are turning (deg/s)*/
   double ang_accel_deg; /**< the rate at which we are accelerating our turn (deg/s^2)*/
+
+  /**
+   * Copy current_pos, speed, accel and the angular rates into the snapshot that readers see.
+   * Must be called with mut held (update() is, when running in the background).
+   */
+  void publish();
+
+private:
+  std::atomic<uint32_t> snapshot_seq; ///< odd while publish() is writing the snapshot
+  odometry_snapshot_t snapshot;       ///< the last published state, only read through get_snapshot()
+  PoseHistory history;                ///< every published state for the last second or so
 };
\ No newline at end of file
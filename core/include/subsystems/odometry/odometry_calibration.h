@@ -0,0 +1,138 @@
+#pragma once
+
+#include "../core/include/utils/geometry.h"
+#include "../core/include/utils/least_squares.h"
+#include <vector>
+
+/**
+ * Odometry calibration
+ *
+ * Finds the measurements odometry depends on (wheel diameter, the distances between wheels, ...) from a recording of
+ * the robot driving, instead of from calipers and a guided routine. Drive however you like, stopping now and then at
+ * a known position (against a wall, on a field tile corner, a GPS reading you trust), and record:
+ *  - every sensor sample odometry would have used
+ *  - each known position, along with which sample it goes with
+ * OdometryRecorder (odometry_recorder.h) does both on the brain. Recording by hand, note that OdometryTank's
+ * read_sensors() has already divided by odom_gear_ratio: multiply it back, or the fitted ratio will only be a
+ * correction to the configured one.
+ * The recording is replayed through the same kinematics odometry uses (odometry_kinematics.h) and the measurements
+ * are fit by least squares so the replayed path passes as close as it can to every known position, and the heading
+ * follows the IMU when there is one.
+ *
+ * Nothing here touches hardware. Fit on the brain straight from memory, or save the recording with the
+ * format_calibration_* functions and fit it on a computer with tools/odometry_calibration.
+ */
+
+/**
+ * One reading of the odometry sensors
+ */
+typedef struct {
+  double lside;            ///< left encoder. Odometry3Wheel: degrees. OdometryTank: raw revs, before odom_gear_ratio
+  double rside;            ///< right encoder, in the same units as lside
+  double offax;            ///< off-axis encoder in degrees. Unused for tank drives
+  bool has_imu;            ///< true if imu_rotation_deg was read
+  double imu_rotation_deg; ///< inertial sensor rotation, clockwise positive
+} calibration_sample_t;
+
+/**
+ * A position the robot was known to be at while recording
+ */
+typedef struct {
+  int sample;        ///< index of the sample taken at this position
+  pose_t pos;        ///< where the robot was
+  bool use_position; ///< false if only the rotation is known
+  bool use_rotation; ///< false if only the position is known
+} calibration_reference_t;
+
+/**
+ * A recording to calibrate from. The first reference is where the replay starts; the rest are fit to
+ */
+typedef struct {
+  std::vector<calibration_sample_t> samples;
+  std::vector<calibration_reference_t> references;
+
+  double pos_stddev = 0.5;     ///< how far off a reference position could be (inches)
+  double rot_stddev_deg = 1.0; ///< how far off a reference rotation could be (degrees)
+  double imu_stddev_deg = 2.0; ///< how far the IMU heading could drift over the recording (degrees)
+  int imu_stride = 25;         ///< compare against the IMU every this many samples
+} calibration_log_t;
+
+/**
+ * How far the calibrated odometry ended up from one reference
+ */
+typedef struct {
+  int sample;         ///< index of the sample the reference goes with
+  double x_err;       ///< odometry x - reference x (inches)
+  double y_err;       ///< odometry y - reference y (inches)
+  double rot_err_deg; ///< odometry rotation - reference rotation, the short way around (degrees)
+} calibration_residual_t;
+
+/**
+ * The outcome of a calibration
+ */
+typedef struct {
+  least_squares_result_t fit;                    ///< how the solver went. rms values are in standard deviations
+  std::vector<calibration_residual_t> residuals; ///< errors at each reference after the start, with the fitted values
+} calibration_result_t;
+
+/**
+ * Fit the measurements of a 3 tracking wheel robot (see Odometry3Wheel)
+ *
+ * Every measurement changes something different: wheel_diam scales everything, wheelbase_dist how far the robot
+ * turns, and off_axis_center_dist how far the off-axis wheel moves while turning. So all three can be fit, as long as
+ * the recording has turns as well as straight driving in each direction
+ *
+ * @param log                  the recording
+ * @param wheel_diam           starting guess, replaced by the fitted value
+ * @param wheelbase_dist       starting guess, replaced by the fitted value
+ * @param off_axis_center_dist starting guess, replaced by the fitted value
+ * @return the fit and the errors left at each reference
+ */
+calibration_result_t calibrate_three_wheel(const calibration_log_t &log, double &wheel_diam, double &wheelbase_dist,
+                                           double &off_axis_center_dist);
+
+/**
+ * Fit the measurements of a tank drive (see OdometryTank)
+ *
+ * Only the product of wheel size and gear ratio shows up in the distance driven, so wheel_diam is kept as given and
+ * the ratio absorbs any error in it. When the recording has IMU readings, odometry takes its rotation from the IMU and
+ * dist_between_wheels has no effect, so it is left as given.
+ *
+ * @param log                 the recording
+ * @param wheel_diam          the odometry wheel diameter (inches), not changed
+ * @param gear_ratio          starting guess, replaced by the fitted value
+ * @param dist_between_wheels starting guess, replaced by the fitted value
+ * @return the fit and the errors left at each reference
+ */
+calibration_result_t calibrate_tank(const calibration_log_t &log, double wheel_diam, double &gear_ratio,
+                                    double &dist_between_wheels);
+
+/**
+ * Write a sample as one line of a recording
+ *
+ * @param buf    where to write the line, including the newline
+ * @param len    size of buf
+ * @param sample the sample
+ * @return the number of characters written, as snprintf
+ */
+int format_calibration_sample(char *buf, int len, const calibration_sample_t &sample);
+
+/**
+ * Write a reference as one line of a recording
+ *
+ * @param buf where to write the line, including the newline
+ * @param len size of buf
+ * @param ref the reference. A sample index of -1 means the sample written just before it
+ * @return the number of characters written, as snprintf
+ */
+int format_calibration_reference(char *buf, int len, const calibration_reference_t &ref);
+
+/**
+ * Read one line of a recording written with the format_calibration_* functions into log. Blank lines and lines
+ * starting with # are skipped
+ *
+ * @param line the line
+ * @param log  the recording to add it to
+ * @return false if the line couldn't be understood
+ */
+bool parse_calibration_line(const char *line, calibration_log_t &log);
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "../core/include/subsystems/odometry/odometry_base.h"
+#include "vex.h"
+
+/**
+ * OdometryEKF
+ *
+ * Fuses wheel odometry, the inertial sensor and the GPS sensor with an extended Kalman filter, so the position stays
+ * corrected by the GPS continuously instead of stopping to localize.
+ *
+ * The state is the robot's x, y and rotation, with a 3x3 covariance describing how sure we are of each.
+ * - Predict: every update, the change in the wrapped wheel odometry's position (OdometryTank, Odometry3Wheel) is
+ *   turned into a distance driven forward / sideways in the robot's frame and applied to the state. If an IMU is
+ *   given, its change in rotation is used for the turn instead. Uncertainty grows with the distance driven and
+ *   angle turned.
+ * - Correct: whenever the GPS has a new reading with good enough quality, it is blended in, weighted by how sure the
+ *   filter is versus how noisy the GPS claims to be at its current quality. Readings that disagree wildly with the
+ *   filter (bumped sensor, seeing the wrong field strip) are thrown out.
+ *
+ * The wheel odometry must be constructed with is_async = false. This class runs it from its own background task.
+ *
+ * The GPS heading is turned into odometry's rotation using the turn direction the sensor was constructed with and
+ * what it reads when the robot faces odometry's 0. A GPS with the default turnType::right, facing the robot's front,
+ * reads a compass heading (0 along +y, clockwise), so gps_turn = turnType::right and gps_zero_rot_deg = 90.
+ *
+ * Usage:
+ *   OdometryTank wheel_odom{left_motors, right_motors, robot_cfg, &imu, false};
+ *   OdometryEKF odom{wheel_odom, ekf_cfg, &gps_sensor, &imu};
+ */
+class OdometryEKF : public OdometryBase {
+public:
+  /**
+   * Noise and GPS settings for the filter. Variances are in inches^2 and radians^2
+   */
+  typedef struct {
+    double fwd_var_per_in;  ///< variance added along the direction of travel, per inch driven
+    double side_var_per_in; ///< variance added sideways to the direction of travel, per inch driven
+    double rot_var_per_rad; ///< variance added to the rotation, per radian turned
+
+    double gps_pos_stddev;    ///< standard deviation of a GPS position reading at 100% quality (inches)
+    double gps_rot_stddev;    ///< standard deviation of a GPS heading reading at 100% quality (degrees)
+    int gps_min_quality;      ///< GPS readings below this quality (0-100) are ignored
+    int gps_interval_ms;      ///< time between GPS corrections, so one reading isn't applied over and over
+    double gps_gate;          ///< reject GPS readings more than sqrt(gps_gate) standard deviations off. 0 = never
+    double gps_field_rot_deg; ///< rotate GPS readings about the field center by this much. 180 on the blue side
+    vex::turnType gps_turn;   ///< the turnType the GPS was constructed with. left counts up counter-clockwise
+    double gps_zero_rot_deg;  ///< odometry's rotation when the GPS heading reads 0, on the red side
+  } ekf_cfg_t;
+
+  /**
+   * Create the filter
+   *
+   * @param wheel_odom the wheel odometry to get motion from. Must have been constructed with is_async = false
+   * @param cfg filter tuning. See ekf_cfg_t
+   * @param gps the GPS sensor, or NULL to only use the wheels and IMU. Set cfg.gps_turn and cfg.gps_zero_rot_deg to
+   * match how it was constructed and mounted
+   * @param imu the inertial sensor, or NULL to use the wheel odometry's rotation
+   * @param is_async true to constantly run in the background
+   */
+  OdometryEKF(OdometryBase &wheel_odom, ekf_cfg_t &cfg, vex::gps *gps = NULL, vex::inertial *imu = NULL,
+              bool is_async = true);
+
+  /**
+   * Predict using the wheels and IMU, then correct using the GPS if it has a new reading
+   *
+   * @return the filtered position
+   */
+  pose_t update() override;
+
+  /**
+   * Wait until the wheel odometry has something new, since every update starts from it
+   */
+  void wait_for_update() override;
+
+  /**
+   * Put the robot at a position, trusting it completely
+   *
+   * @param newpos the position the odometry will take
+   */
+  void set_position(const pose_t &newpos = zero_pos) override;
+
+  /**
+   * Get the standard deviation of the filtered position, a rough measure of how far off it might be
+   *
+   * @return sqrt of the x and y variances added together (inches)
+   */
+  double get_position_stddev();
+
+private:
+  /**
+   * Move the state by a change in position measured in the robot's frame, and grow the covariance to match
+   *
+   * @param fwd distance driven forward (inches)
+   * @param side distance driven to the right (inches)
+   * @param turn_rad change in rotation, CCW positive (radians)
+   */
+  void predict(double fwd, double side, double turn_rad);
+
+  /**
+   * Blend a full pose measurement into the state
+   *
+   * @param measured the measured position
+   * @param pos_var variance of the measured x and y (inches^2)
+   * @param rot_var variance of the measured rotation (radians^2)
+   * @return true if the measurement was used, false if it failed the gate
+   */
+  bool correct(const pose_t &measured, double pos_var, double rot_var);
+
+  OdometryBase &wheel_odom;
+  ekf_cfg_t &cfg;
+  vex::gps *gps;
+  vex::inertial *imu;
+
+  pose_t last_wheel_pos; // wheel odometry position at the last update
+  double last_imu_deg;   // IMU rotation at the last update
+  double cov[3][3];      // covariance of x, y, rotation(rad)
+  vex::timer gps_tmr;    // time since the last GPS correction
+};
@@ -0,0 +1,120 @@
+#pragma once
+#include "../core/include/subsystems/custom_encoder.h"
+#include "../core/include/subsystems/odometry/odometry_base.h"
+#include "../core/include/utils/derivative_estimator.h"
+
+/**
+ * OdometryHolonomic
+ *
+ * Odometry for drivetrains that can strafe (mecanum, X drive), where the driven wheels slip too much sideways to track
+ * with. Two undriven tracking wheels measure the movement instead, one rolling forward and one rolling sideways, and
+ * the inertial sensor measures the rotation:
+ *
+ *  +Y   ---------------
+ *  ^    |             |
+ *  |    |        ||   |
+ *  |    |    O        |
+ *  |    |    ===      |
+ *  |    |             |
+ *  |    ---------------
+ *  |
+ *  +-------------------> + X
+ *
+ * Where O is the center of rotation, || is the forward wheel and === the sideways wheel. They can be anywhere on the
+ * robot, as long as their distances from the center are measured.
+ *
+ * Like the other odometry classes, once the object is created the robot will immediately begin tracking its movement
+ * in the background.
+ */
+class OdometryHolonomic : public OdometryBase {
+public:
+  /**
+   * Where the tracking wheels are, and how big they are
+   */
+  typedef struct {
+    double wheel_diam;        ///< the diameter of the tracking wheels
+    double fwd_wheel_offset;  ///< distance from the center of the robot to the forward wheel, to the right
+    double side_wheel_offset; ///< distance from the center of the robot to the sideways wheel, forward
+  } odometryholonomic_cfg_t;
+
+  /**
+   * One reading of every sensor odometry uses
+   */
+  typedef struct {
+    double fwd_deg;          ///< forward wheel encoder position (degrees)
+    double side_deg;         ///< sideways wheel encoder position, positive rolling right (degrees)
+    double imu_rotation_deg; ///< inertial sensor rotation, clockwise positive
+  } odometryholonomic_sample_t;
+
+  /**
+   * Everything odometry remembers between updates. Copy it to run another estimator from the same point
+   */
+  typedef struct {
+    pose_t pos = zero_pos;  ///< current position
+    double rotation_offset; ///< added to the measured angle, so set_position can change the rotation
+    bool initialized;       ///< false until the first sample, which only records where the encoders start
+
+    double fwd_deg;  ///< forward encoder position at the previous sample
+    double side_deg; ///< sideways encoder position at the previous sample
+
+    double speed;         ///< the speed at which we are travelling (inch/s)
+    double accel;         ///< the rate at which we are accelerating (inch/s^2)
+    double ang_speed_deg; ///< the speed at which we are turning (deg/s)
+    double ang_accel_deg; ///< the rate at which we are accelerating our turn (deg/s^2)
+
+    double time;                    ///< total of every dt so far (sec)
+    PoseDerivativeEstimator motion; ///< fits recent positions for the speeds and accelerations
+  } odometryholonomic_state_t;
+
+  /**
+   * Construct a new holonomic odometry object
+   *
+   * @param fwd_wheel encoder on the wheel that rolls when the robot drives forward
+   * @param side_wheel encoder on the wheel that rolls when the robot strafes
+   * @param imu the inertial sensor, for rotation
+   * @param cfg robot odometry configuration
+   * @param is_async true to constantly run in the background
+   */
+  OdometryHolonomic(CustomEncoder &fwd_wheel, CustomEncoder &side_wheel, vex::inertial &imu,
+                    odometryholonomic_cfg_t &cfg, bool is_async = true);
+
+  /**
+   * Update the current position of the robot once, using the current state of the sensors and the previous known
+   * location
+   *
+   * @return the robot's updated position
+   */
+  pose_t update() override;
+
+  /**
+   * Sets the current position of the robot
+   * @param newpos the new position that the odometry will believe it is at
+   */
+  void set_position(const pose_t &newpos = zero_pos) override;
+
+  /**
+   * Read every sensor odometry uses
+   * @return the current sensor values
+   */
+  odometryholonomic_sample_t read_sensors();
+
+  /**
+   * Advance odometry by one sensor sample. Doesn't touch hardware or anything outside its arguments, so logged
+   * samples can be replayed through it on a computer, or several configurations run side by side.
+   *
+   * @param state the state after the previous sample, updated in place
+   * @param sample the sensor values
+   * @param dt time since the previous sample (sec)
+   * @param cfg the robot's odometry measurements
+   */
+  static void integrate(odometryholonomic_state_t &state, const odometryholonomic_sample_t &sample, double dt,
+                        const odometryholonomic_cfg_t &cfg);
+
+private:
+  CustomEncoder &fwd_wheel, &side_wheel;
+  vex::inertial &imu;
+  odometryholonomic_cfg_t &cfg;
+
+  odometryholonomic_state_t state = {};
+  uint64_t last_sample_us = 0; // when the previous sample was read
+};
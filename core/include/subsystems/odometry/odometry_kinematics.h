@@ -0,0 +1,61 @@
+#pragma once
+
+#include "../core/include/utils/geometry.h"
+
+/**
+ * The math that turns wheel movement into robot movement, with no hardware involved.
+ *
+ * OdometryTank, Odometry3Wheel and OdometryHolonomic use these every update, and the calibration solver replays
+ * recorded runs through them, so a fitted configuration means exactly the same thing on the robot. Nothing here
+ * touches hardware, so it also builds on a computer (see tools/host).
+ */
+
+/**
+ * Rotation of a tank robot from how far each side has travelled in total, for when there's no IMU
+ *
+ * @param lside_total total distance the left side has travelled (inches)
+ * @param rside_total total distance the right side has travelled (inches)
+ * @param dist_between_wheels distance between the left and right wheels (inches)
+ * @return the rotation in degrees, with 90 being where the robot started, not wrapped
+ */
+double tank_encoder_angle(double lside_total, double rside_total, double dist_between_wheels);
+
+/**
+ * Move a tank robot by the distance its wheels travelled, along the arc to its new rotation
+ *
+ * @param pos where the robot was
+ * @param lside_dist distance the left side travelled since pos (inches)
+ * @param rside_dist distance the right side travelled since pos (inches)
+ * @param angle_deg the robot's measured rotation now (degrees)
+ * @return the robot's new position
+ */
+pose_t tank_kinematics(const pose_t &pos, double lside_dist, double rside_dist, double angle_deg);
+
+/**
+ * Move a robot with 3 tracking wheels by the distance each wheel travelled
+ *
+ * @param pos where the robot was
+ * @param lside_dist distance the left wheel travelled since pos (inches)
+ * @param rside_dist distance the right wheel travelled since pos (inches)
+ * @param offax_dist distance the off-axis wheel travelled since pos, positive to the robot's right (inches)
+ * @param wheelbase_dist distance between the left and right wheels (inches)
+ * @param off_axis_center_dist distance from the center of the robot to the off-axis wheel (inches)
+ * @return the robot's new position
+ */
+pose_t three_wheel_kinematics(const pose_t &pos, double lside_dist, double rside_dist, double offax_dist,
+                              double wheelbase_dist, double off_axis_center_dist);
+
+/**
+ * Move a holonomic robot (mecanum, X drive) tracked by one forward and one sideways wheel, with the change in
+ * rotation measured separately (an IMU)
+ *
+ * @param pos where the robot was
+ * @param fwd_dist distance the forward tracking wheel travelled since pos (inches)
+ * @param side_dist distance the sideways tracking wheel travelled since pos, positive to the robot's right (inches)
+ * @param delta_rot_rad how far the robot turned since pos, CCW positive (radians)
+ * @param fwd_wheel_offset distance from the center of the robot to the forward wheel, to the right (inches)
+ * @param side_wheel_offset distance from the center of the robot to the sideways wheel, forward (inches)
+ * @return the robot's new position
+ */
+pose_t holonomic_kinematics(const pose_t &pos, double fwd_dist, double side_dist, double delta_rot_rad,
+                            double fwd_wheel_offset, double side_wheel_offset);
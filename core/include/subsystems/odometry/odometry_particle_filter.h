@@ -0,0 +1,115 @@
+#pragma once
+
+#include "../core/include/subsystems/odometry/odometry_base.h"
+#include "../core/include/subsystems/odometry/particle_filter.h"
+#include "vex.h"
+#include <vector>
+
+/**
+ * OdometryParticleFilter
+ *
+ * Corrects wheel odometry by measuring the distance to the field walls with distance sensors, for when the GPS can't
+ * see its strip (next to field elements, robots in the way).
+ *
+ * Every update, the change in the wrapped wheel odometry's position (OdometryTank, Odometry3Wheel) moves a cloud of
+ * particles (see ParticleFilter), so the corrected position is published at the same rate as odometry. Whenever the
+ * distance sensors have had time for new readings, each particle is scored by how well the distances it would see
+ * match what the sensors read, and the cloud is resampled toward the ones that match.
+ *
+ * Only the field perimeter is in the map. Aim the sensors where they usually see a wall, and readings of anything else
+ * are mostly ignored as outliers. With only one or two sensors the walls say little about the rotation, so the
+ * particles' rotation is checked against the wheels' now and then, and the filter starts over if it has lost track
+ * (see ParticleFilter::check_rotation).
+ *
+ * The wheel odometry must be constructed with is_async = false. This class runs it from its own background task.
+ *
+ * Usage:
+ *   OdometryTank wheel_odom{left_motors, right_motors, robot_cfg, &imu, false};
+ *   OdometryParticleFilter odom{wheel_odom, pf_cfg, {{&left_dist, -6, 0, 90, 60}, {&back_dist, 0, -7, 180, 60}}};
+ */
+class OdometryParticleFilter : public OdometryBase {
+public:
+  /**
+   * Noise and sensor settings for the filter
+   */
+  typedef struct {
+    int num_particles; ///< how many guesses to keep. See tools/benchmark/particle_filter_bench.cpp for the cost
+
+    double fwd_var_per_in;  ///< variance added along the direction of travel, per inch driven (inches^2)
+    double side_var_per_in; ///< variance added sideways to the direction of travel, per inch driven (inches^2)
+    double rot_var_per_rad; ///< variance added to the rotation, per radian turned (radians^2)
+    double rot_var_per_in;  ///< variance added to the rotation, per inch driven (radians^2). Wheels slipping turn the
+                            ///< robot a little even driving straight, and without this the particles can't follow it
+
+    double range_stddev;    ///< standard deviation of a distance sensor reading (inches)
+    double outlier_prob;    ///< chance a reading is of something other than a wall, from 0 to 1
+    int sensor_interval_ms; ///< time between corrections, so one reading isn't applied over and over
+
+    double reset_pos_stddev;     ///< how far set_position scatters the particles (inches)
+    double reset_rot_stddev_deg; ///< how far set_position scatters the particles' rotations (degrees)
+
+    double check_window_in;       ///< distance between checks of the particles' rotation against the wheels' (inches).
+                                  ///< 0 to never check. 36 is a good start
+    double check_max_rot_err_deg; ///< how far the particles' rotation may drift from the wheels' over one window before
+                                  ///< the filter starts over from the wheels' rotation (degrees). 12 is a good start
+  } pf_cfg_t;
+
+  /**
+   * A distance sensor and where it's mounted
+   */
+  typedef struct {
+    vex::distance *sensor; ///< the sensor
+    double x;              ///< distance from the robot's center to the sensor, to the right (inches)
+    double y;              ///< distance from the robot's center to the sensor, forward (inches)
+    double dir_deg;        ///< direction it points, CCW positive from straight ahead (degrees)
+    double max_range;      ///< readings farther than this are ignored (inches)
+  } distance_mount_t;
+
+  /**
+   * Create the filter
+   *
+   * @param wheel_odom the wheel odometry to get motion from. Must have been constructed with is_async = false
+   * @param cfg filter tuning. See pf_cfg_t
+   * @param sensors the distance sensors to measure the walls with
+   * @param field the walls, 144 inches square from the origin by default
+   * @param is_async true to constantly run in the background
+   */
+  OdometryParticleFilter(OdometryBase &wheel_odom, pf_cfg_t &cfg, const std::vector<distance_mount_t> &sensors,
+                         Rect field = {{0, 0}, {144, 144}}, bool is_async = true);
+
+  /**
+   * Move the particles using the wheels, then correct using the distance sensors if they have new readings
+   *
+   * @return the filtered position
+   */
+  pose_t update() override;
+
+  /**
+   * Wait until the wheel odometry has something new, since every update starts from it
+   */
+  void wait_for_update() override;
+
+  /**
+   * Put the robot at a position, scattering the particles around it by reset_pos_stddev and reset_rot_stddev_deg
+   *
+   * @param newpos the position the odometry will take
+   */
+  void set_position(const pose_t &newpos = zero_pos) override;
+
+  /**
+   * Get the spread of the particles, a rough measure of how far off the position might be
+   *
+   * @return the standard deviation of the particles' positions (inches)
+   */
+  double get_position_stddev();
+
+private:
+  OdometryBase &wheel_odom;
+  pf_cfg_t &cfg;
+  std::vector<distance_mount_t> sensors;
+  std::vector<ParticleFilter::ray_t> rays; // sensor mounts, converted for the filter
+  ParticleFilter filter;
+
+  pose_t last_wheel_pos; // wheel odometry position at the last update
+  vex::timer sensor_tmr; // time since the last correction
+};
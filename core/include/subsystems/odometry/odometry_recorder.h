@@ -0,0 +1,103 @@
+#pragma once
+
+#include "../core/include/subsystems/odometry/odometry_3wheel.h"
+#include "../core/include/subsystems/odometry/odometry_calibration.h"
+#include "../core/include/subsystems/odometry/odometry_tank.h"
+#include "../core/include/robot_specs.h"
+#include "vex.h"
+
+/**
+ * OdometryRecorder
+ *
+ * Records a calibration run on the brain (see odometry_calibration.h). A background task reads the encoders and IMU
+ * into memory set aside up front, so recording never allocates, and mark() adds a known position at the latest sample.
+ * Once the run is over, fit it on the brain with get_log(), or save() it to the SD card for tools/odometry_calibration.
+ *
+ * Tank samples are stored in raw revolutions, before odom_gear_ratio, so the fitted gear ratio replaces the configured
+ * one instead of correcting it.
+ *
+ * Usage:
+ *   OdometryRecorder recorder(odom, robot_cfg);
+ *   recorder.start();
+ *   recorder.mark({0, 0, 90});  // against the wall at the start
+ *   ... drive, stopping at known positions ...
+ *   recorder.mark({24, 48, 90});
+ *   recorder.stop();
+ *   recorder.save("calibration.csv");
+ */
+class OdometryRecorder {
+public:
+  /**
+   * Record the sensors of a tank drive
+   *
+   * @param odom        the odometry to record the sensors of
+   * @param config      the configuration odom was built with, for its odom_gear_ratio
+   * @param max_samples the most samples to keep. The default is 2 minutes at 10ms
+   */
+  OdometryRecorder(OdometryTank &odom, robot_specs_t &config, int max_samples = 12000);
+
+  /**
+   * Record the sensors of a 3 tracking wheel robot
+   *
+   * @param odom        the odometry to record the encoders of
+   * @param imu         the robot's inertial sensor, or NULL to record without one
+   * @param max_samples the most samples to keep. The default is 2 minutes at 10ms
+   */
+  OdometryRecorder(Odometry3Wheel &odom, vex::inertial *imu = NULL, int max_samples = 12000);
+
+  /**
+   * Start recording in the background. Cannot be restarted once stopped
+   *
+   * @param period_ms how often to read the sensors, in milliseconds
+   */
+  void start(uint32_t period_ms = 10);
+
+  /**
+   * Stop recording. The background task finishes its current sample and ends
+   */
+  void stop();
+
+  /**
+   * @return true while the background task is recording
+   */
+  bool is_recording() const;
+
+  /**
+   * Note that the robot is at a known position now. Stop the robot first: the reference goes with the latest sample
+   *
+   * @param pos          where the robot is
+   * @param use_position false if only the rotation is known
+   * @param use_rotation false if only the position is known
+   */
+  void mark(const pose_t &pos, bool use_position = true, bool use_rotation = true);
+
+  /**
+   * @return the recording so far. Only read it once recording has stopped
+   */
+  calibration_log_t &get_log();
+
+  /**
+   * Write the recording to the SD card, in the format tools/odometry_calibration reads
+   *
+   * @param filename the file to create, replacing it if it exists
+   * @return false if there is no SD card
+   */
+  bool save(const char *filename);
+
+private:
+  static int background_task(void *ptr);
+  calibration_sample_t read_sample();
+
+  OdometryTank *tank;
+  robot_specs_t *tank_config;
+  Odometry3Wheel *three_wheel;
+  vex::inertial *imu;
+
+  int max_samples;
+  uint32_t period_ms = 10;
+  calibration_log_t log;
+  vex::mutex mut;
+
+  vex::task *handle = NULL;
+  bool recording = false;
+};
@@ -2,6 +2,8 @@
 
 #include "../core/include/subsystems/custom_encoder.h"
 #include "../core/include/subsystems/odometry/odometry_base.h"
+#include "../core/include/subsystems/sensor_bus.h"
+#include "../core/include/utils/derivative_estimator.h"
 #include "../core/include/utils/geometry.h"
 #include "../core/include/utils/moving_average.h"
 #include "../core/include/utils/vector2d.h"
@@ -18,6 +20,36 @@ static int background_task(void *odom_obj);
  */
 class OdometryTank : public OdometryBase {
 public:
+  /**
+   * One reading of every sensor odometry uses
+   */
+  typedef struct {
+    double lside_revs;       ///< left side position, in revolutions of the odometry wheel
+    double rside_revs;       ///< right side position, in revolutions of the odometry wheel
+    bool has_imu;            ///< false to calculate rotation from the encoders
+    double imu_rotation_deg; ///< inertial sensor rotation, clockwise positive
+  } tank_sample_t;
+
+  /**
+   * Everything odometry remembers between updates. Copy it to run another estimator from the same point
+   */
+  typedef struct {
+    pose_t pos = zero_pos;  ///< current position
+    double rotation_offset; ///< added to the measured angle, so set_position can change the rotation
+    bool initialized;       ///< false until the first sample, which only records where the encoders start
+
+    double lside_revs; ///< left side position at the previous sample
+    double rside_revs; ///< right side position at the previous sample
+
+    double speed;         ///< the speed at which we are travelling (inch/s)
+    double accel;         ///< the rate at which we are accelerating (inch/s^2)
+    double ang_speed_deg; ///< the speed at which we are turning (deg/s)
+    double ang_accel_deg; ///< the rate at which we are accelerating our turn (deg/s^2)
+
+    double time;                    ///< total of every dt so far (sec)
+    PoseDerivativeEstimator motion; ///< fits recent positions for the speeds and accelerations
+  } tank_state_t;
+
   /**
    * Initialize the Odometry module, calculating position from the drive motors.
    * @param left_side The left motors
@@ -65,18 +97,48 @@ public:
    */
   pose_t update() override;
 
+  /**
+   * With a sensor bus, sleep until the bus should have read the sensors again, so the background task doesn't spin on
+   * a snapshot it has already used. Without one, return straight away
+   */
+  void wait_for_update() override;
+
   /**
    * set_position tells the odometry to place itself at a position
    * @param newpos the position the odometry will take
    */
   void set_position(const pose_t &newpos = zero_pos) override;
 
+  /**
+   * Read every sensor odometry uses, from the sensor bus if there is one
+   * @return the current sensor values
+   */
+  tank_sample_t read_sensors();
+
+  /**
+   * Read the sensors through a sensor bus from now on, so that odometry updates once per bus period on the same values
+   * every other subsystem sees
+   * @param bus the sensor bus to add odometry's sensors to
+   */
+  void use_sensor_bus(SensorBus &bus);
+
+  /**
+   * Advance odometry by one sensor sample. Doesn't touch hardware or anything outside its arguments, so logged
+   * samples can be replayed through it on a computer, or several configurations run side by side.
+   *
+   * @param state the state after the previous sample, updated in place
+   * @param sample the sensor values
+   * @param dt time since the previous sample (sec)
+   * @param config the robot's measurements
+   */
+  static void integrate(tank_state_t &state, const tank_sample_t &sample, double dt, const robot_specs_t &config);
+
 private:
   /**
    * Get information from the input hardware and an existing position, and calculate a new current position
    */
-  static pose_t calculate_new_pos(robot_specs_t &config, pose_t &stored_info, double lside_diff, double rside_diff,
-                                  double angle_deg);
+  static pose_t calculate_new_pos(const robot_specs_t &config, const pose_t &curr_pos, double lside_diff_revs,
+                                  double rside_diff_revs, double angle_deg);
 
   vex::motor_group *left_side, *right_side;
   CustomEncoder *left_custom_enc, *right_custom_enc;
@@ -84,6 +146,14 @@ private:
   vex::inertial *imu;
   robot_specs_t &config;
 
-  double rotation_offset = 0;
-  ExponentialMovingAverage ema = ExponentialMovingAverage(3);
+  double read_side_revs(bool left);
+  double read_imu_deg();
+  tank_sample_t sample_from(const SensorBus::sensor_snapshot_t &snapshot);
+
+  tank_state_t state = {};
+  uint64_t last_sample_us = 0; // when the previous sample was read
+
+  SensorBus *sensors = NULL; // where to read the sensors from, NULL to read the devices directly
+  int lside_channel = -1, rside_channel = -1, imu_channel = -1;
+  uint32_t last_tick = 0; // the last snapshot odometry updated from
 };
\ No newline at end of file
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "../core/include/utils/geometry.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * ParticleFilter
+ *
+ * Monte Carlo localization against the field walls, without any hardware, so it can be run and timed on a computer.
+ * OdometryParticleFilter feeds it from the robot's odometry and distance sensors.
+ *
+ * The robot's position is represented by a cloud of guesses (particles). Every update:
+ * - predict() moves every particle by the distance the wheels measured, each with its own random error, so the cloud
+ *   spreads out the way odometry error does
+ * - weigh() casts each distance sensor's ray from every particle to the walls, and scores the particle by how well the
+ *   distance it expects matches what the sensor read
+ * - resample() drops unlikely particles and duplicates likely ones, once too few carry most of the weight
+ * - estimate() averages the cloud into one position
+ * - check_rotation() starts the cloud over if its rotation has wandered away from what the wheels measured
+ *
+ * The particles are stored as separate arrays of floats (x[], y[], ...) instead of an array of structs, and the ray
+ * cast is written without branches, so the loops over particles can be vectorized by the V5's NEON unit. All memory is
+ * allocated in the constructor.
+ */
+class ParticleFilter {
+public:
+  /**
+   * Where a distance sensor is mounted on the robot
+   */
+  typedef struct {
+    float x;       ///< distance to the right of the robot's center (inches)
+    float y;       ///< distance in front of the robot's center (inches)
+    float dir_rad; ///< direction it points, CCW positive from straight ahead (radians)
+  } ray_t;
+
+  /**
+   * Create the filter. All memory is allocated here
+   *
+   * @param num_particles how many guesses to keep. More is more robust and slower; see tools/benchmark
+   * @param field         the walls to measure against
+   */
+  ParticleFilter(int num_particles, Rect field);
+
+  /**
+   * Scatter the particles around a position, all equally likely
+   *
+   * @param center         where the robot probably is
+   * @param pos_stddev     how far off that could be (inches)
+   * @param rot_stddev_deg how far off the rotation could be (degrees)
+   */
+  void reset(const pose_t &center, double pos_stddev, double rot_stddev_deg);
+
+  /**
+   * Move every particle by a change in position measured in the robot's frame, plus its own random error
+   *
+   * @param fwd            distance driven forward (inches)
+   * @param side           distance driven to the right (inches)
+   * @param turn_rad       change in rotation, CCW positive (radians)
+   * @param fwd_stddev     standard deviation of the error in fwd (inches)
+   * @param side_stddev    standard deviation of the error in side (inches)
+   * @param rot_stddev_rad standard deviation of the error in turn_rad (radians)
+   */
+  void predict(double fwd, double side, double turn_rad, double fwd_stddev, double side_stddev, double rot_stddev_rad);
+
+  /**
+   * Score every particle against one distance sensor reading
+   *
+   * @param ray          where the sensor is mounted
+   * @param measured     the distance it read (inches)
+   * @param stddev       how noisy the sensor is (inches)
+   * @param outlier_prob the chance a reading is something other than a wall (a robot, a game element), from 0 to 1.
+   *                     Keeps one blocked reading from wiping out the right particles
+   */
+  void weigh(const ray_t &ray, float measured, float stddev, float outlier_prob);
+
+  /**
+   * Replace the particles with a new set drawn in proportion to their weights, if too few of them carry most of the
+   * weight
+   *
+   * @return true if the particles were resampled
+   */
+  bool resample();
+
+  /**
+   * Check the cloud's rotation against the wheels', once every window_in inches driven, and start the cloud over if
+   * the two have drifted apart further than the wheels could have.
+   *
+   * With few sensors the walls say little about rotation, so the cloud can settle on a wrong rotation whose rays
+   * still happen to match, and end up further off than the wheels alone. The wheels (and an IMU) measure turning
+   * much better than that, so over a short window the cloud's change in rotation should match theirs.
+   *
+   * @param window_in        distance to drive between checks (inches)
+   * @param max_rot_err_deg  how far the cloud's rotation may drift from the wheels' over one window (degrees)
+   * @param pos_stddev       how far to scatter the particles when starting over (inches)
+   * @param rot_stddev_deg   how far to scatter their rotations when starting over (degrees)
+   * @return true if the cloud had lost track and was started over
+   */
+  bool check_rotation(double window_in, double max_rot_err_deg, double pos_stddev, double rot_stddev_deg);
+
+  /**
+   * @return the weighted average of the particles
+   */
+  pose_t estimate() const;
+
+  /**
+   * @return the weighted standard deviation of the particles' positions, a rough measure of how far off the estimate
+   * might be (inches)
+   */
+  double get_position_stddev() const;
+
+  /**
+   * @return the number of particles
+   */
+  int size() const;
+
+  /**
+   * Distance from each particle along a sensor's ray to the nearest wall. Written without branches so it can be
+   * vectorized.
+   *
+   * @param x       particle x positions
+   * @param y       particle y positions
+   * @param cos_rot cos of each particle's rotation
+   * @param sin_rot sin of each particle's rotation
+   * @param n       number of particles
+   * @param ray     where the sensor is mounted
+   * @param field   the walls. The particles should be inside it
+   * @param out     filled with n distances (inches)
+   */
+  static void ray_cast(const float *x, const float *y, const float *cos_rot, const float *sin_rot, int n,
+                       const ray_t &ray, const Rect &field, float *out);
+
+private:
+  /**
+   * @return a random number from the standard normal distribution
+   */
+  float gaussian();
+
+  int num_particles;
+  Rect field;
+  uint32_t rng_state; // xorshift state
+
+  // The estimate at the start of the check_rotation window, moved by the wheel motion since
+  pose_t wheel_pose = {0, 0, 0};
+  double window_dist = 0; // distance driven since the window started (inches)
+
+  // The particles, one array per field
+  std::vector<float> x, y, rot, weight;
+  std::vector<float> cos_rot, sin_rot; // kept up to date with rot, for the ray cast
+  std::vector<float> expected;         // ray cast results
+
+  // Resampling builds the new set here, then swaps
+  std::vector<float> next_x, next_y, next_rot, next_cos, next_sin;
+};
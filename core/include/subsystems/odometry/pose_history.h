@@ -0,0 +1,89 @@
+#pragma once
+
+#include "../core/include/utils/geometry.h"
+#include "vex.h"
+#include <atomic>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * One recorded odometry state
+ */
+typedef struct {
+  uint64_t timestamp_us; ///< vex::timer::systemHighResolution() when the pose was measured
+  pose_t pos;            ///< position and rotation
+  double speed;          ///< the speed at which we were travelling (inch/s)
+  double ang_speed_deg;  ///< the speed at which we were turning (deg/s)
+} pose_history_entry_t;
+
+/**
+ * PoseHistory
+ *
+ * A fixed size ring buffer of past odometry poses, so that a measurement that arrives late (vision, GPS) can be
+ * compared against where the robot was when the measurement was taken instead of where it is now.
+ *
+ * All memory is allocated in the constructor. Entries closer together than min_interval_us are dropped, so the
+ * buffer covers capacity * min_interval_us of history no matter how fast the odometry task runs.
+ *
+ * Only one task at a time may call add() and clear() (OdometryBase calls both with its mutex held). get_at() and size()
+ * may be called from any task. Readers go through a sequence lock, the same as OdometryBase's snapshot, so a slow
+ * reader never makes add() wait.
+ */
+class PoseHistory {
+public:
+  /**
+   * Create a pose history
+   *
+   * @param capacity the most entries that will be kept
+   * @param min_interval_us the shortest time between two entries, in microseconds
+   */
+  PoseHistory(int capacity = 256, uint64_t min_interval_us = 5000);
+
+  /**
+   * Record a new entry, overwriting the oldest if full.
+   * Ignored if it is less than min_interval_us after the newest entry.
+   *
+   * @param entry the odometry state to record
+   */
+  void add(const pose_history_entry_t &entry);
+
+  /**
+   * Forget all recorded entries. Used when the position is set, since the old poses no longer line up with the new
+   * ones.
+   */
+  void clear();
+
+  /**
+   * Find the odometry state at a point in the past, linearly interpolating between the two entries around it.
+   * Times before the oldest entry or after the newest are clamped to that entry.
+   *
+   * @param timestamp_us the time to look up, from vex::timer::systemHighResolution()
+   * @param out the interpolated state, left unchanged if there is no history
+   * @return true if timestamp_us was inside the recorded history, false if clamped or there is no history
+   */
+  bool get_at(uint64_t timestamp_us, pose_history_entry_t &out);
+
+  /**
+   * @return the number of entries currently recorded
+   */
+  int size();
+
+private:
+  /**
+   * The i'th oldest entry. Outside of add() and clear(), only valid if seq hasn't changed since it was read
+   */
+  const pose_history_entry_t &entry(int i) const;
+
+  /**
+   * Copy out the entries around timestamp_us, without checking seq
+   *
+   * @return 0 if there is no history, 1 if clamped to before, 2 if timestamp_us is between before and after
+   */
+  int find(uint64_t timestamp_us, pose_history_entry_t &before, pose_history_entry_t &after) const;
+
+  std::vector<pose_history_entry_t> buffer; // all recorded entries, wrapping around
+  std::atomic<int> head;                    // index of the oldest entry
+  std::atomic<int> count;                   // number of valid entries
+  uint64_t min_interval_us;                 // entries closer together than this are dropped
+  std::atomic<uint32_t> seq;                // odd while add() or clear() is changing the buffer
+};
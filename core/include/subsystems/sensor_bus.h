@@ -0,0 +1,137 @@
+#pragma once
+
+#include "vex.h"
+#include <atomic>
+#include <functional>
+#include <stdint.h>
+
+/**
+ * SensorBus
+ *
+ * Reads every registered sensor once per control period, in one place, and publishes the values together as a
+ * timestamped snapshot. Subsystems read the snapshot instead of the devices, so every reader in the same period sees
+ * the same, coherent values, and a value read by 3 subsystems is only fetched from the device once.
+ *
+ * Each sensor value is a channel: a function that reads the device, registered with add_channel() (usually through a
+ * subsystem's use_sensor_bus()). Register channels from one task, normally during robot_init().
+ *
+ * There is one writer (the background task) and any number of readers. Snapshots alternate between two buffers, and
+ * the sequence counter tells readers which one is the latest. A reader copying the latest buffer only has to retry if
+ * the writer gets all the way around to overwriting it, so reading is lock free and the writer never waits.
+ *
+ * Every device read, whether by the bus or straight from a reader in direct mode, is counted. Construct the bus with
+ * use_snapshots = false to send every get() to the device instead, and compare get_reads_per_sec() between the two.
+ */
+class SensorBus {
+public:
+  static const int MAX_CHANNELS = 24; ///< the most sensor values the bus can hold
+
+  /**
+   * Every channel's value at one instant
+   */
+  typedef struct {
+    uint64_t timestamp_us;       ///< vex::timer::systemHighResolution() when the devices were read
+    uint32_t tick;               ///< how many snapshots came before this one
+    int num_channels;            ///< how many of values were read
+    double values[MAX_CHANNELS]; ///< one value per channel, in the order they were added
+  } sensor_snapshot_t;
+
+  /**
+   * Create the sensor bus and start reading in the background
+   *
+   * @param period_ms how often to read every sensor, in milliseconds
+   * @param use_snapshots false to skip the snapshots and read the device on every get(), for comparison
+   */
+  SensorBus(uint32_t period_ms = 10, bool use_snapshots = true);
+
+  /**
+   * Add a sensor value to every snapshot from now on
+   *
+   * @param read reads the device and returns its value
+   * @return the channel number to get() the value with, or -1 if the bus is full
+   */
+  int add_channel(std::function<double()> read);
+
+  /**
+   * Gets every channel from the same read, without blocking the bus task
+   * @return the latest snapshot
+   */
+  sensor_snapshot_t get_snapshot();
+
+  /**
+   * Gets one channel's latest value. Reads the device instead if the channel hasn't been read by the bus yet, or the
+   * bus isn't using snapshots
+   *
+   * @param channel the number returned by add_channel()
+   * @return the latest value of the channel
+   */
+  double get(int channel);
+
+  /**
+   * Read every channel now and publish the snapshot. Runs every period in the background
+   */
+  void sample();
+
+  /**
+   * How many device reads were made in the last whole second, by the bus and by get() in direct mode
+   * @return device reads per second
+   */
+  uint32_t get_reads_per_sec() const;
+
+  /**
+   * @return how often every sensor is read, in milliseconds
+   */
+  uint32_t get_period_ms() const;
+
+  /**
+   * Stop reading sensors in the background. Cannot be restarted.
+   */
+  void end_async();
+
+private:
+  static int background_task(void *ptr);
+
+  uint32_t period_ms;
+  bool use_snapshots;
+
+  std::function<double()> readers[MAX_CHANNELS];
+  std::atomic<int> num_channels; ///< readers below this are ready to call
+
+  std::atomic<uint32_t> seq;    ///< 2 * snapshots published, plus 1 while the next one is being written
+  sensor_snapshot_t buffers[2]; ///< snapshot n is in buffers[n % 2]
+
+  std::atomic<uint32_t> reads;         ///< device reads ever made
+  std::atomic<uint32_t> reads_per_sec; ///< device reads made in the last whole second
+
+  vex::task *handle;
+  bool end_task = false;
+};
+
+/**
+ * One sensor value, read through a SensorBus once the subsystem is given one, or straight from the device until then
+ */
+class SensorChannel {
+public:
+  /**
+   * Create the channel
+   * @param read reads the device and returns its value
+   */
+  SensorChannel(std::function<double()> read);
+
+  /**
+   * Read the value through a sensor bus from now on
+   * @param bus the bus to add the channel to
+   */
+  void use_sensor_bus(SensorBus &bus);
+
+  /**
+   * Gets the latest value
+   * @return the value from the latest snapshot, or the device if there is no bus
+   */
+  double get() const;
+
+private:
+  std::function<double()> read;
+  SensorBus *bus = NULL;
+  int channel = -1;
+};
@@ -6,8 +6,10 @@
 
 #include "../core/include/robot_specs.h"
 #include "../core/include/subsystems/odometry/odometry_tank.h"
+#include "../core/include/subsystems/sensor_bus.h"
 #include "../core/include/utils/command_structure/auto_command.h"
 #include "../core/include/utils/controls/feedback_base.h"
+#include "../core/include/utils/controls/feedforward.h"
 #include "../core/include/utils/controls/pid.h"
 #include "../core/include/utils/pure_pursuit.h"
 #include "vex.h"
@@ -27,6 +29,16 @@ public:
     ZeroVelocity, ///< try to bring the robot to rest. But don't try to hold position
     Smart,        ///< bring the robot to rest and once it's stopped, try to hold that position
   };
+
+  /**
+   * Gains for the Ramsete trajectory follower. See ramsete() for the control law.
+   */
+  typedef struct {
+    double b;    ///< how hard to correct position error, like a P gain. Units are rad^2/in^2: the usual 2 rad^2/m^2
+                 ///< is about 0.0013, but 0.02 holds the path much better against an unevenly matched drive
+    double zeta; ///< damping, between 0 and 1. 0.7 is a good start
+  } ramsete_cfg_t;
+
   /**
    * Create the TankDrive object
    * @param left_motors left side drive motors
@@ -56,9 +68,21 @@ public:
   AutoCommand *TurnDegreesCmd(double degrees, double max_speed = 1.0, double start_speed = 0.0);
   AutoCommand *TurnDegreesCmd(Feedback &fb, double degrees, double max_speed = 1.0, double end_speed = 0.0);
 
-  AutoCommand *PurePursuitCmd(PurePursuit::Path path, directionType dir, double max_speed = 1, double end_speed = 0);
-  AutoCommand *PurePursuitCmd(Feedback &feedback, PurePursuit::Path path, directionType dir, double max_speed = 1,
+  AutoCommand *PurePursuitCmd(const PurePursuit::Path &path, directionType dir, double max_speed = 1,
                               double end_speed = 0);
+  AutoCommand *PurePursuitCmd(Feedback &feedback, const PurePursuit::Path &path, directionType dir,
+                              double max_speed = 1, double end_speed = 0);
+  AutoCommand *PurePursuitCmd(const PurePursuit::Path &path, PurePursuit::adaptive_lookahead_cfg_t lookahead_cfg,
+                              directionType dir, double max_speed = 1, double end_speed = 0);
+  AutoCommand *PurePursuitCmd(Feedback &feedback, const PurePursuit::Path &path,
+                              PurePursuit::adaptive_lookahead_cfg_t lookahead_cfg, directionType dir,
+                              double max_speed = 1, double end_speed = 0);
+  AutoCommand *PurePursuitCmd(const PurePursuit::Path &path,
+                              PurePursuit::VelocityProfile::velocity_profile_cfg_t profile_cfg, FeedForward &ff,
+                              PID &progress_pid, directionType dir, double end_vel = 0);
+  AutoCommand *RamseteCmd(const PurePursuit::Path &path,
+                          PurePursuit::VelocityProfile::velocity_profile_cfg_t profile_cfg, FeedForward &ff,
+                          ramsete_cfg_t ramsete_cfg, directionType dir, double end_vel = 0);
   Condition *DriveStalledCondition(double stall_time);
   AutoCommand *DriveTankCmd(double left, double right);
 
@@ -78,6 +102,12 @@ public:
    * @param bt  breaktype. What to do if the driver lets go of the sticks
    */
   void drive_tank(double left, double right, int power = 1, BrakeType bt = BrakeType::None);
+
+  /**
+   * Read the drive motors' velocities through a sensor bus from now on, instead of from the motors
+   * @param bus the sensor bus to add the velocities to
+   */
+  void use_sensor_bus(SensorBus &bus);
   /**
    * Drive the robot raw-ly
    * @param left the percent to run the left motors (-1, 1)
@@ -166,7 +196,9 @@ public:
    * @param feedback   the feedback controller we will use to travel. controls the rate at which we accelerate and
    * drive.
    * @param max_speed  the maximum percentage of robot speed at which the robot will travel. 1 = full power
-   * @param end_speed  the movement profile will attempt to reach this velocity by its completion
+   * @param end_speed  the movement profile will attempt to reach this velocity by its completion, as a percentage of
+   * robot speed like max_speed. If it isn't 0 the robot doesn't stop at the point, and the next drive starts from
+   * this speed
    */
   bool drive_to_point(double x, double y, vex::directionType dir, Feedback &feedback, double max_speed = 1,
                       double end_speed = 0);
@@ -241,7 +273,7 @@ public:
    * by its completion
    * @return True when the path is complete
    */
-  bool pure_pursuit(PurePursuit::Path path, directionType dir, Feedback &feedback, double max_speed = 1,
+  bool pure_pursuit(const PurePursuit::Path &path, directionType dir, Feedback &feedback, double max_speed = 1,
                     double end_speed = 0);
 
   /**
@@ -259,12 +291,92 @@ public:
    * by its completion
    * @return True when the path is complete
    */
-  bool pure_pursuit(PurePursuit::Path path, directionType dir, double max_speed = 1, double end_speed = 0);
+  bool pure_pursuit(const PurePursuit::Path &path, directionType dir, double max_speed = 1, double end_speed = 0);
+
+  /**
+   * Drive the robot autonomously using a pure-pursuit algorithm, keeping the lookahead search state in a
+   * caller-owned tracker so the search only looks a few segments ahead each tick instead of the whole path.
+   * The tracker is reset when a new movement starts.
+   *
+   * @param path The list of coordinates to follow, in order
+   * @param tracker Lookahead search state for this path
+   * @param dir Run the bot forwards or backwards
+   * @param feedback The feedback controller determining speed
+   * @param max_speed Limit the speed of the robot (for pid / pidff feedbacks)
+   * @param end_speed the movement profile will attempt to reach this velocity
+   * by its completion
+   * @return True when the path is complete
+   */
+  bool pure_pursuit(const PurePursuit::Path &path, PurePursuit::LookaheadTracker &tracker, directionType dir,
+                    Feedback &feedback, double max_speed = 1, double end_speed = 0);
+
+  /**
+   * Drive the robot autonomously using a pure-pursuit algorithm, choosing the lookahead radius every update from
+   * the robot's speed and the curvature of the path ahead instead of using the path's fixed radius.
+   * The tracker is reset when a new movement starts.
+   *
+   * @param path The list of coordinates to follow, in order
+   * @param tracker Lookahead search state for this path
+   * @param lookahead_cfg Limits and gains for the lookahead radius
+   * @param dir Run the bot forwards or backwards
+   * @param feedback The feedback controller determining speed
+   * @param max_speed Limit the speed of the robot (for pid / pidff feedbacks)
+   * @param end_speed the movement profile will attempt to reach this velocity
+   * by its completion
+   * @return True when the path is complete
+   */
+  bool pure_pursuit(const PurePursuit::Path &path, PurePursuit::LookaheadTracker &tracker,
+                    const PurePursuit::adaptive_lookahead_cfg_t &lookahead_cfg, directionType dir, Feedback &feedback,
+                    double max_speed = 1, double end_speed = 0);
+
+  /**
+   * Drive the robot along a path at the velocities planned by a velocity profile.
+   *
+   * The robot steers toward the pure pursuit lookahead point by splitting the profile's velocity and acceleration
+   * into left and right wheel targets for the curvature of the arc to that point, and turns each into a motor output
+   * with the feedforward. A PID on distance along the path corrects for falling behind or getting ahead of the
+   * profile, the same way MotionController does for straight movements.
+   *
+   * @param path The list of coordinates to follow, in order
+   * @param profile Velocities to drive the path at. Must have been generated from this path
+   * @param tracker Lookahead search state for this path
+   * @param dir Run the bot forwards or backwards
+   * @param ff Feedforward turning wheel velocity (inch/s) and acceleration (inch/s^2) into motor outputs
+   * @param progress_pid PID on distance along the path (inches)
+   * @return True when the profile has finished and the PID reports on target
+   */
+  bool pure_pursuit(const PurePursuit::Path &path, const PurePursuit::VelocityProfile &profile,
+                    PurePursuit::LookaheadTracker &tracker, directionType dir, FeedForward &ff, PID &progress_pid);
+
+  /**
+   * Follow a timed trajectory (a path and a velocity profile along it) with the Ramsete controller.
+   *
+   * Each update, the profile gives where the robot should be on the path right now, and how fast it should be
+   * moving and turning there. The position and heading error to that target, in the robot's frame, are fed back
+   * into the forward and turning velocities:
+   *   k = 2 * zeta * sqrt(w_d^2 + b * v_d^2)
+   *   v = v_d * cos(e_theta) + k * e_x
+   *   w = w_d + k * e_theta + b * v_d * sin(e_theta) / e_theta * e_y
+   * which are split into wheel velocities and turned into motor outputs with the feedforward.
+   * Unlike pure pursuit, this corrects cross-track and heading error at any speed without retuning.
+   *
+   * @param path The list of coordinates to follow, in order
+   * @param profile Velocities to drive the path at. Must have been generated from this path
+   * @param dir Run the bot forwards or backwards
+   * @param ff Feedforward turning wheel velocity (inch/s) and acceleration (inch/s^2) into motor outputs
+   * @param cfg Ramsete gains
+   * @return True when the profile has finished
+   */
+  bool ramsete(const PurePursuit::Path &path, const PurePursuit::VelocityProfile &profile, directionType dir,
+               FeedForward &ff, ramsete_cfg_t cfg);
 
 private:
   motor_group &left_motors;  ///< left drive motors
   motor_group &right_motors; ///< right drive motors
 
+  SensorChannel left_vel;  ///< left drive velocity (pct), for braking
+  SensorChannel right_vel; ///< right drive velocity (pct), for braking
+
   PID correction_pid;                      ///< PID controller used to drive in as straight a line
                                            ///< as possible
   Feedback *drive_default_feedback = NULL; ///< feedback to use to drive if none is specified
@@ -279,4 +391,9 @@ private:
   bool func_initialized = false; ///< used to control initialization of autonomous driving. (you only wan't to set the
                                  ///< target once, not every iteration that you're driving)
   bool is_pure_pursuit = false;  ///< true if we are driving with a pure pursuit system
+  double carried_vel = 0;        ///< forward velocity (inch/s) the robot was going when the last drive ended without
+                                 ///< stopping, for the next drive to start from
+
+  PurePursuit::LookaheadTracker lookahead_tracker; ///< lookahead search state for pure_pursuit() calls without a tracker
+  vex::timer profile_tmr; ///< time since starting to follow a velocity profile
 };
@@ -0,0 +1,190 @@
+#pragma once
+
+#include "../core/include/utils/pure_pursuit.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * Compile-time versions of the pure pursuit path generation functions.
+ *
+ * Everything here is a C++11 constexpr function, so a routine can declare its waypoints as a
+ * constexpr array and have the interpolated / injected points computed by the compiler and stored
+ * in flash, instead of building them on the heap at the start of autonomous:
+ *
+ *   static constexpr PurePursuit::hermite_point waypoints[] = {{0, 0, 0, 40}, {24, 24, 1.57, 40}};
+ *   static constexpr auto smoothed = PurePursuit::bake_hermite<20>(waypoints);
+ *   static constexpr auto injected =
+ *       PurePursuit::bake_inject<PurePursuit::inject_count(smoothed.points, 1)>(smoothed.points, 1);
+ *   ...
+ *   drive_sys.PurePursuitCmd(PurePursuit::Path(injected.to_vector(), 8), FWD);
+ *
+ * The output matches smooth_path_hermite() and inject_path() to within floating point rounding.
+ */
+namespace PurePursuit {
+
+/**
+ * A fixed size table of path points, built at compile time by bake_hermite() or bake_inject().
+ */
+template <size_t N> struct baked_path_t {
+  point_t points[N];
+
+  constexpr size_t size() const { return N; }
+  constexpr point_t operator[](size_t i) const { return points[i]; }
+
+  const point_t *begin() const { return points; }
+  const point_t *end() const { return points + N; }
+
+  /**
+   * Copy the baked points into a vector, for constructing a PurePursuit::Path
+   */
+  std::vector<point_t> to_vector() const { return std::vector<point_t>(begin(), end()); }
+};
+
+namespace baking {
+
+// Compile-time math. <cmath> is not constexpr on the V5 toolchain, so these stand in for it.
+
+constexpr double pi = 3.14159265358979323846;
+
+constexpr double trunc(double x) { return (double)(long long)x; }
+constexpr double floor(double x) { return trunc(x) > x ? trunc(x) - 1 : trunc(x); }
+constexpr double ceil(double x) { return trunc(x) < x ? trunc(x) + 1 : trunc(x); }
+
+constexpr double sqrt_iter(double x, double cur, double prev, int iters) {
+  return (cur == prev || iters == 0) ? cur : sqrt_iter(x, 0.5 * (cur + x / cur), cur, iters - 1);
+}
+constexpr double sqrt(double x) { return x <= 0 ? 0 : sqrt_iter(x, x > 1 ? x : 1, 0, 100); }
+
+// Wrap an angle into [-pi, pi) so the taylor series converges quickly
+constexpr double wrap_angle(double x) { return x - 2 * pi * floor((x + pi) / (2 * pi)); }
+
+constexpr double sin_series(double x2, double term, double sum, int k) {
+  return (sum + term == sum || k > 40)
+             ? sum + term
+             : sin_series(x2, -term * x2 / ((2 * k + 2) * (2 * k + 3)), sum + term, k + 1);
+}
+constexpr double cos_series(double x2, double term, double sum, int k) {
+  return (sum + term == sum || k > 40)
+             ? sum + term
+             : cos_series(x2, -term * x2 / ((2 * k + 1) * (2 * k + 2)), sum + term, k + 1);
+}
+constexpr double sin_wrapped(double x) { return sin_series(x * x, x, 0, 0); }
+constexpr double cos_wrapped(double x) { return cos_series(x * x, 1, 0, 0); }
+constexpr double sin(double x) { return sin_wrapped(wrap_angle(x)); }
+constexpr double cos(double x) { return cos_wrapped(wrap_angle(x)); }
+
+constexpr double dist(point_t a, point_t b) { return sqrt((b.x - a.x) * (b.x - a.x) + (b.y - a.y) * (b.y - a.y)); }
+
+// Index lists for expanding a table one element at a time (std::index_sequence is C++14).
+// Built by halving so long paths don't hit the template recursion limit.
+
+template <size_t... I> struct index_list {};
+
+template <class A, class B> struct concat_index_lists;
+template <size_t... I, size_t... J> struct concat_index_lists<index_list<I...>, index_list<J...>> {
+  typedef index_list<I..., (sizeof...(I) + J)...> type;
+};
+
+template <size_t N> struct make_index_list {
+  typedef typename concat_index_lists<typename make_index_list<N / 2>::type,
+                                      typename make_index_list<N - N / 2>::type>::type type;
+};
+template <> struct make_index_list<0> { typedef index_list<> type; };
+template <> struct make_index_list<1> { typedef index_list<0> type; };
+
+// Intentionally not constexpr (and never defined): reaching this while baking a path makes the
+// compiler reject the table instead of silently producing a wrong one.
+template <size_t N> baked_path_t<N> table_size_mismatch();
+
+// Hermite interpolation along one axis, with the same blending functions as smooth_path_hermite()
+constexpr double hermite_axis(double p1, double p2, double t1, double t2, double s) {
+  return (2 * s * s * s - 3 * s * s + 1) * p1 + (-2 * s * s * s + 3 * s * s) * p2 + (s * s * s - 2 * s * s + s) * t1 +
+         (s * s * s - s * s) * t2;
+}
+
+constexpr point_t hermite_blend(hermite_point a, hermite_point b, double s) {
+  return point_t{hermite_axis(a.x, b.x, a.mag * cos(a.dir), b.mag * cos(b.dir), s),
+                 hermite_axis(a.y, b.y, a.mag * sin(a.dir), b.mag * sin(b.dir), s)};
+}
+
+template <size_t Steps, size_t W> constexpr point_t hermite_sample(const hermite_point (&path)[W], size_t k) {
+  return k == (W - 1) * Steps ? point_t{path[W - 1].x, path[W - 1].y}
+                              : hermite_blend(path[k / Steps], path[k / Steps + 1], (double)(k % Steps) / Steps);
+}
+
+template <size_t Steps, size_t W, size_t... I>
+constexpr baked_path_t<(W - 1) * Steps + 1> bake_hermite(const hermite_point (&path)[W], index_list<I...>) {
+  return baked_path_t<(W - 1) * Steps + 1>{{hermite_sample<Steps>(path, I)...}};
+}
+
+// Number of points inject_path() places on a single segment
+constexpr size_t segment_inject_count(point_t start, point_t end, double spacing) {
+  return (size_t)ceil(dist(start, end) / spacing);
+}
+
+template <size_t W> constexpr size_t inject_count_from(const point_t (&path)[W], double spacing, size_t seg) {
+  return seg + 1 >= W ? 1
+                      : segment_inject_count(path[seg], path[seg + 1], spacing) + inject_count_from(path, spacing, seg + 1);
+}
+
+constexpr point_t inject_point(point_t start, point_t end, double spacing, size_t j) {
+  return point_t{start.x + (end.x - start.x) / dist(start, end) * spacing * j,
+                 start.y + (end.y - start.y) / dist(start, end) * spacing * j};
+}
+
+// Walk the segments, consuming each one's injected points until the k'th point is found
+template <size_t W>
+constexpr point_t inject_sample(const point_t (&path)[W], double spacing, size_t seg, size_t k) {
+  return seg + 1 >= W ? path[W - 1]
+         : k < segment_inject_count(path[seg], path[seg + 1], spacing)
+             ? inject_point(path[seg], path[seg + 1], spacing, k)
+             : inject_sample(path, spacing, seg + 1, k - segment_inject_count(path[seg], path[seg + 1], spacing));
+}
+
+template <size_t N, size_t W, size_t... I>
+constexpr baked_path_t<N> bake_inject(const point_t (&path)[W], double spacing, index_list<I...>) {
+  return inject_count_from(path, spacing, 0) == N ? baked_path_t<N>{{inject_sample(path, spacing, 0, I)...}}
+                                                  : table_size_mismatch<N>();
+}
+
+} // namespace baking
+
+/**
+ * Compile-time version of smooth_path_hermite().
+ * The number of output points is (waypoints - 1) * Steps + 1.
+ *
+ * @tparam Steps The number of points interpolated between each pair of waypoints.
+ * @param path The path of hermite points to interpolate.
+ * @return The smoothed path, as a fixed size table.
+ */
+template <size_t Steps, size_t W>
+constexpr baked_path_t<(W - 1) * Steps + 1> bake_hermite(const hermite_point (&path)[W]) {
+  static_assert(W >= 2 && Steps >= 1, "bake_hermite needs at least 2 waypoints and 1 step");
+  return baking::bake_hermite<Steps>(path, typename baking::make_index_list<(W - 1) * Steps + 1>::type());
+}
+
+/**
+ * The number of points inject_path() / bake_inject() will produce for a path.
+ * Used as the size parameter for bake_inject().
+ *
+ * @param path The path to inject points into.
+ * @param spacing The spacing between injected points.
+ */
+template <size_t W> constexpr size_t inject_count(const point_t (&path)[W], double spacing) {
+  return baking::inject_count_from(path, spacing, 0);
+}
+
+/**
+ * Compile-time version of inject_path().
+ * N must equal inject_count(path, spacing); anything else fails to compile.
+ *
+ * @tparam N The number of output points.
+ * @param path The path to inject points into.
+ * @param spacing The spacing between injected points.
+ * @return The injected path, as a fixed size table.
+ */
+template <size_t N, size_t W> constexpr baked_path_t<N> bake_inject(const point_t (&path)[W], double spacing) {
+  return baking::bake_inject<N>(path, spacing, typename baking::make_index_list<N>::type());
+}
+
+} // namespace PurePursuit
@@ -10,6 +10,11 @@
  *      - turn_to_heading
  *      - stop
  *
+ *    And AutoCommand subclasses that wrap MecanumDrive functions
+ *
+ *    Currently includes:
+ *      - auto_drive_to_pose
+ *
  *    Also holds AutoCommand subclasses that wrap OdometryBase functions
  *
  *    Currently includes:
@@ -18,6 +23,7 @@
 
 #pragma once
 
+#include "../core/include/subsystems/mecanum_drive.h"
 #include "../core/include/subsystems/tank_drive.h"
 #include "../core/include/utils/command_structure/auto_command.h"
 #include "../core/include/utils/geometry.h"
@@ -180,9 +186,23 @@ public:
    * @param feedback The feedback controller determining speed
    * @param max_speed Limit the speed of the robot (for pid / pidff feedbacks)
    */
-  PurePursuitCommand(TankDrive &drive_sys, Feedback &feedback, PurePursuit::Path path, directionType dir,
+  PurePursuitCommand(TankDrive &drive_sys, Feedback &feedback, const PurePursuit::Path &path, directionType dir,
                      double max_speed = 1, double end_speed = 0);
 
+  /**
+   * Construct a Pure Pursuit AutoCommand that picks its lookahead radius every update from the robot's speed and
+   * the curvature of the path ahead, instead of using the path's fixed radius
+   *
+   * @param path The list of coordinates to follow, in order
+   * @param lookahead_cfg Limits and gains for the lookahead radius
+   * @param dir Run the bot forwards or backwards
+   * @param feedback The feedback controller determining speed
+   * @param max_speed Limit the speed of the robot (for pid / pidff feedbacks)
+   */
+  PurePursuitCommand(TankDrive &drive_sys, Feedback &feedback, const PurePursuit::Path &path,
+                     PurePursuit::adaptive_lookahead_cfg_t lookahead_cfg, directionType dir, double max_speed = 1,
+                     double end_speed = 0);
+
   /**
    * Direct call to TankDrive::pure_pursuit
    */
@@ -196,12 +216,91 @@ public:
 private:
   TankDrive &drive_sys;
   PurePursuit::Path path;
+  PurePursuit::LookaheadTracker tracker;
+  PurePursuit::adaptive_lookahead_cfg_t lookahead_cfg;
   directionType dir;
   Feedback &feedback;
   double max_speed;
   double end_speed;
 };
 
+/**
+ * AutoCommand wrapper class for following a pure pursuit path with a velocity profile in the TankDrive class
+ */
+class ProfiledPurePursuitCommand : public AutoCommand {
+public:
+  /**
+   * Construct a profiled Pure Pursuit AutoCommand. The velocity profile is generated here, not when the command runs.
+   *
+   * @param path The list of coordinates to follow, in order
+   * @param profile_cfg Velocity and acceleration limits for the profile
+   * @param ff Feedforward turning wheel velocity and acceleration into motor outputs
+   * @param progress_pid PID on distance along the path
+   * @param dir Run the bot forwards or backwards
+   * @param end_vel Velocity to be travelling at when the path ends (inch/s)
+   */
+  ProfiledPurePursuitCommand(TankDrive &drive_sys, const PurePursuit::Path &path,
+                             PurePursuit::VelocityProfile::velocity_profile_cfg_t profile_cfg, FeedForward &ff,
+                             PID &progress_pid, directionType dir, double end_vel = 0);
+
+  /**
+   * Direct call to TankDrive::pure_pursuit
+   */
+  bool run() override;
+
+  /**
+   * Reset the drive system when it times out
+   */
+  void on_timeout() override;
+
+private:
+  TankDrive &drive_sys;
+  PurePursuit::Path path;
+  PurePursuit::VelocityProfile profile;
+  PurePursuit::LookaheadTracker tracker;
+  FeedForward &ff;
+  PID &progress_pid;
+  directionType dir;
+};
+
+/**
+ * AutoCommand wrapper class for following a timed trajectory with the Ramsete controller in the TankDrive class
+ */
+class RamseteCommand : public AutoCommand {
+public:
+  /**
+   * Construct a Ramsete AutoCommand. The velocity profile is generated here, not when the command runs.
+   *
+   * @param path The list of coordinates to follow, in order
+   * @param profile_cfg Velocity and acceleration limits for the profile
+   * @param ff Feedforward turning wheel velocity and acceleration into motor outputs
+   * @param ramsete_cfg Ramsete gains
+   * @param dir Run the bot forwards or backwards
+   * @param end_vel Velocity to be travelling at when the path ends (inch/s)
+   */
+  RamseteCommand(TankDrive &drive_sys, const PurePursuit::Path &path,
+                 PurePursuit::VelocityProfile::velocity_profile_cfg_t profile_cfg, FeedForward &ff,
+                 TankDrive::ramsete_cfg_t ramsete_cfg, directionType dir, double end_vel = 0);
+
+  /**
+   * Direct call to TankDrive::ramsete
+   */
+  bool run() override;
+
+  /**
+   * Reset the drive system when it times out
+   */
+  void on_timeout() override;
+
+private:
+  TankDrive &drive_sys;
+  PurePursuit::Path path;
+  PurePursuit::VelocityProfile profile;
+  FeedForward &ff;
+  TankDrive::ramsete_cfg_t ramsete_cfg;
+  directionType dir;
+};
+
 /**
  * AutoCommand wrapper class for the stop() function in the
  * TankDrive class
@@ -223,6 +322,37 @@ private:
   TankDrive &drive_sys;
 };
 
+// ==== MECANUM ====
+
+/**
+ * AutoCommand wrapper class for the auto_drive_to_pose function in the MecanumDrive class
+ */
+class MecanumDriveToPoseCommand : public AutoCommand {
+public:
+  /**
+   * Construct a MecanumDriveToPose Command
+   * @param drive_sys the drive system we are commanding. Must have been given odometry
+   * @param target where to end up on the field
+   * @param max_speed the maximum speed to drive and turn at, 0 -> 1
+   */
+  MecanumDriveToPoseCommand(MecanumDrive &drive_sys, pose_t target, double max_speed = 1);
+
+  /**
+   * Direct call to MecanumDrive::auto_drive_to_pose
+   */
+  bool run() override;
+
+  /**
+   * Reset the drive system when it times out
+   */
+  void on_timeout() override;
+
+private:
+  MecanumDrive &drive_sys;
+  pose_t target;
+  double max_speed;
+};
+
 // ==== ODOMETRY ====
 
 /**
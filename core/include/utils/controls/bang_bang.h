@@ -12,7 +12,7 @@ public:
    * @param start_vel Movement starting velocity
    * @param end_vel Movement ending velocity
    */
-  void init(double start_pt, double set_pt) override;
+  void init(double start_pt, double set_pt, double start_vel = 0, double end_vel = 0) override;
 
   /**
    * Iterate the feedback loop once with an updated sensor value
@@ -17,7 +17,15 @@ public:
    * @param start_vel Movement starting velocity
    * @param end_vel Movement ending velocity
    */
-  virtual void init(double start_pt, double set_pt) = 0;
+  virtual void init(double start_pt, double set_pt, double start_vel = 0, double end_vel = 0) = 0;
+
+  /**
+   * Do any planning for a movement of this length ahead of time, so that init() has less to do when it starts.
+   * Optional; controllers that don't plan ignore it
+   *
+   * @param distance how far the movement will go
+   */
+  virtual void precompute(double /*distance*/) {}
 
   /**
    * Iterate the feedback loop once with an updated sensor value
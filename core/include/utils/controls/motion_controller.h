@@ -4,6 +4,8 @@
 #include "../core/include/utils/controls/feedback_base.h"
 #include "../core/include/utils/controls/feedforward.h"
 #include "../core/include/utils/controls/pid.h"
+#include "../core/include/utils/controls/profile_table.h"
+#include "../core/include/utils/controls/scurve_profile.h"
 #include "../core/include/utils/controls/trapezoid_profile.h"
 #include "vex.h"
 
@@ -20,6 +22,16 @@
  *
  * For PID and Feedforward specific formulae, see pid.h, feedforward.h, and trapezoid_profile.h
  *
+ * If the config sets a jerk limit, an SCurveProfile (see scurve_profile.h) is used instead of the trapezoid profile.
+ *
+ * The profile isn't solved every update. Each movement's profile is sampled into a ProfileTable once, either by
+ * precompute() when a command is created or by init() when it starts, and updates look the setpoint up in the table.
+ * The last few tables are kept, so repeating a movement of the same length reuses its table.
+ *
+ * Movements that start or end moving (a start_vel or end_vel passed to init()) are for chaining commands together, and
+ * depend on how fast the robot is already going, so they're never repeated exactly. Those follow an SCurveProfile
+ * solved when the movement starts instead of a table. It keeps the config's jerk limit, and is a trapezoid without one.
+ *
  * @author Ryan McGee
  * @date 7/13/2022
  */
@@ -27,13 +39,14 @@ class MotionController : public Feedback {
 public:
   /**
    * m_profile_config holds all data the motion controller uses to plan paths
-   * When motion pofile is given a target to drive to, max_v and accel are used to make the trapezoid profile
+   * When motion pofile is given a target to drive to, max_v, accel and jerk are used to make the motion profile
    * instructing the controller how to drive pid_cfg, ff_cfg are used to find the motor outputs necessary to execute
    * this path
    */
   typedef struct {
     double max_v;                    ///< the maximum velocity the robot can drive
     double accel;                    ///< the most acceleration the robot can do
+    double jerk;                     ///< the most jerk the robot can do, or 0 to use a trapezoid profile
     PID::pid_config_t pid_cfg;       ///< configuration parameters for the internal PID controller
     FeedForward::ff_config_t ff_cfg; ///< configuration parameters for the internal
   } m_profile_cfg_t;
@@ -44,6 +57,7 @@ public:
    * @param config The definition of how the robot is able to move
    *    max_v Maximum velocity the movement is capable of
    *    accel Acceleration / deceleration of the movement
+   *    jerk Rate of change of acceleration, or 0 for a trapezoid profile
    *    pid_cfg Definitions of kP, kI, and kD
    *    ff_cfg Definitions of kS, kV, and kA
    */
@@ -52,8 +66,21 @@ public:
   /**
    * @brief Initialize the motion profile for a new movement
    * This will also reset the PID and profile timers.
+   *
+   * @param start_pt Movement starting position
+   * @param end_pt Movement ending posiiton
+   * @param start_vel Movement starting velocity (units/sec)
+   * @param end_vel Movement ending velocity (units/sec). If it isn't 0, the movement is on target as soon as it
+   * reaches end_pt, without waiting to settle
+   */
+  void init(double start_pt, double end_pt, double start_vel = 0, double end_vel = 0) override;
+
+  /**
+   * Sample the profile for a movement of this length now, so init() can use it without building it
+   *
+   * @param distance how far the movement will go
    */
-  void init(double start_pt, double end_pt) override;
+  void precompute(double distance) override;
 
   /**
    * @brief Update the motion profile with a new sensor value
@@ -116,7 +143,21 @@ private:
 
   PID pid;
   FeedForward ff;
-  TrapezoidProfile profile;
+  TrapezoidProfile trapezoid;
+  SCurveProfile scurve;
+  MotionProfile *profile; ///< the profile tables are built from, one of the above
+  SCurveProfile moving;    ///< the profile for movements that start or end moving
+  bool use_moving = false; ///< whether the active movement follows moving instead of a table
+
+  static const int NUM_TABLES = 16;         ///< how many profile tables to keep
+  ProfileTable tables[NUM_TABLES];          ///< the most recently built profiles
+  int next_table = 0;                       ///< the table to replace next
+  ProfileTable stationary;                  ///< never built, for movements that go nowhere
+  const ProfileTable *active = &stationary; ///< the profile being followed
+  double active_start = 0;                  ///< where the active movement started
+  double active_scale = 1;                  ///< direction and stretch from the table to the active movement
+
+  const ProfileTable &table_for(double distance);
 
   double current_pos;
   double end_pt;
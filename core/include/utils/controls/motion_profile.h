@@ -0,0 +1,37 @@
+#pragma once
+
+/**
+ * motion_t is a description of 1 dimensional motion at a point in time.
+ */
+typedef struct {
+  double pos;   ///< 1d position at this point in time
+  double vel;   ///< 1d velocity at this point in time
+  double accel; ///< 1d acceleration at this point in time
+
+} motion_t;
+
+/**
+ * Interface so that controllers can easily switch between motion profiles (TrapezoidProfile, SCurveProfile)
+ */
+class MotionProfile {
+public:
+  /**
+   * Run the profile based on the time that's ellapsed
+   *
+   * @param time_s Time since start of movement
+   * @return motion_t Position, velocity and acceleration
+   */
+  virtual motion_t calculate(double time_s) = 0;
+
+  /**
+   * Define the start and end positions
+   * @param start the starting position of the path
+   * @param end the ending position of the path
+   */
+  virtual void set_endpts(double start, double end) = 0;
+
+  /**
+   * @return how long moving along the profile takes
+   */
+  virtual double get_movement_time() = 0;
+};
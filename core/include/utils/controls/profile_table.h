@@ -0,0 +1,67 @@
+#pragma once
+
+#include "../core/include/utils/controls/motion_profile.h"
+#include <vector>
+
+/**
+ * ProfileTable
+ *
+ * A motion profile sampled ahead of time, so that following it costs a table lookup instead of solving the profile's
+ * equations every control loop.
+ *
+ * build() samples a profile from 0 to a distance every dt seconds. lookup() then finds the two samples either side of
+ * a time and interpolates between them, so the time doesn't have to line up with the samples. Samples are stored as
+ * floats to keep tables small: a 2 second movement sampled at 10ms is about 2.4KB.
+ *
+ * The table only holds the shape of the movement. Moving the other direction, or starting somewhere other than 0, is
+ * done by whoever uses it (see MotionController).
+ */
+class ProfileTable {
+public:
+  /**
+   * Create an empty table. Lookups return 0 until it is built
+   */
+  ProfileTable();
+
+  /**
+   * Sample a profile from 0 to distance
+   *
+   * @param profile the profile to sample. Its endpoints are changed
+   * @param distance how far the movement goes. Negative distances are sampled as positive
+   * @param dt time between samples (sec)
+   */
+  void build(MotionProfile &profile, double distance, double dt);
+
+  /**
+   * Get the motion at a point in time, interpolated between the nearest samples
+   *
+   * @param time_s Time since start of movement
+   * @return motion_t Position, velocity and acceleration
+   */
+  motion_t lookup(double time_s) const;
+
+  /**
+   * @return how far the movement goes
+   */
+  double get_distance() const;
+
+  /**
+   * @return how long the movement takes (sec)
+   */
+  double get_movement_time() const;
+
+private:
+  /**
+   * One sample of the profile
+   */
+  typedef struct {
+    float pos;
+    float vel;
+    float accel;
+  } sample_t;
+
+  std::vector<sample_t> samples;
+  double distance;      ///< how far the movement goes
+  double movement_time; ///< how long the movement takes (sec)
+  double inv_dt;        ///< 1 / time between samples
+};
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "../core/include/utils/controls/motion_profile.h"
+
+/**
+ * S-Curve Profile
+ *
+ * A motion profile like TrapezoidProfile, but with a limit on jerk (the rate acceleration changes) as well as
+ * acceleration and velocity. Instead of switching straight from full acceleration to none, acceleration ramps up and
+ * down, so the velocity graph has rounded corners (an S at each end).
+ *
+ * The movement is made of 7 segments:
+ *   1. jerk up to full acceleration
+ *   2. hold full acceleration
+ *   3. jerk down to no acceleration, reaching the top speed
+ *   4. cruise at the top speed
+ *   5-7. the same as 1-3 in reverse, to stop
+ * Short movements skip segments: there's no cruise if the robot can't reach max_v, and no constant acceleration if it
+ * can't reach full acceleration. The segments are solved whenever the endpoints or limits change.
+ *
+ * Like TrapezoidProfile, the movement can start and end moving (see set_vel_endpts()), so chained movements keep their
+ * jerk limit. Segments 1-3 then go from the start velocity to the top speed (slowing down if it starts faster than
+ * max_v) and 5-7 from the top speed to the end velocity. If the end velocity can't be reached in the distance, the
+ * profile speeds up the whole way and ends as fast as it can. If it's already going too fast to slow down to the end
+ * velocity in time, it slows down the whole way and reaches the end as slow as it can, so the movement overshoots.
+ * After the movement it reports the end velocity, not the speed it arrived at.
+ *
+ * Because the drivetrain never sees an instant change in acceleration, wheels are less likely to slip and the robot is
+ * less likely to tip, so accel can usually be tuned higher than a trapezoid profile's. If jerk is 0, there is no jerk
+ * limit and the profile is a trapezoid.
+ */
+class SCurveProfile : public MotionProfile {
+public:
+  /**
+   * @brief Construct a new S-Curve Profile object
+   *
+   * @param max_v Maximum velocity the robot can run at
+   * @param accel Maximum acceleration of the robot
+   * @param jerk Maximum rate of change of acceleration, or 0 for no limit
+   */
+  SCurveProfile(double max_v, double accel, double jerk);
+
+  /**
+   * @brief Run the profile based on the time that's ellapsed
+   *
+   * @param time_s Time since start of movement
+   * @return motion_t Position, velocity and acceleration
+   */
+  motion_t calculate(double time_s) override;
+
+  /**
+   * set_endpts defines a start and end position
+   * @param start the starting position of the path
+   * @param end the ending position of the path
+   */
+  void set_endpts(double start, double end) override;
+
+  /**
+   * set_vel_endpts defines the velocity at the start and end of the path. Both are 0 unless set.
+   * The end velocity is limited to between 0 and max_v in the direction of the movement
+   * @param start_vel the velocity the path starts at
+   * @param end_vel the velocity the path should end at
+   */
+  void set_vel_endpts(double start_vel, double end_vel);
+
+  /**
+   * sets the maximum velocity for the profile
+   * @param max_v the maximum velocity the robot can travel at
+   */
+  void set_max_v(double max_v);
+
+  /**
+   * sets the acceleration this profile will use
+   * @param accel the acceleration amount to use
+   */
+  void set_accel(double accel);
+
+  /**
+   * sets the jerk this profile will use
+   * @param jerk the rate acceleration can change at, or 0 for no limit
+   */
+  void set_jerk(double jerk);
+
+  /**
+   * @return the time the path will take to travel
+   */
+  double get_movement_time() override;
+
+private:
+  /**
+   * One of the 7 segments, with the motion at the start of it
+   */
+  typedef struct {
+    double duration; ///< how long the segment lasts
+    double jerk;     ///< the constant jerk during the segment
+    double pos;      ///< distance from the start of the movement when the segment starts
+    double vel;      ///< velocity when the segment starts
+    double accel;    ///< acceleration when the segment starts
+  } segment_t;
+
+  void solve();
+  motion_t along(double time_s) const;
+
+  double start, end;         ///< the start and ending position of the profile
+  double start_vel, end_vel; ///< the velocity at the start and end of the profile
+  double max_v;              ///< the maximum velocity to travel at for this profile
+  double accel;              ///< the most acceleration to use for this profile
+  double jerk;               ///< the most jerk to use for this profile, 0 for no limit
+  double time;               ///< how long the whole movement takes
+  double after_vel;          ///< the velocity reported after the movement, along the direction of travel
+
+  segment_t segments[7];
+};
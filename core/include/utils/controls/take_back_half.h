@@ -15,7 +15,7 @@ public:
    * @param start_vel Movement starting velocity (IGNORED)
    * @param end_vel Movement ending velocity (IGNORED)
    */
-  void init(double start_pt, double set_pt);
+  void init(double start_pt, double set_pt, double start_vel = 0, double end_vel = 0);
   /**
    * Iterate the feedback loop once with an updated sensor value
    *
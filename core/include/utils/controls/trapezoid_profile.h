@@ -1,14 +1,6 @@
 #pragma once
 
-/**
- * motion_t is a description of 1 dimensional motion at a point in time.
- */
-typedef struct {
-  double pos;   ///< 1d position at this point in time
-  double vel;   ///< 1d velocity at this point in time
-  double accel; ///< 1d acceleration at this point in time
-
-} motion_t;
+#include "../core/include/utils/controls/motion_profile.h"
 
 /**
  * Trapezoid Profile
@@ -20,6 +12,12 @@ typedef struct {
  * If the maximum velocity is set high enough, this will become a S-curve profile, with only acceleration and
  * deceleration.
  *
+ * The movement can start and end moving (see set_vel_endpts()), so that one movement can flow into the next without
+ * stopping. If the end velocity can't be reached in the distance, the profile accelerates the whole way and ends as
+ * fast as it can. If it's already going too fast to slow down to the end velocity in time, it decelerates the whole way
+ * and reaches the end as slow as it can, so the movement overshoots. After the movement it reports the end velocity,
+ * not the speed it arrived at.
+ *
  * This class is designed for use in properly modelling the motion of the robots to create a feedfoward
  * and target for PID. Acceleration and Maximum velocity should be measured on the robot and tuned down
  * slightly to account for battery drop.
@@ -31,7 +29,7 @@ typedef struct {
  * @date 7/12/2022
  *
  */
-class TrapezoidProfile {
+class TrapezoidProfile : public MotionProfile {
 public:
   /**
    * @brief Construct a new Trapezoid Profile object
@@ -47,14 +45,22 @@ public:
    * @param time_s Time since start of movement
    * @return motion_t Position, velocity and acceleration
    */
-  motion_t calculate(double time_s);
+  motion_t calculate(double time_s) override;
 
   /**
    * set_endpts defines a start and end position
    * @param start the starting position of the path
    * @param end the ending position of the path
    */
-  void set_endpts(double start, double end);
+  void set_endpts(double start, double end) override;
+
+  /**
+   * set_vel_endpts defines the velocity at the start and end of the path. Both are 0 unless set.
+   * The end velocity is limited to between 0 and max_v in the direction of the movement
+   * @param start_vel the velocity the path starts at
+   * @param end_vel the velocity the path should end at
+   */
+  void set_vel_endpts(double start_vel, double end_vel);
 
   /**
    * set_accel sets the acceleration this profile will use (the left and right legs of the trapezoid)
@@ -74,11 +80,12 @@ public:
    * take
    * @return the time the path will take to travel
    */
-  double get_movement_time();
+  double get_movement_time() override;
 
 private:
-  double start, end; ///< the start and ending position of the profile
-  double max_v;      ///< the maximum velocity to travel at for this profile
-  double accel;      ///< the rate of acceleration to use for this profile.
-  double time;       ///< the current point in time along the path
+  double start, end;         ///< the start and ending position of the profile
+  double start_vel, end_vel; ///< the start and ending velocity of the profile
+  double max_v;              ///< the maximum velocity to travel at for this profile
+  double accel;              ///< the rate of acceleration to use for this profile.
+  double time;               ///< the current point in time along the path
 };
\ No newline at end of file
@@ -0,0 +1,130 @@
+#pragma once
+#include "../core/include/utils/geometry.h"
+#include <vector>
+
+/**
+ * LeastSquaresDerivative
+ *
+ * Estimates how fast a noisy signal is changing, and how fast that is changing, without the lag of differencing two
+ * far-apart samples and then averaging.
+ *
+ * Every sample, a quadratic is fit through the last window_size samples by least squares and its slope and curvature
+ * are read off at the newest sample. This is a Savitzky-Golay filter that allows uneven sample times. For anything
+ * that moves smoothly over the window (a robot accelerating), the fit follows it with no lag; the noise is averaged
+ * out over the window instead of over time.
+ *
+ * Samples closer together than min_interval replace the newest one rather than pushing out the oldest, so the window
+ * always covers about window_size * min_interval seconds however fast samples arrive, and always ends at the latest.
+ */
+class LeastSquaresDerivative {
+public:
+  /**
+   * Create an estimator. All memory is allocated here
+   *
+   * @param window_size  how many samples to fit over. More is smoother, fewer follows sudden changes faster
+   * @param min_interval the shortest time between samples kept in the window (sec)
+   */
+  LeastSquaresDerivative(int window_size = 12, double min_interval = 0.005);
+
+  /**
+   * Add a reading and refit
+   *
+   * @param time  when the reading was taken (sec). Must not go backwards
+   * @param value the reading
+   */
+  void add_sample(double time, double value);
+
+  /**
+   * Forget all samples
+   */
+  void reset();
+
+  /**
+   * @return the smoothed value at the newest sample
+   */
+  double get_value() const;
+
+  /**
+   * @return the rate of change at the newest sample (units/sec)
+   */
+  double get_rate() const;
+
+  /**
+   * @return the rate of change of the rate of change at the newest sample (units/sec^2)
+   */
+  double get_accel() const;
+
+private:
+  /**
+   * Fit the quadratic through the samples in the window
+   */
+  void fit();
+
+  std::vector<double> times;  // sample times, in a ring
+  std::vector<double> values; // sample values, in a ring
+  int newest;                 // index of the newest sample
+  int count;                  // number of samples in the ring
+  double min_interval;        // samples closer together than this replace the newest
+  double last_slot_time;      // time the newest slot was first filled
+
+  double value; // fitted value at the newest sample
+  double rate;  // fitted first derivative at the newest sample
+  double accel; // fitted second derivative at the newest sample
+};
+
+/**
+ * PoseDerivativeEstimator
+ *
+ * Speed, acceleration and their angular versions for a robot, from least squares fits of its recent x, y and
+ * rotation. See LeastSquaresDerivative.
+ */
+class PoseDerivativeEstimator {
+public:
+  /**
+   * Create an estimator. All memory is allocated here
+   *
+   * @param window_size  how many samples to fit over
+   * @param min_interval the shortest time between samples kept in the window (sec)
+   */
+  PoseDerivativeEstimator(int window_size = 12, double min_interval = 0.005);
+
+  /**
+   * Add a position and refit
+   *
+   * @param time when the robot was at pos (sec). Must not go backwards
+   * @param pos  the robot's position, rotation in degrees
+   */
+  void add_sample(double time, const pose_t &pos);
+
+  /**
+   * Forget all samples, e.g. when the position jumps because it was reset
+   */
+  void reset();
+
+  /**
+   * @return how fast the robot is travelling, in any direction (inch/s)
+   */
+  double get_speed() const;
+
+  /**
+   * @return the rate the speed is changing (inch/s^2)
+   */
+  double get_accel() const;
+
+  /**
+   * @return how fast the robot is turning, CCW positive (deg/s)
+   */
+  double get_angular_speed_deg() const;
+
+  /**
+   * @return the rate the turning speed is changing (deg/s^2)
+   */
+  double get_angular_accel_deg() const;
+
+private:
+  LeastSquaresDerivative x_fit;   // fit of recent x positions
+  LeastSquaresDerivative y_fit;   // fit of recent y positions
+  LeastSquaresDerivative rot_fit; // fit of recent rotations, unwrapped
+  bool has_rot;                   // false until the first sample
+  double rot_unwrapped;           // rotation without wrapping at 360, so it can be fit (deg)
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+/**
+ * Levenberg-Marquardt nonlinear least squares
+ *
+ * Finds the parameters that make a set of residuals (errors between a model and measurements) as small as possible,
+ * in the sum of squares sense. The model only has to be computable: derivatives are found numerically, so any code
+ * that turns parameters into residuals can be fit, e.g. replaying a logged run through odometry.
+ *
+ * Meant for a handful of parameters and up to a few thousand residuals. Memory is allocated once per call, so it runs
+ * the same on the brain as on a computer, and doesn't depend on vex.h.
+ */
+
+/**
+ * Computes the residuals for a set of parameters
+ *
+ * @param params    the parameters to try
+ * @param residuals filled in with num_residuals errors. Anything not filled in is left as 0
+ * @param ctx       whatever was passed to levenberg_marquardt, usually the measurements
+ */
+typedef void (*residual_fn_t)(const double *params, double *residuals, void *ctx);
+
+/**
+ * How a fit went
+ */
+typedef struct {
+  int iterations;   ///< steps taken
+  double rms_start; ///< root mean square of the residuals with the starting parameters
+  double rms_end;   ///< root mean square of the residuals with the fitted parameters
+  bool converged;   ///< true if the fit stopped improving, false if it ran out of iterations first
+} least_squares_result_t;
+
+/**
+ * Fit params to minimize the sum of the squared residuals
+ *
+ * @param residual_fn    computes the residuals for a set of parameters
+ * @param ctx            passed through to residual_fn
+ * @param params         the starting guess, replaced with the fitted values. Start near the answer: a rough
+ *                       measurement is usually plenty
+ * @param num_params     number of parameters
+ * @param num_residuals  number of residuals residual_fn fills in
+ * @param max_iterations give up after this many steps
+ * @return how the fit went
+ */
+least_squares_result_t levenberg_marquardt(residual_fn_t residual_fn, void *ctx, double *params, int num_params,
+                                           int num_residuals, int max_iterations = 100);
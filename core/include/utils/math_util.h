@@ -31,6 +31,18 @@ double sign(double x);
 double wrap_angle_deg(double input);
 double wrap_angle_rad(double input);
 
+/**
+ * Move a pose along the constant curvature arc that covers a given distance and turn (the SE(2) exponential map).
+ * Exact for any motion where the robot turns at a steady rate, unlike adding a straight line in one direction.
+ *
+ * @param start where the robot started, rotation in degrees with 90 = +y
+ * @param dist_fwd distance driven forward along the arc, in the robot's frame
+ * @param dist_side distance driven to the robot's right along the arc, in the robot's frame
+ * @param delta_rot_rad how much the robot turned over the arc, CCW positive (radians)
+ * @return the pose at the end of the arc
+ */
+pose_t integrate_arc(const pose_t &start, double dist_fwd, double dist_side, double delta_rot_rad);
+
 /*
 Calculates the variance of  a set of numbers (needed for linear regression)
 https://en.wikipedia.org/wiki/Variance
@@ -61,4 +73,9 @@ Calculates the slope and y intercept of the line of best fit for the data
 */
 std::pair<double, double> calculate_linear_regression(std::vector<std::pair<double, double>> const &points);
 
-double estimate_path_length(const std::vector<point_t> &points);
\ No newline at end of file
+/**
+ * Adds up the distances between consecutive points. Instantiated for float and double.
+ * @param points the points making up the path
+ * @return the length of the path
+ */
+template <typename T> T estimate_path_length(const std::vector<point2<T>> &points);
\ No newline at end of file
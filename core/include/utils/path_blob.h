@@ -0,0 +1,96 @@
+#pragma once
+
+#include "../core/include/utils/pure_pursuit.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Binary pure pursuit paths, baked on a computer by tools/path_compiler and loaded from the SD card.
+ *
+ * The file layout is a path_blob_header_t followed directly by num_points point_t's, all little endian
+ * (native on both the V5 brain and x86 hosts). The header is exactly two point_t's long so the whole
+ * file can be read straight into a point_t buffer with no parsing.
+ *
+ * Turning the points into a Path is not free: get_path() copies them and the Path constructor computes the headings,
+ * curvatures and arc length and checks the path against its radius, the same work as a path written in code. What the
+ * blob saves is the smoothing and injection, which the path compiler has already done. Call get_path() once while
+ * setting up, not every time the path is driven.
+ */
+namespace PurePursuit {
+
+/// @brief "PPTH" when read as a little endian uint32
+const uint32_t PATH_BLOB_MAGIC = 0x48545050;
+/// @brief bump this whenever path_blob_header_t or the point layout changes
+const uint32_t PATH_BLOB_VERSION = 1;
+
+/**
+ * The metadata at the start of every path blob
+ */
+typedef struct {
+  uint32_t magic;      ///< always PATH_BLOB_MAGIC
+  uint32_t version;    ///< the PATH_BLOB_VERSION the file was written with
+  uint32_t num_points; ///< number of point_t's following the header
+  uint32_t reserved;   ///< unused, keeps the points 8 byte aligned
+  double radius;       ///< pure pursuit lookahead radius the path was baked for
+  double spacing;      ///< spacing of the injected points, for reference
+} path_blob_header_t;
+
+static_assert(sizeof(path_blob_header_t) == 2 * sizeof(point_t), "path blob header must be two points long");
+
+/**
+ * Loads a baked path from the SD card into a buffer allocated once, up front.
+ *
+ * Usage:
+ *   PurePursuit::PathBlob skills_path(512);
+ *   if (skills_path.load("skills_1.path"))
+ *     drive_sys.PurePursuitCmd(skills_path.get_path(), FWD);
+ */
+class PathBlob {
+public:
+  /**
+   * Create a loader, allocating enough room for the largest path it will hold
+   *
+   * @param max_points the most points a loaded path may contain
+   */
+  PathBlob(int max_points = 1024);
+
+  /**
+   * Read a path blob from the SD card, replacing whatever was loaded before.
+   *
+   * @param filename the file on the SD card
+   * @return true if the file was read and is a valid path blob for this version
+   */
+  bool load(const char *filename);
+
+  /**
+   * @return true if the last call to load() succeeded
+   */
+  bool is_loaded() const;
+
+  /**
+   * @return the metadata of the loaded path
+   */
+  path_blob_header_t get_header() const;
+
+  /**
+   * @return a pointer to the loaded points, directly inside the file buffer
+   */
+  const point_t *get_points() const;
+
+  /**
+   * @return the number of loaded points
+   */
+  int get_num_points() const;
+
+  /**
+   * Construct a pure pursuit path from the loaded points, with the radius it was baked for. This copies the points and
+   * computes the Path's per-point data, so keep the result rather than calling it again
+   */
+  Path get_path() const;
+
+private:
+  std::vector<point_t> buf;
+  bool loaded;
+};
+
+} // namespace PurePursuit
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../core/include/utils/controls/trapezoid_profile.h"
 #include "../core/include/utils/geometry.h"
 #include "../core/include/utils/vector2d.h"
 #include "vex.h"
@@ -10,36 +11,173 @@ using namespace vex;
 namespace PurePursuit {
 /**
  * Wrapper for a vector of points, checking if any of the points are too close for pure pursuit
+ *
+ * On construction the path is also "baked": the heading, curvature and distance along the path at every point are
+ * computed once and stored in parallel arrays, so lookups while driving are binary searches instead of walks over
+ * the whole path.
  */
 class Path {
 public:
   /**
-   * Create a Path
-   * @param points the points that make up the path
+   * Create a Path. Pass the points with std::move if the caller doesn't need them afterwards, to skip copying them
+   * @param path_points the points that make up the path
    * @param radius the lookahead radius for pure pursuit
    */
-  Path(std::vector<point_t> points, double radius);
+  Path(std::vector<point_t> path_points, double radius);
 
   /**
    * Get the points associated with this Path
    */
-  std::vector<point_t> get_points();
+  const std::vector<point_t> &get_points() const;
 
   /**
    * Get the radius associated with this Path
    */
-  double get_radius();
+  double get_radius() const;
 
   /**
    * Get whether this path will behave as expected
    */
-  bool is_valid();
+  bool is_valid() const;
+
+  /**
+   * Get the heading of the path at each point, in radians (0 = +X, CCW positive).
+   * This is the direction of the segment leaving the point, or entering it for the last point.
+   */
+  const std::vector<double> &get_headings() const;
+
+  /**
+   * Get the signed curvature (1 / turning radius, in 1/inches) of the path at each point. Positive turns left.
+   * The first and last points have 0 curvature.
+   */
+  const std::vector<double> &get_curvatures() const;
+
+  /**
+   * Get the distance along the path from the first point to each point, in inches
+   */
+  const std::vector<double> &get_cumulative_dist() const;
+
+  /**
+   * Get the total length of the path, in inches
+   */
+  double get_length() const;
+
+  /**
+   * Find the segment (points[i] -> points[i + 1]) containing a distance along the path
+   * @param s distance along the path. Values past either end are clamped to the first / last segment
+   * @return the index of the segment's first point
+   */
+  int segment_at(double s) const;
+
+  /**
+   * Get the point a certain distance along the path
+   * @param s distance along the path, clamped between 0 and get_length()
+   */
+  point_t point_at(double s) const;
+
+  /**
+   * Get the direction of travel a certain distance along the path
+   * @param s distance along the path, clamped between 0 and get_length()
+   * @return heading in radians, 0 along +X and counter-clockwise positive
+   */
+  double heading_at(double s) const;
+
+  /**
+   * Get the curvature a certain distance along the path, interpolated between the points on either side
+   * @param s distance along the path, clamped between 0 and get_length()
+   * @return signed curvature (1 / inches), positive turning left
+   */
+  double curvature_at(double s) const;
+
+  /**
+   * Find how far along the path a point is, by projecting it onto the closest segment in a range of the path
+   * @param pt the point to project, usually the robot's position
+   * @param s_min start of the range of the path to search
+   * @param s_max end of the range of the path to search
+   * @return distance along the path of the projected point
+   */
+  double progress_of(point_t pt, double s_min, double s_max) const;
 
 private:
   std::vector<point_t> points;
+  std::vector<double> headings;
+  std::vector<double> curvatures;
+  std::vector<double> cumulative_dist;
   double radius;
   bool valid;
 };
+/**
+ * Velocity profile along a Path
+ *
+ * Assigns a target velocity to every point of a path. Velocity is first capped by the path's curvature so the
+ * sideways acceleration in turns stays below a limit (v = sqrt(max_lat_accel / curvature)). Then a forward pass
+ * limits how fast the robot speeds up and a backward pass limits how fast it slows down, so the robot brakes ahead of
+ * corners and the end of the path instead of in them. Acceleration is constant between points, which gives the time
+ * at which each point is reached.
+ *
+ * Positions in the resulting motion_t are distances along the path.
+ */
+class VelocityProfile {
+public:
+  /**
+   * velocity_profile_cfg_t holds the limits used to generate the profile
+   */
+  typedef struct {
+    double max_v;         ///< the maximum velocity the robot can drive (inch/s)
+    double accel;         ///< the most acceleration / deceleration the robot can do along the path (inch/s^2)
+    double max_lat_accel; ///< the most sideways acceleration allowed in turns before the robot slips (inch/s^2)
+  } velocity_profile_cfg_t;
+
+  /**
+   * Generate a velocity profile for a path
+   * @param path the path to profile
+   * @param cfg velocity and acceleration limits
+   * @param start_vel velocity the robot is already travelling at when the path starts (inch/s)
+   * @param end_vel velocity the robot should be travelling at when the path ends (inch/s)
+   */
+  VelocityProfile(const Path &path, velocity_profile_cfg_t cfg, double start_vel = 0, double end_vel = 0);
+
+  /**
+   * Get the target motion a certain time after starting the path
+   * @param time_s time since the start of the path
+   * @return distance along the path, velocity and acceleration
+   */
+  motion_t calculate(double time_s) const;
+
+  /**
+   * Get the target motion at a distance along the path
+   * @param s distance along the path
+   * @return distance along the path, velocity and acceleration
+   */
+  motion_t calculate_at_dist(double s) const;
+
+  /**
+   * @return the time it takes to drive the whole path
+   */
+  double get_movement_time() const;
+
+  /**
+   * Get the target velocity at each point of the path (inch/s)
+   */
+  const std::vector<double> &get_velocities() const;
+
+  /**
+   * Get the time at which each point of the path is reached (s)
+   */
+  const std::vector<double> &get_times() const;
+
+private:
+  /**
+   * Motion a certain time after passing a point, accelerating constantly towards the next point
+   */
+  motion_t motion_from(int i, double dt) const;
+
+  std::vector<double> dist;  ///< distance along the path of each point
+  std::vector<double> vel;   ///< target velocity at each point
+  std::vector<double> accel; ///< acceleration from each point to the next
+  std::vector<double> time;  ///< time at which each point is reached
+};
+
 /**
  * Represents a piece of a cubic spline with s(x) = a(x-xi)^3 + b(x-xi)^2 + c(x-xi) + d
  * The x_start and x_end shows where the equation is valid.
@@ -69,11 +207,112 @@ struct hermite_point {
  * segment is defined by two points, and the circle is defined by a center and radius.
  */
 extern std::vector<point_t> line_circle_intersections(point_t center, double r, point_t point1, point_t point2);
+
+/**
+ * Finds the intersections of a line segment and a circle without allocating. The line
+ * segment is defined by two points, and the circle is defined by a center and radius.
+ * Instantiated for float and double.
+ *
+ * @param out array the intersections are written to
+ * @return the number of intersections written to out (0, 1 or 2)
+ */
+template <typename T>
+int line_circle_intersections(point2<T> center, T r, point2<T> seg_start, point2<T> seg_end, point2<T> out[2]);
+
+/**
+ * Returns the minimum distance between the line segments (a1, a2) and (b1, b2).
+ * If the segments cross, the distance is 0.
+ * Instantiated for float and double.
+ */
+template <typename T> T segment_dist(point2<T> a1, point2<T> a2, point2<T> b1, point2<T> b2);
+
+/**
+ * Finds the segment (points[i] -> points[i + 1]) closest to a point, out of segments first through last.
+ * The loop is written without branches so it can be vectorized. Instantiated for float and double.
+ *
+ * @param points the points making up the segments
+ * @param first index of the first segment to check
+ * @param last index of the last segment to check. points[last + 1] must exist
+ * @param pt the point to search for
+ * @param t_out if not NULL, set to how far along the closest segment the closest point is, from 0 to 1
+ * @return the index of the closest segment, or -1 if first > last
+ */
+template <typename T> int closest_segment(const point2<T> *points, int first, int last, point2<T> pt, T *t_out);
+
 /**
  * Selects a look ahead from all the intersections in the path.
  */
 extern point_t get_lookahead(const std::vector<point_t> &path, pose_t robot_loc, double radius);
 
+/**
+ * Stateful lookahead search for following a single path.
+ *
+ * Remembers which segment the last lookahead point was on and only searches a bounded window of segments ahead of it,
+ * so each update costs the same no matter how long the path is, and nothing is allocated.
+ * Call reset() before following a new path.
+ */
+class LookaheadTracker {
+public:
+  /**
+   * Create a LookaheadTracker
+   * @param window how many segments past the last lookahead's segment to search each update
+   */
+  LookaheadTracker(int window = 16);
+
+  /**
+   * Start over from the beginning of the path
+   */
+  void reset();
+
+  /**
+   * Selects a look ahead from the intersections in the search window, moving the window forward as the robot
+   * progresses. The window never moves backwards along the path.
+   *
+   * @param path the path being followed. Must be the same path every call until reset()
+   * @param robot_loc the robot's current position
+   * @param radius the lookahead radius
+   * @return the lookahead point, or the end of the path if it's within the radius or no intersection was found
+   */
+  point_t get_lookahead(const std::vector<point_t> &path, pose_t robot_loc, double radius);
+
+  /**
+   * Get the index of the segment (path[i] -> path[i + 1]) the last lookahead point was found on
+   */
+  int get_segment() const;
+
+private:
+  int window;  ///< number of segments searched past the current one
+  int segment; ///< segment the last lookahead point was found on
+};
+
+/**
+ * Settings for picking the lookahead radius every update from the robot's speed and the curvature of the path
+ * ahead, instead of using the path's fixed radius. A larger radius keeps the robot from oscillating at speed,
+ * and a smaller one keeps it from cutting corners.
+ *
+ * The radius is (min_radius + speed_gain * speed) / (1 + curvature_gain * upcoming curvature),
+ * limited to [min_radius, max_radius].
+ */
+typedef struct {
+  double min_radius;     ///< radius when stopped, and the smallest it will ever be (inches)
+  double max_radius;     ///< largest the radius will ever be (inches)
+  double speed_gain;     ///< radius added per inch/s of robot speed (seconds)
+  double curvature_gain; ///< how strongly curvature (1/inches) shrinks the radius (inches)
+} adaptive_lookahead_cfg_t;
+
+/**
+ * Calculate the lookahead radius for this update.
+ * The curvature used is the sharpest point on the path within one speed-based radius past the given segment.
+ *
+ * @param path the path being followed
+ * @param segment the segment the last lookahead point was on (see LookaheadTracker::get_segment())
+ * @param speed the robot's current speed (inch/s)
+ * @param cfg the radius limits and gains
+ * @return the lookahead radius to use
+ */
+extern double adaptive_lookahead_radius(const Path &path, int segment, double speed,
+                                        const adaptive_lookahead_cfg_t &cfg);
+
 /**
  * Injects points in a path without changing the curvature with a certain spacing.
  */
@@ -84,15 +323,26 @@ extern std::vector<point_t> inject_path(const std::vector<point_t> &path, double
  *
  * Weight data is how much weight to update the data (alpha)
  * Weight smooth is how much weight to smooth the coordinates (beta)
- * Tolerance is how much change per iteration is necessary to continue iterating.
+ * Tolerance is no longer used - the smoothed path is solved for directly, see smooth_path_direct().
  *
- * Honestly have no idea if/how this works.
  * https://medium.com/@jaems33/understanding-robot-motion-path-smoothing-5970c8363bc4
  */
 
 extern std::vector<point_t> smooth_path(const std::vector<point_t> &path, double weight_data, double weight_smooth,
                                         double tolerance);
 
+/**
+ * Smooths a path by directly solving for the points the iterative smoother converges to.
+ * Runs in O(n) time with no iteration, so it always finishes.
+ *
+ * @param path The path to smooth
+ * @param weight_data How strongly the smoothed points are pulled towards the original points (alpha)
+ * @param weight_smooth How strongly the smoothed points are pulled towards their neighbors (beta)
+ * @return The smoothed path
+ */
+extern std::vector<point_t> smooth_path_direct(const std::vector<point_t> &path, double weight_data,
+                                               double weight_smooth);
+
 extern std::vector<point_t> smooth_path_cubic(const std::vector<point_t> &path, double res);
 
 /**
@@ -105,6 +355,19 @@ extern std::vector<point_t> smooth_path_cubic(const std::vector<point_t> &path,
  */
 extern std::vector<point_t> smooth_path_hermite(const std::vector<hermite_point> &path, double step);
 
+/**
+ * Interpolates a smooth path given a list of waypoints using hermite splines, placing the
+ * points an equal distance apart along the curve instead of at equal steps of the spline parameter.
+ *
+ * Every point is exactly `spacing` from the last (measured along the curve), except the final
+ * point which is always the last waypoint.
+ *
+ * @param path The path of hermite points to interpolate.
+ * @param spacing The distance along the curve between points.
+ * @return The smoothed path.
+ */
+extern std::vector<point_t> smooth_path_hermite_uniform(const std::vector<hermite_point> &path, double spacing);
+
 /**
  * Estimates the remaining distance from the robot's position to the end,
  * by "searching" for the robot along the path and running a "connect the dots"
@@ -117,4 +380,18 @@ extern std::vector<point_t> smooth_path_hermite(const std::vector<hermite_point>
  */
 extern double estimate_remaining_dist(const std::vector<point_t> &path, pose_t robot_pose, double radius);
 
+/**
+ * Estimates the remaining distance from the robot's position to the end using the path's precomputed
+ * distances. Only the part of the path just behind the lookahead point is searched for the robot.
+ *
+ * @param path The pure pursuit path the robot is following
+ * @param robot_pose The robot's current position
+ * @param lookahead The current lookahead point
+ * @param lookahead_seg The segment the lookahead point is on (see LookaheadTracker::get_segment())
+ * @param radius The lookahead radius used to find the lookahead point
+ * @return The distance along the path from the robot to the end
+ */
+extern double estimate_remaining_dist(const Path &path, pose_t robot_pose, point_t lookahead, int lookahead_seg,
+                                      double radius);
+
 } // namespace PurePursuit
\ No newline at end of file
@@ -7,11 +7,12 @@
  */
 MecanumDrive::MecanumDrive(vex::motor &left_front, vex::motor &right_front, vex::motor &left_rear,
                            vex::motor &right_rear, vex::rotation *lateral_wheel, vex::inertial *imu,
-                           mecanumdrive_config_t *config)
+                           mecanumdrive_config_t *config, OdometryBase *odom)
     : left_front(left_front), right_front(right_front), left_rear(left_rear), right_rear(right_rear), // MOTOR CONFIG
       config(config),               // CONFIG ...uh... config
       lateral_wheel(lateral_wheel), // NON-DRIVEN WHEEL CONFIG
-      imu(imu)                      // IMU CONFIG
+      imu(imu),                     // IMU CONFIG
+      odom(odom)                    // ODOMETRY CONFIG
 {
 
   // If the configuration exists, then allocate memory for the drive and turn pids
@@ -79,6 +80,31 @@ void MecanumDrive::drive(double left_y, double left_x, double right_x, int power
   return this->drive_raw(rad2deg(direction), magnitude, rotation);
 }
 
+/**
+ * Drive the robot like drive(), but relative to the field: pushing the left joystick forward drives toward +Y on the
+ * field, whichever way the robot is facing. Needs odometry; without it this is the same as drive().
+ *
+ * @param left_y left joystick, Y axis (toward +Y on the field)
+ * @param left_x left joystick, X axis (toward +X on the field)
+ * @param right_x right joystick, X axis (rotation left / right)
+ * @param power = 2 how much of a "curve" there should be on drive controls
+ */
+void MecanumDrive::drive_field_centric(double left_y, double left_x, double right_x, int power) {
+  if (odom == NULL) {
+    return drive(left_y, left_x, right_x, power);
+  }
+
+  double magnitude = sqrt(pow(left_y / 100.0, 2) + pow(left_x / 100.0, 2));
+  magnitude = pow(magnitude, power);
+
+  double rotation = right_x / 100.0;
+  rotation = sign(rotation) * fabs(pow(rotation, power));
+
+  // The joystick points in a direction on the field. drive_raw wants it relative to the robot's front, clockwise
+  double field_dir_deg = rad2deg(atan2(left_y, left_x));
+  return drive_raw(odom->get_position().rot - field_dir_deg, magnitude, rotation);
+}
+
 /**
  * Drive the robot in a straight line automatically.
  * If the inertial was declared in the constructor, use it to correct while driving.
@@ -251,4 +277,66 @@ bool MecanumDrive::auto_turn(double degrees, double speed, bool ignore_imu) {
   }
 
   return false;
+}
+/**
+ * Autonomously drive to a position and rotation on the field, strafing and turning at the same time.
+ *
+ * Every call, the direction to the target is turned from the field's frame into the robot's, so the robot drives
+ * straight at it however it's rotating on the way. The drive PID works on the distance left and the turn PID on the
+ * rotation left, both driven to 0.
+ *
+ * @param target where to end up. Rotation in degrees, CCW positive, like odometry
+ * @param speed the maximum speed to drive and turn at, in percent: 0.0 -> 1.0
+ *
+ * @return whether or not the robot has finished the maneuver
+ */
+bool MecanumDrive::auto_drive_to_pose(pose_t target, double speed) {
+  if (config == NULL || drive_pid == NULL || turn_pid == NULL || odom == NULL) {
+    fprintf(stderr, "Failed to run MecanumDrive::auto_drive_to_pose - Missing mecanumdrive_config_t or odometry in "
+                    "constructor\n");
+    return true;
+  }
+
+  // INITIALIZE - only run ONCE "per drive" on startup
+  if (init == true) {
+    drive_pid->reset();
+    drive_pid->set_limits(0, fabs(speed));
+    drive_pid->set_target(0);
+
+    turn_pid->reset();
+    turn_pid->set_limits(-fabs(speed), fabs(speed));
+    turn_pid->set_target(0);
+
+    init = false;
+  }
+
+  pose_t pos = odom->get_position();
+  double dx = target.x - pos.x;
+  double dy = target.y - pos.y;
+  double dist = sqrt((dx * dx) + (dy * dy));
+
+  // Both errors go in negated, so the outputs come out positive toward the target.
+  // Rotation is clockwise positive for drive_raw, the opposite of odometry
+  drive_pid->update(-dist);
+  turn_pid->update(OdometryBase::smallest_angle(pos.rot, target.rot));
+
+  double field_dir_deg = rad2deg(atan2(dy, dx));
+  this->drive_raw(pos.rot - field_dir_deg, drive_pid->get(), turn_pid->get());
+
+  // Stop and return true whenever the robot has reached the position and the rotation
+  if (drive_pid->is_on_target() && turn_pid->is_on_target()) {
+    drive_raw(0, 0, 0);
+    init = true;
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * Stop any automatic maneuver in progress, so the next one starts fresh
+ */
+void MecanumDrive::reset_auto() {
+  drive_raw(0, 0, 0);
+  init = true;
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "../core/include/subsystems/odometry/odometry_3wheel.h"
+#include "../core/include/subsystems/odometry/odometry_kinematics.h"
 #include "../core/include/utils/math_util.h"
 #include "../core/include/utils/vector2d.h"
 
@@ -13,68 +14,73 @@ Odometry3Wheel::Odometry3Wheel(CustomEncoder &lside_fwd, CustomEncoder &rside_fw
  * @return the robot's updated position
  */
 pose_t Odometry3Wheel::update() {
-  static double lside_old = 0, rside_old = 0, offax_old = 0;
+  odometry3wheel_sample_t sample = read_sensors();
 
-  double lside = lside_fwd.position(deg);
-  double rside = rside_fwd.position(deg);
-  double offax = off_axis.position(deg);
+  uint64_t now_us = vex::timer::systemHighResolution();
+  double dt = (last_sample_us == 0) ? 0 : (now_us - last_sample_us) / 1000000.0;
+  last_sample_us = now_us;
 
-  double lside_delta = lside - lside_old;
-  double rside_delta = rside - rside_old;
-  double offax_delta = offax - offax_old;
+  integrate(state, sample, dt, cfg);
 
-  lside_old = lside;
-  rside_old = rside;
-  offax_old = offax;
+  this->current_pos = state.pos;
+  this->speed = state.speed;
+  this->accel = state.accel;
+  this->ang_speed_deg = state.ang_speed_deg;
+  this->ang_accel_deg = state.ang_accel_deg;
 
-  pose_t updated_pos = calculate_new_pos(lside_delta, rside_delta, offax_delta, current_pos, cfg);
-
-  static pose_t last_pos = updated_pos;
-  static double last_speed = 0;
-  static double last_ang_speed = 0;
-  static timer tmr;
-
-  double speed_local = 0;
-  double accel_local = 0;
-  double ang_speed_local = 0;
-  double ang_accel_local = 0;
-  bool update_vel_accel = tmr.time(sec) > 0.1;
-
-  // This loop runs too fast. Only check at LEAST every 1/10th sec
-  if (update_vel_accel) {
-    // Calculate robot velocity
-    speed_local = pos_diff(updated_pos, last_pos) / tmr.time(sec);
-
-    // Calculate robot acceleration
-    accel_local = (speed_local - last_speed) / tmr.time(sec);
-
-    // Calculate robot angular velocity (deg/sec)
-    ang_speed_local = smallest_angle(updated_pos.rot, last_pos.rot) / tmr.time(sec);
-
-    // Calculate robot angular acceleration (deg/sec^2)
-    ang_accel_local = (ang_speed_local - last_ang_speed) / tmr.time(sec);
+  publish();
+  return current_pos;
+}
 
-    tmr.reset();
-    last_pos = updated_pos;
-    last_speed = speed_local;
-    last_ang_speed = ang_speed_local;
-  }
+/**
+ * Sets the current position of the robot
+ */
+void Odometry3Wheel::set_position(const pose_t &newpos) {
+  mut.lock();
+  state.pos = newpos;
+  // Don't count the jump to the new position as movement
+  state.motion.reset();
+  mut.unlock();
+
+  OdometryBase::set_position(newpos);
+}
 
-  this->current_pos = updated_pos;
-  if (update_vel_accel) {
-    this->speed = speed_local;
-    this->accel = accel_local;
-    this->ang_speed_deg = ang_speed_local;
-    this->ang_accel_deg = ang_accel_local;
-  }
+/**
+ * Read every encoder odometry uses
+ */
+Odometry3Wheel::odometry3wheel_sample_t Odometry3Wheel::read_sensors() {
+  return {lside_fwd.position(deg), rside_fwd.position(deg), off_axis.position(deg)};
+}
 
-  return current_pos;
+/**
+ * Advance odometry by one sensor sample. Doesn't touch hardware or anything outside its arguments, so logged
+ * samples can be replayed through it on a computer, or several configurations run side by side.
+ */
+void Odometry3Wheel::integrate(odometry3wheel_state_t &state, const odometry3wheel_sample_t &sample, double dt,
+                               const odometry3wheel_cfg_t &cfg) {
+  double lside_delta = sample.lside_deg - state.lside_deg;
+  double rside_delta = sample.rside_deg - state.rside_deg;
+  double offax_delta = sample.offax_deg - state.offax_deg;
+
+  state.lside_deg = sample.lside_deg;
+  state.rside_deg = sample.rside_deg;
+  state.offax_deg = sample.offax_deg;
+
+  state.pos = calculate_new_pos(lside_delta, rside_delta, offax_delta, state.pos, cfg);
+
+  // Fit the recent path every update, rather than differencing poses now and then
+  state.time += dt;
+  state.motion.add_sample(state.time, state.pos);
+  state.speed = state.motion.get_speed();
+  state.accel = state.motion.get_accel();
+  state.ang_speed_deg = state.motion.get_angular_speed_deg();
+  state.ang_accel_deg = state.motion.get_angular_accel_deg();
 }
 
 /**
  * Calculation method for the robot's new position using the change in encoders, the old position, and the robot's
- * configuration. This uses a series of arclength formulae for finding distance driven and change in angle. Then vector
- * math is used to combine it with the robot's old position data
+ * configuration. This uses a series of arclength formulae for finding distance driven and change in angle. Then the old
+ * position is moved along the arc those describe (see integrate_arc)
  *
  * @param lside_delta_deg Left encoder change in rotation, in degrees
  * @param rside_delta_deg Right encoder change in rotation, in degrees
@@ -85,40 +91,14 @@ pose_t Odometry3Wheel::update() {
  */
 pose_t Odometry3Wheel::calculate_new_pos(double lside_delta_deg, double rside_delta_deg, double offax_delta_deg,
                                          pose_t old_pos, odometry3wheel_cfg_t cfg) {
-  pose_t retval = {};
-
   // Arclength formula for encoder degrees -> single wheel distance driven
   double lside_dist = (cfg.wheel_diam / 2.0) * deg2rad(lside_delta_deg);
   double rside_dist = (cfg.wheel_diam / 2.0) * deg2rad(rside_delta_deg);
   double offax_dist = (cfg.wheel_diam / 2.0) * deg2rad(offax_delta_deg);
 
-  // Inverse arclength formula for arc distance driven -> robot angle
-  double delta_angle_rad = (rside_dist - lside_dist) / cfg.wheelbase_dist;
-  double delta_angle_deg = rad2deg(delta_angle_rad);
-
-  // Distance along the robot's local Y axis (forward/backward)
-  double dist_local_y = (lside_dist + rside_dist) / 2.0;
-
-  // Distance along the robot's local X axis (right/left)
-  double dist_local_x = offax_dist - (delta_angle_rad * cfg.off_axis_center_dist);
-
-  // Change in displacement as a vector, on the local coordinate system (+y = robot fwd)
-  Vector2D local_displacement({.x = dist_local_x, .y = dist_local_y});
-
-  // Rotate the local displacement to match the old robot's rotation
-  double dir_delta_from_trans_rad = local_displacement.get_dir() - (PI / 2.0);
-  double global_dir_rad = wrap_angle_rad(dir_delta_from_trans_rad + deg2rad(old_pos.rot));
-  Vector2D global_displacement(global_dir_rad, local_displacement.get_mag());
-
-  // Tack on the position change to the old position
-  Vector2D old_pos_vec({.x = old_pos.x, .y = old_pos.y});
-  Vector2D new_pos_vec = old_pos_vec + global_displacement;
-
-  retval.x = new_pos_vec.get_x();
-  retval.y = new_pos_vec.get_y();
-  retval.rot = wrap_angle_deg(old_pos.rot + delta_angle_deg);
-
-  return retval;
+  // Follow the arc the robot drove, starting from the old rotation
+  return three_wheel_kinematics(old_pos, lside_dist, rside_dist, offax_dist, cfg.wheelbase_dist,
+                                cfg.off_axis_center_dist);
 }
 
 /**
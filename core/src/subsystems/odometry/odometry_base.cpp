@@ -6,7 +6,10 @@
  *
  * @param is_async True to run constantly in the background, false to call update() manually
  */
-OdometryBase::OdometryBase(bool is_async) : current_pos(zero_pos) {
+OdometryBase::OdometryBase(bool is_async)
+    : current_pos(zero_pos), speed(0), accel(0), ang_speed_deg(0), ang_accel_deg(0), snapshot_seq(0) {
+  publish();
+
   if (is_async) {
     handle = new vex::task(background_task, (void *)this);
   }
@@ -26,11 +29,17 @@ int OdometryBase::background_task(void *ptr) {
     obj.mut.lock();
     obj.update();
     obj.mut.unlock();
+    obj.wait_for_update();
   }
 
   return 0;
 }
 
+/**
+ * Wait until update() has something new to work from. Sensors read on every update always have something new
+ */
+void OdometryBase::wait_for_update() {}
+
 /**
  * End the background task. Cannot be restarted.
  * If the user wants to end the thread but keep the data up to date,
@@ -41,15 +50,63 @@ void OdometryBase::end_async() { this->end_task = true; }
 /**
  * Gets the current position and rotation
  */
-pose_t OdometryBase::get_position(void) {
-  mut.lock();
+pose_t OdometryBase::get_position(void) { return get_snapshot().pos; }
 
-  // Create a new struct to pass-by-value
-  pose_t out = current_pos;
+/**
+ * Gets the position, speed and acceleration from the same update, without blocking the odometry task.
+ *
+ * Sequence lock read: the counter is odd while a publish is in progress and changes on every publish, so if it
+ * reads the same even value before and after copying, the copy wasn't torn. Otherwise try again.
+ */
+odometry_snapshot_t OdometryBase::get_snapshot() {
+  odometry_snapshot_t out;
+  while (true) {
+    uint32_t before = snapshot_seq.load(std::memory_order_acquire);
+    out = snapshot;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint32_t after = snapshot_seq.load(std::memory_order_relaxed);
+
+    if (before == after && (before & 1) == 0) {
+      return out;
+    }
+    // The odometry task is partway through publishing. Let it finish
+    vex::this_thread::yield();
+  }
+}
 
-  mut.unlock();
+/**
+ * Copy current_pos, speed, accel and the angular rates into the snapshot that readers see.
+ * Must be called with mut held (update() is, when running in the background).
+ */
+void OdometryBase::publish() {
+  odometry_snapshot_t next = {current_pos,   speed,         accel,
+                              ang_speed_deg, ang_accel_deg, vex::timer::systemHighResolution()};
+
+  uint32_t seq = snapshot_seq.load(std::memory_order_relaxed);
+  snapshot_seq.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  snapshot = next;
+  snapshot_seq.store(seq + 2, std::memory_order_release);
+
+  history.add({next.timestamp_us, next.pos, next.speed, next.ang_speed_deg});
+}
 
-  return out;
+/**
+ * Gets the position the robot was at some time in the past, for comparing against sensors with latency
+ */
+pose_t OdometryBase::get_position_at(uint64_t timestamp_us) {
+  // With no history yet, fall back to the current position
+  odometry_snapshot_t now = get_snapshot();
+  pose_history_entry_t entry = {now.timestamp_us, now.pos, now.speed, now.ang_speed_deg};
+  history.get_at(timestamp_us, entry);
+  return entry.pos;
+}
+
+/**
+ * Gets the position the robot was at some time in the past, with its speed
+ */
+bool OdometryBase::get_history_at(uint64_t timestamp_us, pose_history_entry_t &out) {
+  return history.get_at(timestamp_us, out);
 }
 
 /**
@@ -59,6 +116,9 @@ void OdometryBase::set_position(const pose_t &newpos) {
   mut.lock();
 
   current_pos = newpos;
+  // Poses from before the reset aren't in the same frame as the new one
+  history.clear();
+  publish();
 
   mut.unlock();
 }
@@ -109,34 +169,10 @@ double OdometryBase::smallest_angle(double start_deg, double end_deg) {
   return retval;
 }
 
-double OdometryBase::get_speed() {
-  mut.lock();
-  double retval = speed;
-  mut.unlock();
-
-  return retval;
-}
-
-double OdometryBase::get_accel() {
-  mut.lock();
-  double retval = accel;
-  mut.unlock();
-
-  return retval;
-}
-
-double OdometryBase::get_angular_speed_deg() {
-  mut.lock();
-  double retval = ang_speed_deg;
-  mut.unlock();
+double OdometryBase::get_speed() { return get_snapshot().speed; }
 
-  return retval;
-}
+double OdometryBase::get_accel() { return get_snapshot().accel; }
 
-double OdometryBase::get_angular_accel_deg() {
-  mut.lock();
-  double retval = ang_accel_deg;
-  mut.unlock();
+double OdometryBase::get_angular_speed_deg() { return get_snapshot().ang_speed_deg; }
 
-  return retval;
-}
\ No newline at end of file
+double OdometryBase::get_angular_accel_deg() { return get_snapshot().ang_accel_deg; }
\ No newline at end of file
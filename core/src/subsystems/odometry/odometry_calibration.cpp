@@ -0,0 +1,262 @@
+#include "../core/include/subsystems/odometry/odometry_calibration.h"
+#include "../core/include/subsystems/odometry/odometry_kinematics.h"
+#include "../core/include/utils/math_util.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Everything the residual function needs, passed through levenberg_marquardt
+ */
+typedef struct {
+  const calibration_log_t *log;
+  bool is_tank;
+  double wheel_diam;        // tank only, fixed
+  int start;                // sample the replay starts from
+  int end;                  // last sample the replay needs to reach
+  std::vector<pose_t> path; // replayed position at every sample from start to end
+} calibration_ctx_t;
+
+/**
+ * a - b, the short way around (degrees)
+ */
+static double angle_diff_deg(double a, double b) { return wrap_angle_deg(a - b + 180.0) - 180.0; }
+
+/**
+ * Rotation odometry would read from a tank sample, before the offset set_position adds
+ */
+static double tank_raw_angle(const calibration_sample_t &sample, double wheel_diam, double gear_ratio,
+                             double dist_between_wheels) {
+  if (sample.has_imu) {
+    // Translate "0 forward and clockwise positive" to "90 forward and CCW negative"
+    return -sample.imu_rotation_deg + 90;
+  }
+  return tank_encoder_angle(sample.lside / gear_ratio * M_PI * wheel_diam,
+                            sample.rside / gear_ratio * M_PI * wheel_diam, dist_between_wheels);
+}
+
+/**
+ * Replay the recording with a set of parameters, the same way OdometryTank or Odometry3Wheel would have run it
+ */
+static void replay(calibration_ctx_t &ctx, const double *params) {
+  const std::vector<calibration_sample_t> &samples = ctx.log->samples;
+  pose_t pos = ctx.log->references[0].pos;
+  ctx.path[0] = pos;
+
+  if (ctx.is_tank) {
+    double gear_ratio = params[0];
+    double dist_between_wheels = params[1];
+    double rotation_offset =
+        pos.rot - tank_raw_angle(samples[ctx.start], ctx.wheel_diam, gear_ratio, dist_between_wheels);
+    for (int i = ctx.start + 1; i <= ctx.end; i++) {
+      const calibration_sample_t &prev = samples[i - 1];
+      const calibration_sample_t &curr = samples[i];
+      double lside_dist = (curr.lside - prev.lside) / gear_ratio * M_PI * ctx.wheel_diam;
+      double rside_dist = (curr.rside - prev.rside) / gear_ratio * M_PI * ctx.wheel_diam;
+      double angle =
+          wrap_angle_deg(tank_raw_angle(curr, ctx.wheel_diam, gear_ratio, dist_between_wheels) + rotation_offset);
+      pos = tank_kinematics(pos, lside_dist, rside_dist, angle);
+      ctx.path[i - ctx.start] = pos;
+    }
+  } else {
+    // Arclength formula for encoder degrees -> single wheel distance driven
+    double dist_per_deg = (params[0] / 2.0) * (M_PI / 180.0);
+    for (int i = ctx.start + 1; i <= ctx.end; i++) {
+      const calibration_sample_t &prev = samples[i - 1];
+      const calibration_sample_t &curr = samples[i];
+      pos = three_wheel_kinematics(pos, dist_per_deg * (curr.lside - prev.lside),
+                                   dist_per_deg * (curr.rside - prev.rside), dist_per_deg * (curr.offax - prev.offax),
+                                   params[1], params[2]);
+      ctx.path[i - ctx.start] = pos;
+    }
+  }
+}
+
+/**
+ * Residuals for levenberg_marquardt: the replayed path's distance from each reference, and its heading's distance
+ * from the IMU's, each divided by how accurate that measurement is
+ */
+static void calibration_residuals(const double *params, double *residuals, void *ctx_ptr) {
+  calibration_ctx_t &ctx = *(calibration_ctx_t *)ctx_ptr;
+  const calibration_log_t &log = *ctx.log;
+  replay(ctx, params);
+
+  int n = 0;
+  for (size_t r = 1; r < log.references.size(); r++) {
+    const calibration_reference_t &ref = log.references[r];
+    if (ref.sample <= ctx.start || ref.sample > ctx.end) {
+      continue;
+    }
+    const pose_t &pos = ctx.path[ref.sample - ctx.start];
+    if (ref.use_position) {
+      residuals[n++] = (pos.x - ref.pos.x) / log.pos_stddev;
+      residuals[n++] = (pos.y - ref.pos.y) / log.pos_stddev;
+    }
+    if (ref.use_rotation) {
+      residuals[n++] = angle_diff_deg(pos.rot, ref.pos.rot) / log.rot_stddev_deg;
+    }
+  }
+
+  // The IMU only says how far the robot has turned since the start, which is exactly what the wheels get wrong
+  const calibration_sample_t &first = log.samples[ctx.start];
+  if (first.has_imu && log.imu_stride > 0) {
+    for (int i = ctx.start + log.imu_stride; i <= ctx.end; i += log.imu_stride) {
+      if (!log.samples[i].has_imu) {
+        continue;
+      }
+      double imu_turned = -(log.samples[i].imu_rotation_deg - first.imu_rotation_deg);
+      double odom_turned = angle_diff_deg(ctx.path[i - ctx.start].rot, ctx.path[0].rot);
+      residuals[n++] = angle_diff_deg(odom_turned, imu_turned) / log.imu_stddev_deg;
+    }
+  }
+}
+
+/**
+ * Set up, run and summarize a calibration
+ */
+static calibration_result_t calibrate(const calibration_log_t &log, bool is_tank, double wheel_diam, double *params,
+                                      int num_params) {
+  calibration_result_t result;
+  result.fit = {0, 0, 0, false};
+
+  if (log.samples.empty() || log.references.empty() || log.references[0].sample < 0 ||
+      log.references[0].sample >= (int)log.samples.size()) {
+    printf("Odometry calibration: the recording needs samples and a starting reference\n");
+    return result;
+  }
+
+  calibration_ctx_t ctx;
+  ctx.log = &log;
+  ctx.is_tank = is_tank;
+  ctx.wheel_diam = wheel_diam;
+  ctx.start = log.references[0].sample;
+  ctx.end = ctx.start;
+
+  // Count the residuals and find how far the replay has to go
+  int num_residuals = 0;
+  for (size_t r = 1; r < log.references.size(); r++) {
+    const calibration_reference_t &ref = log.references[r];
+    if (ref.sample <= ctx.start || ref.sample >= (int)log.samples.size()) {
+      continue;
+    }
+    num_residuals += (ref.use_position ? 2 : 0) + (ref.use_rotation ? 1 : 0);
+    if (ref.sample > ctx.end) {
+      ctx.end = ref.sample;
+    }
+  }
+  if (log.samples[ctx.start].has_imu && log.imu_stride > 0) {
+    for (int i = ctx.start + log.imu_stride; i < (int)log.samples.size(); i += log.imu_stride) {
+      if (log.samples[i].has_imu) {
+        num_residuals++;
+        if (i > ctx.end) {
+          ctx.end = i;
+        }
+      }
+    }
+  }
+  if (num_residuals < num_params) {
+    printf("Odometry calibration: %d measurements can't fit %d values, add more references\n", num_residuals,
+           num_params);
+    return result;
+  }
+
+  ctx.path.assign(ctx.end - ctx.start + 1, pose_t{0, 0, 0});
+  result.fit = levenberg_marquardt(calibration_residuals, &ctx, params, num_params, num_residuals);
+
+  // Report what's left at each reference with the fitted values
+  replay(ctx, params);
+  for (size_t r = 1; r < log.references.size(); r++) {
+    const calibration_reference_t &ref = log.references[r];
+    if (ref.sample <= ctx.start || ref.sample > ctx.end) {
+      continue;
+    }
+    const pose_t &pos = ctx.path[ref.sample - ctx.start];
+    calibration_residual_t res = {ref.sample, pos.x - ref.pos.x, pos.y - ref.pos.y,
+                                  angle_diff_deg(pos.rot, ref.pos.rot)};
+    result.residuals.push_back(res);
+  }
+
+  return result;
+}
+
+/**
+ * Fit the measurements of a 3 tracking wheel robot (see Odometry3Wheel)
+ */
+calibration_result_t calibrate_three_wheel(const calibration_log_t &log, double &wheel_diam, double &wheelbase_dist,
+                                           double &off_axis_center_dist) {
+  double params[3] = {wheel_diam, wheelbase_dist, off_axis_center_dist};
+  calibration_result_t result = calibrate(log, false, 0, params, 3);
+  wheel_diam = params[0];
+  wheelbase_dist = params[1];
+  off_axis_center_dist = params[2];
+  return result;
+}
+
+/**
+ * Fit the measurements of a tank drive (see OdometryTank)
+ */
+calibration_result_t calibrate_tank(const calibration_log_t &log, double wheel_diam, double &gear_ratio,
+                                    double &dist_between_wheels) {
+  double params[2] = {gear_ratio, dist_between_wheels};
+  calibration_result_t result = calibrate(log, true, wheel_diam, params, 2);
+  gear_ratio = params[0];
+  dist_between_wheels = params[1];
+  return result;
+}
+
+/**
+ * Write a sample as one line of a recording
+ */
+int format_calibration_sample(char *buf, int len, const calibration_sample_t &sample) {
+  return snprintf(buf, len, "sample,%.6f,%.6f,%.6f,%d,%.4f\n", sample.lside, sample.rside, sample.offax,
+                  sample.has_imu ? 1 : 0, sample.imu_rotation_deg);
+}
+
+/**
+ * Write a reference as one line of a recording
+ */
+int format_calibration_reference(char *buf, int len, const calibration_reference_t &ref) {
+  return snprintf(buf, len, "reference,%d,%.4f,%.4f,%.4f,%d,%d\n", ref.sample, ref.pos.x, ref.pos.y, ref.pos.rot,
+                  ref.use_position ? 1 : 0, ref.use_rotation ? 1 : 0);
+}
+
+/**
+ * Read one line of a recording written with the format_calibration_* functions into log
+ */
+bool parse_calibration_line(const char *line, calibration_log_t &log) {
+  while (*line == ' ' || *line == '\t') {
+    line++;
+  }
+  if (*line == '\0' || *line == '\n' || *line == '\r' || *line == '#') {
+    return true;
+  }
+
+  if (strncmp(line, "sample,", 7) == 0) {
+    calibration_sample_t sample;
+    int has_imu;
+    if (sscanf(line + 7, "%lf,%lf,%lf,%d,%lf", &sample.lside, &sample.rside, &sample.offax, &has_imu,
+               &sample.imu_rotation_deg) != 5) {
+      return false;
+    }
+    sample.has_imu = has_imu != 0;
+    log.samples.push_back(sample);
+    return true;
+  }
+
+  if (strncmp(line, "reference,", 10) == 0) {
+    calibration_reference_t ref;
+    int use_position, use_rotation;
+    if (sscanf(line + 10, "%d,%lf,%lf,%lf,%d,%d", &ref.sample, &ref.pos.x, &ref.pos.y, &ref.pos.rot, &use_position,
+               &use_rotation) != 6) {
+      return false;
+    }
+    if (ref.sample < 0) {
+      ref.sample = (int)log.samples.size() - 1;
+    }
+    ref.use_position = use_position != 0;
+    ref.use_rotation = use_rotation != 0;
+    log.references.push_back(ref);
+    return true;
+  }
+
+  return false;
+}
@@ -0,0 +1,239 @@
+#include "../core/include/subsystems/odometry/odometry_ekf.h"
+#include "../core/include/utils/math_util.h"
+#include "../core/include/utils/vector2d.h"
+#include <string.h>
+
+// Variance of the starting position: trusted completely, but not so much the math divides by zero
+#define INITIAL_VAR 1e-6
+
+/**
+ * Invert a 3x3 matrix
+ * @return false if it isn't invertible
+ */
+static bool invert3(const double m[3][3], double out[3][3]) {
+  double det = m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) - m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+               m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+  if (fabs(det) < 1e-12) {
+    return false;
+  }
+
+  out[0][0] = (m[1][1] * m[2][2] - m[1][2] * m[2][1]) / det;
+  out[0][1] = (m[0][2] * m[2][1] - m[0][1] * m[2][2]) / det;
+  out[0][2] = (m[0][1] * m[1][2] - m[0][2] * m[1][1]) / det;
+  out[1][0] = (m[1][2] * m[2][0] - m[1][0] * m[2][2]) / det;
+  out[1][1] = (m[0][0] * m[2][2] - m[0][2] * m[2][0]) / det;
+  out[1][2] = (m[0][2] * m[1][0] - m[0][0] * m[1][2]) / det;
+  out[2][0] = (m[1][0] * m[2][1] - m[1][1] * m[2][0]) / det;
+  out[2][1] = (m[0][1] * m[2][0] - m[0][0] * m[2][1]) / det;
+  out[2][2] = (m[0][0] * m[1][1] - m[0][1] * m[1][0]) / det;
+  return true;
+}
+
+/**
+ * out = a * b for 3x3 matrices. out may not be a or b
+ */
+static void mult3(const double a[3][3], const double b[3][3], double out[3][3]) {
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      out[i][j] = a[i][0] * b[0][j] + a[i][1] * b[1][j] + a[i][2] * b[2][j];
+    }
+  }
+}
+
+/**
+ * Create the filter
+ *
+ * @param wheel_odom the wheel odometry to get motion from. Must have been constructed with is_async = false
+ * @param cfg filter tuning. See ekf_cfg_t
+ * @param gps the GPS sensor, or NULL to only use the wheels and IMU
+ * @param imu the inertial sensor, or NULL to use the wheel odometry's rotation
+ * @param is_async true to constantly run in the background
+ */
+OdometryEKF::OdometryEKF(OdometryBase &wheel_odom, ekf_cfg_t &cfg, vex::gps *gps, vex::inertial *imu, bool is_async)
+    : OdometryBase(is_async), wheel_odom(wheel_odom), cfg(cfg), gps(gps), imu(imu) {
+  last_wheel_pos = wheel_odom.get_position();
+  last_imu_deg = (imu != NULL) ? imu->rotation(vex::rotationUnits::deg) : 0;
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      cov[i][j] = (i == j) ? INITIAL_VAR : 0;
+    }
+  }
+}
+
+/**
+ * Put the robot at a position, trusting it completely
+ */
+void OdometryEKF::set_position(const pose_t &newpos) {
+  mut.lock();
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      cov[i][j] = (i == j) ? INITIAL_VAR : 0;
+    }
+  }
+  mut.unlock();
+
+  OdometryBase::set_position(newpos);
+}
+
+/**
+ * Get the standard deviation of the filtered position
+ */
+double OdometryEKF::get_position_stddev() {
+  mut.lock();
+  double retval = sqrt(cov[0][0] + cov[1][1]);
+  mut.unlock();
+  return retval;
+}
+
+/**
+ * Wait until the wheel odometry has something new
+ */
+void OdometryEKF::wait_for_update() { wheel_odom.wait_for_update(); }
+
+/**
+ * Predict using the wheels and IMU, then correct using the GPS if it has a new reading
+ */
+pose_t OdometryEKF::update() {
+  // Motion since last time, according to the wheels, in the robot's frame
+  pose_t wheel_pos = wheel_odom.update();
+  double wheel_turn_deg = smallest_angle(last_wheel_pos.rot, wheel_pos.rot);
+  double wheel_mid_rad = deg2rad(last_wheel_pos.rot + wheel_turn_deg / 2.0);
+  double dx = wheel_pos.x - last_wheel_pos.x;
+  double dy = wheel_pos.y - last_wheel_pos.y;
+  double fwd = dx * cos(wheel_mid_rad) + dy * sin(wheel_mid_rad);
+  double side = dx * sin(wheel_mid_rad) - dy * cos(wheel_mid_rad);
+  last_wheel_pos = wheel_pos;
+
+  // The IMU is much better at rotation than the wheels. It reads clockwise positive
+  double turn_deg = wheel_turn_deg;
+  if (imu != NULL && imu->installed()) {
+    double imu_deg = imu->rotation(vex::rotationUnits::deg);
+    turn_deg = -(imu_deg - last_imu_deg);
+    last_imu_deg = imu_deg;
+  }
+
+  predict(fwd, side, deg2rad(turn_deg));
+
+  // Correct with the GPS when it has had time for a new reading
+  if (gps != NULL && gps->installed() && gps_tmr.time(vex::timeUnits::msec) > cfg.gps_interval_ms) {
+    gps_tmr.reset();
+    int quality = gps->quality();
+    if (quality >= cfg.gps_min_quality && quality > 0) {
+      // Same conversion as the GPS localizing: the GPS puts 0,0 at the center of the field
+      point_t from_center = {gps->xPosition(vex::distanceUnits::in), gps->yPosition(vex::distanceUnits::in)};
+      point_t rotated = Mat2::FromRotationDegrees(cfg.gps_field_rot_deg) * from_center;
+      // Odometry turns counter-clockwise. The GPS only does if it was constructed with turnType::left
+      double heading = gps->heading(vex::rotationUnits::deg);
+      double gps_rot = ((cfg.gps_turn == vex::turnType::left) ? heading : -heading) + cfg.gps_zero_rot_deg;
+      pose_t measured = {rotated.x + 72, rotated.y + 72, wrap_angle_deg(gps_rot + cfg.gps_field_rot_deg)};
+
+      // Lower quality means a noisier reading
+      double scale = 100.0 / quality;
+      double pos_stddev = cfg.gps_pos_stddev * scale;
+      double rot_stddev = deg2rad(cfg.gps_rot_stddev) * scale;
+      correct(measured, pos_stddev * pos_stddev, rot_stddev * rot_stddev);
+    }
+  }
+
+  speed = wheel_odom.get_speed();
+  accel = wheel_odom.get_accel();
+  ang_speed_deg = wheel_odom.get_angular_speed_deg();
+  ang_accel_deg = wheel_odom.get_angular_accel_deg();
+
+  publish();
+  return current_pos;
+}
+
+/**
+ * Move the state by a change in position measured in the robot's frame, and grow the covariance to match.
+ *
+ * The motion is applied along the average of the old and new rotations. The jacobian of the new state with respect to
+ * the old is the identity, plus how x and y swing when the rotation they were applied along is off.
+ */
+void OdometryEKF::predict(double fwd, double side, double turn_rad) {
+  double mid_rad = deg2rad(current_pos.rot) + turn_rad / 2.0;
+  double c = cos(mid_rad);
+  double s = sin(mid_rad);
+
+  current_pos.x += fwd * c + side * s;
+  current_pos.y += fwd * s - side * c;
+  current_pos.rot = wrap_angle_deg(current_pos.rot + rad2deg(turn_rad));
+
+  // cov = F * cov * F^T + Q
+  double f[3][3] = {{1, 0, -fwd * s + side * c}, {0, 1, fwd * c + side * s}, {0, 0, 1}};
+  double f_cov[3][3], f_t[3][3], new_cov[3][3];
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      f_t[i][j] = f[j][i];
+    }
+  }
+  mult3(f, cov, f_cov);
+  mult3(f_cov, f_t, new_cov);
+
+  // Noise grows with the distance moved, forward and sideways to the direction of travel, rotated onto the field
+  double dist = sqrt(fwd * fwd + side * side);
+  double fwd_var = cfg.fwd_var_per_in * dist;
+  double side_var = cfg.side_var_per_in * dist;
+  new_cov[0][0] += fwd_var * c * c + side_var * s * s;
+  new_cov[0][1] += (fwd_var - side_var) * c * s;
+  new_cov[1][0] += (fwd_var - side_var) * c * s;
+  new_cov[1][1] += fwd_var * s * s + side_var * c * c;
+  new_cov[2][2] += cfg.rot_var_per_rad * fabs(turn_rad);
+
+  memcpy(cov, new_cov, sizeof(cov));
+}
+
+/**
+ * Blend a full pose measurement into the state.
+ *
+ * The measurement is the state itself (H = I), so the gain is K = P * (P + R)^-1.
+ */
+bool OdometryEKF::correct(const pose_t &measured, double pos_var, double rot_var) {
+  double innovation[3] = {measured.x - current_pos.x, measured.y - current_pos.y,
+                          deg2rad(smallest_angle(current_pos.rot, measured.rot))};
+
+  double s[3][3], s_inv[3][3];
+  memcpy(s, cov, sizeof(s));
+  s[0][0] += pos_var;
+  s[1][1] += pos_var;
+  s[2][2] += rot_var;
+  if (!invert3(s, s_inv)) {
+    return false;
+  }
+
+  // Mahalanobis distance: how many standard deviations away the measurement is, squared
+  if (cfg.gps_gate > 0) {
+    double dist_sq = 0;
+    for (int i = 0; i < 3; i++) {
+      for (int j = 0; j < 3; j++) {
+        dist_sq += innovation[i] * s_inv[i][j] * innovation[j];
+      }
+    }
+    if (dist_sq > cfg.gps_gate) {
+      return false;
+    }
+  }
+
+  double k[3][3];
+  mult3(cov, s_inv, k);
+
+  current_pos.x += k[0][0] * innovation[0] + k[0][1] * innovation[1] + k[0][2] * innovation[2];
+  current_pos.y += k[1][0] * innovation[0] + k[1][1] * innovation[1] + k[1][2] * innovation[2];
+  double rot_chg_rad = k[2][0] * innovation[0] + k[2][1] * innovation[1] + k[2][2] * innovation[2];
+  current_pos.rot = wrap_angle_deg(current_pos.rot + rad2deg(rot_chg_rad));
+
+  // cov = (I - K) * cov, kept symmetric against rounding
+  double i_minus_k[3][3], new_cov[3][3];
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      i_minus_k[i][j] = (i == j ? 1 : 0) - k[i][j];
+    }
+  }
+  mult3(i_minus_k, cov, new_cov);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      cov[i][j] = (new_cov[i][j] + new_cov[j][i]) / 2.0;
+    }
+  }
+  return true;
+}
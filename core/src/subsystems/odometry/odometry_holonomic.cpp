@@ -0,0 +1,102 @@
+#include "../core/include/subsystems/odometry/odometry_holonomic.h"
+#include "../core/include/subsystems/odometry/odometry_kinematics.h"
+#include "../core/include/utils/math_util.h"
+
+/**
+ * Construct a new holonomic odometry object
+ *
+ * @param fwd_wheel encoder on the wheel that rolls when the robot drives forward
+ * @param side_wheel encoder on the wheel that rolls when the robot strafes
+ * @param imu the inertial sensor, for rotation
+ * @param cfg robot odometry configuration
+ * @param is_async true to constantly run in the background
+ */
+OdometryHolonomic::OdometryHolonomic(CustomEncoder &fwd_wheel, CustomEncoder &side_wheel, vex::inertial &imu,
+                                     odometryholonomic_cfg_t &cfg, bool is_async)
+    : OdometryBase(is_async), fwd_wheel(fwd_wheel), side_wheel(side_wheel), imu(imu), cfg(cfg) {}
+
+/**
+ * Update the current position of the robot once, using the current state of the sensors and the previous known
+ * location
+ *
+ * @return the robot's updated position
+ */
+pose_t OdometryHolonomic::update() {
+  odometryholonomic_sample_t sample = read_sensors();
+
+  uint64_t now_us = vex::timer::systemHighResolution();
+  double dt = (last_sample_us == 0) ? 0 : (now_us - last_sample_us) / 1000000.0;
+  last_sample_us = now_us;
+
+  integrate(state, sample, dt, cfg);
+
+  current_pos = state.pos;
+  speed = state.speed;
+  accel = state.accel;
+  ang_speed_deg = state.ang_speed_deg;
+  ang_accel_deg = state.ang_accel_deg;
+
+  publish();
+  return current_pos;
+}
+
+/**
+ * Sets the current position of the robot
+ */
+void OdometryHolonomic::set_position(const pose_t &newpos) {
+  mut.lock();
+  state.rotation_offset = newpos.rot - (state.pos.rot - state.rotation_offset);
+  state.pos = newpos;
+  // Don't count the jump to the new position as movement
+  state.motion.reset();
+  mut.unlock();
+
+  OdometryBase::set_position(newpos);
+}
+
+/**
+ * Read every sensor odometry uses
+ */
+OdometryHolonomic::odometryholonomic_sample_t OdometryHolonomic::read_sensors() {
+  return {fwd_wheel.position(vex::rotationUnits::deg), side_wheel.position(vex::rotationUnits::deg),
+          imu.rotation(vex::rotationUnits::deg)};
+}
+
+/**
+ * Advance odometry by one sensor sample. Doesn't touch hardware or anything outside its arguments, so logged
+ * samples can be replayed through it on a computer, or several configurations run side by side.
+ */
+void OdometryHolonomic::integrate(odometryholonomic_state_t &state, const odometryholonomic_sample_t &sample,
+                                  double dt, const odometryholonomic_cfg_t &cfg) {
+  // The encoders are absolute, so the first sample only tells us where they start
+  if (!state.initialized) {
+    state.fwd_deg = sample.fwd_deg;
+    state.side_deg = sample.side_deg;
+    state.initialized = true;
+  }
+
+  // Translate "0 forward and clockwise positive" to "90 forward and CCW negative", offset by any set_position
+  double angle = wrap_angle_deg(-sample.imu_rotation_deg + 90 + state.rotation_offset);
+
+  // Arclength formula for encoder degrees -> single wheel distance driven
+  double fwd_dist = (cfg.wheel_diam / 2.0) * (sample.fwd_deg - state.fwd_deg) * (M_PI / 180.0);
+  double side_dist = (cfg.wheel_diam / 2.0) * (sample.side_deg - state.side_deg) * (M_PI / 180.0);
+  state.fwd_deg = sample.fwd_deg;
+  state.side_deg = sample.side_deg;
+
+  // Follow the arc from the old heading to the new one, the short way around
+  double delta_angle_deg = wrap_angle_deg(angle - state.pos.rot + 180.0) - 180.0;
+  state.pos = holonomic_kinematics(state.pos, fwd_dist, side_dist, delta_angle_deg * (M_PI / 180.0),
+                                   cfg.fwd_wheel_offset, cfg.side_wheel_offset);
+
+  // The heading is measured directly, so use it as is instead of accumulating the change
+  state.pos.rot = angle;
+
+  // Fit the recent path every update, rather than differencing poses now and then
+  state.time += dt;
+  state.motion.add_sample(state.time, state.pos);
+  state.speed = state.motion.get_speed();
+  state.accel = state.motion.get_accel();
+  state.ang_speed_deg = state.motion.get_angular_speed_deg();
+  state.ang_accel_deg = state.motion.get_angular_accel_deg();
+}
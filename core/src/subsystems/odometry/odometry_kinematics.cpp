@@ -0,0 +1,62 @@
+#include "../core/include/subsystems/odometry/odometry_kinematics.h"
+#include "../core/include/utils/math_util.h"
+
+/**
+ * Rotation of a tank robot from how far each side has travelled in total, for when there's no IMU.
+ * Uses the absolute position of the encoders, so resetting them will result in a bad angle.
+ */
+double tank_encoder_angle(double lside_total, double rside_total, double dist_between_wheels) {
+  // Get the arclength of the turning circle of the robot
+  double distance_diff = rside_total - lside_total;
+
+  // Use the arclength formula to calculate the angle. Add 90 to make "0 degrees" to starboard
+  return ((180.0 / M_PI) * (distance_diff / dist_between_wheels)) + 90;
+}
+
+/**
+ * Move a tank robot by the distance its wheels travelled, along the arc to its new rotation
+ */
+pose_t tank_kinematics(const pose_t &pos, double lside_dist, double rside_dist, double angle_deg) {
+  // Average the sides for a "distance driven"
+  double dist_driven = (lside_dist + rside_dist) / 2.0;
+
+  // Follow the arc from the old heading to the new one, the short way around
+  double delta_angle_deg = wrap_angle_deg(angle_deg - pos.rot + 180.0) - 180.0;
+  pose_t new_pos = integrate_arc(pos, dist_driven, 0, delta_angle_deg * (M_PI / 180.0));
+
+  // The heading is measured directly, so use it as is instead of accumulating the change
+  new_pos.rot = angle_deg;
+
+  return new_pos;
+}
+
+/**
+ * Move a robot with 3 tracking wheels by the distance each wheel travelled.
+ * Uses arclength formulae for the distance driven and change in angle, then follows the arc those describe.
+ */
+pose_t three_wheel_kinematics(const pose_t &pos, double lside_dist, double rside_dist, double offax_dist,
+                              double wheelbase_dist, double off_axis_center_dist) {
+  // Inverse arclength formula for arc distance driven -> robot angle
+  double delta_angle_rad = (rside_dist - lside_dist) / wheelbase_dist;
+
+  // Distance along the robot's local Y axis (forward/backward)
+  double dist_local_y = (lside_dist + rside_dist) / 2.0;
+
+  // Distance along the robot's local X axis (right/left). Turning in place spins the off-axis wheel too
+  double dist_local_x = offax_dist - (delta_angle_rad * off_axis_center_dist);
+
+  return integrate_arc(pos, dist_local_y, dist_local_x, delta_angle_rad);
+}
+
+/**
+ * Move a holonomic robot tracked by one forward and one sideways wheel, with the change in rotation measured
+ * separately. A wheel away from the center also rolls while the robot turns in place, so that is taken out first.
+ */
+pose_t holonomic_kinematics(const pose_t &pos, double fwd_dist, double side_dist, double delta_rot_rad,
+                            double fwd_wheel_offset, double side_wheel_offset) {
+  // Turning CCW rolls a wheel on the right side forward, and a wheel at the front to the left
+  double dist_local_y = fwd_dist - (delta_rot_rad * fwd_wheel_offset);
+  double dist_local_x = side_dist + (delta_rot_rad * side_wheel_offset);
+
+  return integrate_arc(pos, dist_local_y, dist_local_x, delta_rot_rad);
+}
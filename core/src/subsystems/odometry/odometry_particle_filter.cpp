@@ -0,0 +1,107 @@
+#include "../core/include/subsystems/odometry/odometry_particle_filter.h"
+#include "../core/include/utils/math_util.h"
+#include "../core/include/utils/vector2d.h"
+
+/**
+ * Create the filter
+ *
+ * @param wheel_odom the wheel odometry to get motion from. Must have been constructed with is_async = false
+ * @param cfg filter tuning. See pf_cfg_t
+ * @param sensors the distance sensors to measure the walls with
+ * @param field the walls, 144 inches square from the origin by default
+ * @param is_async true to constantly run in the background
+ */
+OdometryParticleFilter::OdometryParticleFilter(OdometryBase &wheel_odom, pf_cfg_t &cfg,
+                                               const std::vector<distance_mount_t> &sensors, Rect field,
+                                               bool is_async)
+    : OdometryBase(is_async), wheel_odom(wheel_odom), cfg(cfg), sensors(sensors), filter(cfg.num_particles, field) {
+  for (const distance_mount_t &mount : sensors) {
+    rays.push_back({(float)mount.x, (float)mount.y, (float)deg2rad(mount.dir_deg)});
+  }
+
+  last_wheel_pos = wheel_odom.get_position();
+  filter.reset(current_pos, cfg.reset_pos_stddev, cfg.reset_rot_stddev_deg);
+}
+
+/**
+ * Put the robot at a position, scattering the particles around it
+ */
+void OdometryParticleFilter::set_position(const pose_t &newpos) {
+  mut.lock();
+  filter.reset(newpos, cfg.reset_pos_stddev, cfg.reset_rot_stddev_deg);
+  mut.unlock();
+
+  OdometryBase::set_position(newpos);
+}
+
+/**
+ * Get the spread of the particles
+ */
+double OdometryParticleFilter::get_position_stddev() {
+  mut.lock();
+  double retval = filter.get_position_stddev();
+  mut.unlock();
+  return retval;
+}
+
+/**
+ * Wait until the wheel odometry has something new
+ */
+void OdometryParticleFilter::wait_for_update() { wheel_odom.wait_for_update(); }
+
+/**
+ * Move the particles using the wheels, then correct using the distance sensors if they have new readings
+ */
+pose_t OdometryParticleFilter::update() {
+  // Motion since last time, according to the wheels, in the robot's frame
+  pose_t wheel_pos = wheel_odom.update();
+  double turn_deg = smallest_angle(last_wheel_pos.rot, wheel_pos.rot);
+  double mid_rad = deg2rad(last_wheel_pos.rot + turn_deg / 2.0);
+  double dx = wheel_pos.x - last_wheel_pos.x;
+  double dy = wheel_pos.y - last_wheel_pos.y;
+  double fwd = dx * cos(mid_rad) + dy * sin(mid_rad);
+  double side = dx * sin(mid_rad) - dy * cos(mid_rad);
+  last_wheel_pos = wheel_pos;
+
+  // Error grows with the distance moved, the same way OdometryEKF models it
+  double dist = sqrt(fwd * fwd + side * side);
+  double turn_rad = deg2rad(turn_deg);
+  filter.predict(fwd, side, turn_rad, sqrt(cfg.fwd_var_per_in * dist), sqrt(cfg.side_var_per_in * dist),
+                 sqrt(cfg.rot_var_per_rad * fabs(turn_rad) + cfg.rot_var_per_in * dist));
+
+  // Correct with the distance sensors when they have had time for new readings
+  if (sensor_tmr.time(vex::timeUnits::msec) > cfg.sensor_interval_ms) {
+    sensor_tmr.reset();
+    bool weighed = false;
+    for (size_t i = 0; i < sensors.size(); i++) {
+      vex::distance *sensor = sensors[i].sensor;
+      if (sensor == NULL || !sensor->installed() || !sensor->isObjectDetected()) {
+        continue;
+      }
+      double measured = sensor->objectDistance(vex::distanceUnits::in);
+      if (measured > sensors[i].max_range) {
+        continue;
+      }
+      filter.weigh(rays[i], measured, cfg.range_stddev, cfg.outlier_prob);
+      weighed = true;
+    }
+    if (weighed) {
+      filter.resample();
+    }
+  }
+
+  // Start over from the wheels' rotation if the particles have wandered off from it
+  if (cfg.check_window_in > 0) {
+    filter.check_rotation(cfg.check_window_in, cfg.check_max_rot_err_deg, cfg.reset_pos_stddev,
+                          cfg.reset_rot_stddev_deg);
+  }
+
+  current_pos = filter.estimate();
+  speed = wheel_odom.get_speed();
+  accel = wheel_odom.get_accel();
+  ang_speed_deg = wheel_odom.get_angular_speed_deg();
+  ang_accel_deg = wheel_odom.get_angular_accel_deg();
+
+  publish();
+  return current_pos;
+}
@@ -0,0 +1,165 @@
+#include "../core/include/subsystems/odometry/odometry_recorder.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Record the sensors of a tank drive
+ *
+ * @param odom        the odometry to record the sensors of
+ * @param config      the configuration odom was built with, for its odom_gear_ratio
+ * @param max_samples the most samples to keep
+ */
+OdometryRecorder::OdometryRecorder(OdometryTank &odom, robot_specs_t &config, int max_samples)
+    : tank(&odom), tank_config(&config), three_wheel(NULL), imu(NULL), max_samples(max_samples) {
+  log.samples.reserve(max_samples);
+}
+
+/**
+ * Record the sensors of a 3 tracking wheel robot
+ *
+ * @param odom        the odometry to record the encoders of
+ * @param imu         the robot's inertial sensor, or NULL to record without one
+ * @param max_samples the most samples to keep
+ */
+OdometryRecorder::OdometryRecorder(Odometry3Wheel &odom, vex::inertial *imu, int max_samples)
+    : tank(NULL), tank_config(NULL), three_wheel(&odom), imu(imu), max_samples(max_samples) {
+  log.samples.reserve(max_samples);
+}
+
+/**
+ * Function that runs in the background task. Reads a sample every period until stopped or out of room
+ *
+ * @param ptr Pointer to OdometryRecorder object
+ * @return Required integer return code. Unused.
+ */
+int OdometryRecorder::background_task(void *ptr) {
+  OdometryRecorder &rec = *((OdometryRecorder *)ptr);
+
+  while (rec.recording) {
+    calibration_sample_t sample = rec.read_sample();
+
+    rec.mut.lock();
+    bool full = (int)rec.log.samples.size() >= rec.max_samples;
+    if (!full) {
+      rec.log.samples.push_back(sample);
+    }
+    rec.mut.unlock();
+
+    if (full) {
+      printf("OdometryRecorder: all %d samples used, stopping\n", rec.max_samples);
+      rec.recording = false;
+      break;
+    }
+    vexDelay(rec.period_ms);
+  }
+
+  return 0;
+}
+
+/**
+ * Read every sensor calibration needs, in the units calibration_sample_t uses
+ */
+calibration_sample_t OdometryRecorder::read_sample() {
+  if (tank != NULL) {
+    OdometryTank::tank_sample_t s = tank->read_sensors();
+    // read_sensors() has already divided by the configured ratio. Undo it, so the fit isn't relative to it
+    double ratio = tank_config->odom_gear_ratio;
+    return {s.lside_revs * ratio, s.rside_revs * ratio, 0, s.has_imu, s.imu_rotation_deg};
+  }
+
+  Odometry3Wheel::odometry3wheel_sample_t s = three_wheel->read_sensors();
+  bool has_imu = imu != NULL && imu->installed();
+  double imu_rotation_deg = has_imu ? imu->rotation(vex::rotationUnits::deg) : 0;
+  if (isnan(imu_rotation_deg)) {
+    has_imu = false;
+    imu_rotation_deg = 0;
+  }
+  return {s.lside_deg, s.rside_deg, s.offax_deg, has_imu, imu_rotation_deg};
+}
+
+/**
+ * Start recording in the background. Cannot be restarted once stopped
+ */
+void OdometryRecorder::start(uint32_t period_ms) {
+  if (handle != NULL) {
+    printf("OdometryRecorder: already started\n");
+    return;
+  }
+  this->period_ms = period_ms;
+  recording = true;
+  handle = new vex::task(background_task, (void *)this);
+}
+
+/**
+ * Stop recording. The background task finishes its current sample and ends
+ */
+void OdometryRecorder::stop() { recording = false; }
+
+/**
+ * @return true while the background task is recording
+ */
+bool OdometryRecorder::is_recording() const { return recording; }
+
+/**
+ * Note that the robot is at a known position now. The reference goes with the latest sample, or the first one the
+ * background task takes if it hasn't taken any yet
+ */
+void OdometryRecorder::mark(const pose_t &pos, bool use_position, bool use_rotation) {
+  mut.lock();
+  if (log.samples.empty()) {
+    // Nothing has been read yet: read the sample the reference goes with now
+    log.samples.push_back(read_sample());
+  }
+  log.references.push_back({(int)log.samples.size() - 1, pos, use_position, use_rotation});
+  mut.unlock();
+}
+
+/**
+ * @return the recording so far
+ */
+calibration_log_t &OdometryRecorder::get_log() { return log; }
+
+/**
+ * Write the recording to the SD card, in the format tools/odometry_calibration reads. Lines are gathered into blocks
+ * so the card is written a couple of kilobytes at a time
+ */
+bool OdometryRecorder::save(const char *filename) {
+  vex::brain::sdcard sd;
+  if (!sd.isInserted()) {
+    printf("!! Trying to save odometry recording %s with no SD card !!\n", filename);
+    return false;
+  }
+
+  mut.lock();
+  char block[2048];
+  int used = snprintf(block, sizeof(block), "# odometry calibration recording, %d ms per sample\n", (int)period_ms);
+  sd.savefile(filename, (uint8_t *)block, used);
+
+  used = 0;
+  size_t num_lines = log.samples.size() + log.references.size();
+  for (size_t i = 0; i < num_lines; i++) {
+    char line[128];
+    int len;
+    if (i < log.samples.size()) {
+      len = format_calibration_sample(line, sizeof(line), log.samples[i]);
+    } else {
+      len = format_calibration_reference(line, sizeof(line), log.references[i - log.samples.size()]);
+    }
+
+    if (used + len > (int)sizeof(block)) {
+      sd.appendfile(filename, (uint8_t *)block, used);
+      used = 0;
+    }
+    memcpy(block + used, line, len);
+    used += len;
+  }
+  if (used > 0) {
+    sd.appendfile(filename, (uint8_t *)block, used);
+  }
+  mut.unlock();
+
+  printf("OdometryRecorder: saved %d samples and %d references to %s\n", (int)log.samples.size(),
+         (int)log.references.size(), filename);
+  return true;
+}
@@ -1,4 +1,6 @@
 #include "../core/include/subsystems/odometry/odometry_tank.h"
+#include "../core/include/subsystems/odometry/odometry_kinematics.h"
+#include "../core/include/utils/math_util.h"
 
 /**
  * Initialize the Odometry module, calculating position from the drive motors.
@@ -51,51 +53,180 @@ OdometryTank::OdometryTank(vex::encoder &left_vex_enc, vex::encoder &right_vex_e
  */
 void OdometryTank::set_position(const pose_t &newpos) {
   mut.lock();
-  rotation_offset = newpos.rot - (current_pos.rot - rotation_offset);
+  state.rotation_offset = newpos.rot - (state.pos.rot - state.rotation_offset);
+  state.pos = newpos;
+  // Don't count the jump to the new position as movement
+  state.motion.reset();
   mut.unlock();
 
   OdometryBase::set_position(newpos);
 }
 
 /**
- * Update, store and return the current position of the robot. Only use if not initializing
- * with a separate thread.
+ * Read every sensor odometry uses, from the sensor bus if there is one
  */
-pose_t OdometryTank::update() {
-  double lside_revs = 0, rside_revs = 0;
+OdometryTank::tank_sample_t OdometryTank::read_sensors() {
+  if (sensors != NULL) {
+    SensorBus::sensor_snapshot_t snapshot = sensors->get_snapshot();
+    if (snapshot.num_channels > imu_channel) {
+      return sample_from(snapshot);
+    }
+
+    // Not sampled yet, or the bus isn't taking snapshots. get() reads the devices and counts the reads
+    double imu_rotation_deg = sensors->get(imu_channel);
+    return {sensors->get(lside_channel), sensors->get(rside_channel), !isnan(imu_rotation_deg),
+            isnan(imu_rotation_deg) ? 0 : imu_rotation_deg};
+  }
 
+  double imu_rotation_deg = read_imu_deg();
+  return {read_side_revs(true), read_side_revs(false), !isnan(imu_rotation_deg),
+          isnan(imu_rotation_deg) ? 0 : imu_rotation_deg};
+}
+
+/**
+ * Read the sensors through a sensor bus from now on, so that odometry updates once per bus period on the same values
+ * every other subsystem sees
+ */
+void OdometryTank::use_sensor_bus(SensorBus &bus) {
+  mut.lock();
+  lside_channel = bus.add_channel([this]() { return read_side_revs(true); });
+  rside_channel = bus.add_channel([this]() { return read_side_revs(false); });
+  imu_channel = bus.add_channel([this]() { return read_imu_deg(); });
+  if (lside_channel >= 0 && rside_channel >= 0 && imu_channel >= 0) {
+    sensors = &bus;
+  }
+  mut.unlock();
+}
+
+/**
+ * Position of one side's encoders, in revolutions of the odometry wheel
+ */
+double OdometryTank::read_side_revs(bool left) {
   if (left_side != NULL && right_side != NULL) {
-    lside_revs = left_side->position(vex::rotationUnits::rev) / config.odom_gear_ratio;
-    rside_revs = right_side->position(vex::rotationUnits::rev) / config.odom_gear_ratio;
+    return (left ? left_side : right_side)->position(vex::rotationUnits::rev) / config.odom_gear_ratio;
   } else if (left_custom_enc != NULL && right_custom_enc != NULL) {
-    lside_revs = left_custom_enc->position(vex::rotationUnits::rev) / config.odom_gear_ratio;
-    rside_revs = right_custom_enc->position(vex::rotationUnits::rev) / config.odom_gear_ratio;
+    return (left ? left_custom_enc : right_custom_enc)->position(vex::rotationUnits::rev) / config.odom_gear_ratio;
   } else if (left_vex_enc != NULL && right_vex_enc != NULL) {
-    lside_revs = left_vex_enc->position(vex::rotationUnits::rev) / config.odom_gear_ratio;
-    rside_revs = right_vex_enc->position(vex::rotationUnits::rev) / config.odom_gear_ratio;
+    return (left ? left_vex_enc : right_vex_enc)->position(vex::rotationUnits::rev) / config.odom_gear_ratio;
+  }
+  return 0;
+}
+
+/**
+ * Inertial sensor rotation, clockwise positive. NAN if there isn't one
+ */
+double OdometryTank::read_imu_deg() {
+  if (imu != NULL && imu->installed()) {
+    return imu->rotation(vex::rotationUnits::deg);
+  }
+  return NAN;
+}
+
+/**
+ * Pick odometry's sensor values out of a sensor bus snapshot
+ */
+OdometryTank::tank_sample_t OdometryTank::sample_from(const SensorBus::sensor_snapshot_t &snapshot) {
+  double imu_rotation_deg = snapshot.values[imu_channel];
+  return {snapshot.values[lside_channel], snapshot.values[rside_channel], !isnan(imu_rotation_deg),
+          isnan(imu_rotation_deg) ? 0 : imu_rotation_deg};
+}
+
+/**
+ * Update, store and return the current position of the robot. Only use if not initializing
+ * with a separate thread.
+ *
+ * With a sensor bus, this only does anything once per new snapshot, and times it by when the snapshot was read.
+ */
+pose_t OdometryTank::update() {
+  tank_sample_t sample;
+  uint64_t now_us;
+
+  // The bus hasn't read odometry's channels until the first snapshot after use_sensor_bus
+  SensorBus::sensor_snapshot_t snapshot;
+  bool from_bus = false;
+  if (sensors != NULL) {
+    snapshot = sensors->get_snapshot();
+    from_bus = snapshot.num_channels > imu_channel;
+  }
+
+  if (from_bus) {
+    // Nothing new to integrate
+    if (snapshot.tick == last_tick) {
+      return current_pos;
+    }
+    last_tick = snapshot.tick;
+    sample = sample_from(snapshot);
+    now_us = snapshot.timestamp_us;
+  } else {
+    sample = read_sensors();
+    now_us = vex::timer::systemHighResolution();
+  }
+
+  double dt = (last_sample_us == 0) ? 0 : (now_us - last_sample_us) / 1000000.0;
+  last_sample_us = now_us;
+
+  integrate(state, sample, dt, config);
+
+  current_pos = state.pos;
+  speed = state.speed;
+  accel = state.accel;
+  ang_speed_deg = state.ang_speed_deg;
+  ang_accel_deg = state.ang_accel_deg;
+
+  publish();
+  return current_pos;
+}
+
+/**
+ * With a sensor bus, sleep until the bus should have read the sensors again.
+ *
+ * The bus reads once a period, so the next snapshot is due a period after the one odometry last used (or, if the bus
+ * isn't taking snapshots, a period after odometry last read the devices itself). If it's late, check again every ms.
+ */
+void OdometryTank::wait_for_update() {
+  mut.lock();
+  SensorBus *bus = sensors;
+  uint64_t last_us = last_sample_us;
+  mut.unlock();
+
+  if (bus == NULL) {
+    return;
+  }
+
+  uint64_t next_us = last_us + ((uint64_t)bus->get_period_ms() * 1000);
+  uint64_t now_us = vex::timer::systemHighResolution();
+  vexDelay((next_us > now_us) ? (uint32_t)((next_us - now_us + 999) / 1000) : 1);
+}
+
+/**
+ * Advance odometry by one sensor sample. Doesn't touch hardware or anything outside its arguments, so logged
+ * samples can be replayed through it on a computer, or several configurations run side by side.
+ */
+void OdometryTank::integrate(tank_state_t &state, const tank_sample_t &sample, double dt,
+                             const robot_specs_t &config) {
+  // The encoders are absolute, so the first sample only tells us where they start
+  if (!state.initialized) {
+    state.lside_revs = sample.lside_revs;
+    state.rside_revs = sample.rside_revs;
+    state.initialized = true;
   }
 
   double angle = 0;
 
   // If the IMU data was passed in, use it for rotational data
-  if (imu == NULL || imu->installed() == false) {
+  if (!sample.has_imu) {
     // Get the difference in distance driven between the two sides
     // Uses the absolute position of the encoders, so resetting them will result in
     // a bad angle.
-    // Get the arclength of the turning circle of the robot
-    double distance_diff = (rside_revs - lside_revs) * PI * config.odom_wheel_diam;
-
-    // Use the arclength formula to calculate the angle. Add 90 to make "0 degrees" to starboard
-    angle = ((180.0 / PI) * (distance_diff / config.dist_between_wheels)) + 90;
-
-    // printf("angle: %f, ", (180.0 / PI) * (distance_diff / config.dist_between_wheels));
+    angle = tank_encoder_angle(sample.lside_revs * PI * config.odom_wheel_diam,
+                               sample.rside_revs * PI * config.odom_wheel_diam, config.dist_between_wheels);
   } else {
     // Translate "0 forward and clockwise positive" to "90 forward and CCW negative"
-    angle = -imu->rotation(vex::rotationUnits::deg) + 90;
+    angle = -sample.imu_rotation_deg + 90;
   }
 
   // Offset the angle, if we've done a set_position
-  angle += rotation_offset;
+  angle += state.rotation_offset;
 
   // Limit the angle betwen 0 and 360.
   // fmod (floating-point modulo) gets it between -359 and +359, so tack on another 360 if it's negative.
@@ -104,74 +235,32 @@ pose_t OdometryTank::update() {
     angle += 360;
   }
 
-  current_pos = calculate_new_pos(config, current_pos, lside_revs, rside_revs, angle);
-
-  static pose_t last_pos = current_pos;
-  static double last_speed = 0;
-  static double last_ang_speed = 0;
-  static timer tmr;
-  bool update_vel_accel = tmr.time(sec) > 0.02;
-
-  // This loop runs too fast. Only check at LEAST every 1/10th sec
-  if (update_vel_accel) {
-    // Calculate robot velocity
-    double this_speed = pos_diff(current_pos, last_pos) / tmr.time(sec);
-    ema.add_entry(this_speed);
-    speed = ema.get_value();
-    // Calculate robot acceleration
-    accel = (speed - last_speed) / tmr.time(sec);
-
-    // Calculate robot angular velocity (deg/sec)
-    ang_speed_deg = smallest_angle(current_pos.rot, last_pos.rot) / tmr.time(sec);
-
-    // Calculate robot angular acceleration (deg/sec^2)
-    ang_accel_deg = (ang_speed_deg - last_ang_speed) / tmr.time(sec);
-
-    tmr.reset();
-    last_pos = current_pos;
-    last_speed = speed;
-    last_ang_speed = ang_speed_deg;
-  }
+  state.pos = calculate_new_pos(config, state.pos, sample.lside_revs - state.lside_revs,
+                                sample.rside_revs - state.rside_revs, angle);
 
-  return current_pos;
+  // Store the left and right encoder values to find the difference in the next iteration
+  state.lside_revs = sample.lside_revs;
+  state.rside_revs = sample.rside_revs;
+
+  // Fit the recent path every update, rather than differencing poses now and then
+  state.time += dt;
+  state.motion.add_sample(state.time, state.pos);
+  state.speed = state.motion.get_speed();
+  state.accel = state.motion.get_accel();
+  state.ang_speed_deg = state.motion.get_angular_speed_deg();
+  state.ang_accel_deg = state.motion.get_angular_accel_deg();
 }
 
 /**
  * Using information about the robot's mechanical structure and sensors, calculate a new position
  * of the robot, relative to when this method was previously ran.
  */
-pose_t OdometryTank::calculate_new_pos(robot_specs_t &config, pose_t &curr_pos, double lside_revs, double rside_revs,
-                                       double angle_deg) {
-  pose_t new_pos;
-
-  static double stored_lside_revs = lside_revs;
-  static double stored_rside_revs = rside_revs;
-
-  // Convert the revolutions into "change in distance", and average the values for a "distance driven"
-  double lside_diff = (lside_revs - stored_lside_revs) * PI * config.odom_wheel_diam;
-  double rside_diff = (rside_revs - stored_rside_revs) * PI * config.odom_wheel_diam;
-  double dist_driven = (lside_diff + rside_diff) / 2.0;
-
-  double angle = angle_deg * PI / 180.0; // Degrees to radians
-
-  // Create a vector from the change in distance in the current direction of the robot
-  // deg2rad((smallest_angle(curr_pos.rot, angle_deg)/2 + curr_pos.rot, dist_driven)
-  Vector2D chg_vec(angle, dist_driven);
-
-  // Create a vector from the current position in reference to X,Y=0,0
-  point_t curr_point = {.x = curr_pos.x, .y = curr_pos.y};
-  Vector2D curr_vec(curr_point);
-
-  // Tack on the "difference" vector to the current vector
-  Vector2D new_vec = curr_vec + chg_vec;
-
-  new_pos.x = new_vec.get_x();
-  new_pos.y = new_vec.get_y();
-  new_pos.rot = angle_deg;
-
-  // Store the left and right encoder values to find the difference in the next iteration
-  stored_lside_revs = lside_revs;
-  stored_rside_revs = rside_revs;
+pose_t OdometryTank::calculate_new_pos(const robot_specs_t &config, const pose_t &curr_pos, double lside_diff_revs,
+                                       double rside_diff_revs, double angle_deg) {
+  // Convert the revolutions into "change in distance"
+  double lside_diff = lside_diff_revs * PI * config.odom_wheel_diam;
+  double rside_diff = rside_diff_revs * PI * config.odom_wheel_diam;
 
-  return new_pos;
+  // Follow the arc from the old heading to the new one, rather than a straight line along the new heading
+  return tank_kinematics(curr_pos, lside_diff, rside_diff, angle_deg);
 }
\ No newline at end of file
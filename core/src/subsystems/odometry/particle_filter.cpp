@@ -0,0 +1,279 @@
+#include "../core/include/subsystems/odometry/particle_filter.h"
+#include <math.h>
+
+#define TWO_PI_F 6.28318531f
+
+/**
+ * Create the filter. All memory is allocated here
+ *
+ * @param num_particles how many guesses to keep
+ * @param field         the walls to measure against
+ */
+ParticleFilter::ParticleFilter(int num_particles, Rect field)
+    : num_particles(num_particles < 1 ? 1 : num_particles), field(field), rng_state(0x12345678) {
+  int n = this->num_particles;
+  x.assign(n, 0);
+  y.assign(n, 0);
+  rot.assign(n, 0);
+  weight.assign(n, 1.0f / n);
+  cos_rot.assign(n, 1);
+  sin_rot.assign(n, 0);
+  expected.assign(n, 0);
+  next_x.assign(n, 0);
+  next_y.assign(n, 0);
+  next_rot.assign(n, 0);
+  next_cos.assign(n, 1);
+  next_sin.assign(n, 0);
+}
+
+/**
+ * A random number from (close to) the standard normal distribution: the sum of four random bytes from an xorshift
+ * generator, centered and scaled. Much cheaper than the exact Box-Muller transform, and good enough for motion noise.
+ * The same sequence every run, so a logged run replays the same way.
+ */
+float ParticleFilter::gaussian() {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  int sum = (rng_state & 0xff) + ((rng_state >> 8) & 0xff) + ((rng_state >> 16) & 0xff) + (rng_state >> 24);
+
+  // Each byte has mean 127.5 and variance (256^2 - 1) / 12, so the sum has mean 510 and standard deviation 147.8
+  return (sum - 510) * (1.0f / 147.8f);
+}
+
+/**
+ * Scatter the particles around a position, all equally likely
+ */
+void ParticleFilter::reset(const pose_t &center, double pos_stddev, double rot_stddev_deg) {
+  float rot_stddev_rad = rot_stddev_deg * (M_PI / 180.0);
+  float center_rot_rad = center.rot * (M_PI / 180.0);
+  for (int i = 0; i < num_particles; i++) {
+    x[i] = center.x + pos_stddev * gaussian();
+    y[i] = center.y + pos_stddev * gaussian();
+    rot[i] = center_rot_rad + rot_stddev_rad * gaussian();
+    cos_rot[i] = cosf(rot[i]);
+    sin_rot[i] = sinf(rot[i]);
+    weight[i] = 1.0f / num_particles;
+  }
+  wheel_pose = center;
+  window_dist = 0;
+}
+
+/**
+ * Move every particle by a change in position measured in the robot's frame, plus its own random error.
+ * Like OdometryEKF::predict, the motion is applied along the average of the particle's old and new rotations.
+ */
+void ParticleFilter::predict(double fwd, double side, double turn_rad, double fwd_stddev, double side_stddev,
+                             double rot_stddev_rad) {
+  // Standing still: nothing moves, and nothing is added to the error
+  if (fwd == 0 && side == 0 && turn_rad == 0 && fwd_stddev == 0 && side_stddev == 0 && rot_stddev_rad == 0) {
+    return;
+  }
+
+  // The same motion with no error, for check_rotation()
+  double wheel_mid = wheel_pose.rot * (M_PI / 180.0) + turn_rad / 2;
+  wheel_pose.x += fwd * cos(wheel_mid) + side * sin(wheel_mid);
+  wheel_pose.y += fwd * sin(wheel_mid) - side * cos(wheel_mid);
+  wheel_pose.rot += turn_rad * (180.0 / M_PI);
+  window_dist += sqrt(fwd * fwd + side * side);
+
+  float min_x = field.min.x, min_y = field.min.y, max_x = field.max.x, max_y = field.max.y;
+  for (int i = 0; i < num_particles; i++) {
+    float p_fwd = fwd + fwd_stddev * gaussian();
+    float p_side = side + side_stddev * gaussian();
+    float p_turn = turn_rad + rot_stddev_rad * gaussian();
+
+    // Keep the rotation between -pi and pi, where float sin and cos are accurate
+    float r = rot[i] + p_turn;
+    r -= TWO_PI_F * floorf((r + (float)M_PI) / TWO_PI_F);
+    float new_c = cosf(r);
+    float new_s = sinf(r);
+
+    // The average direction is halfway between the old and new ones, which the sum of the two points along
+    float mid_c = cos_rot[i] + new_c;
+    float mid_s = sin_rot[i] + new_s;
+    float inv_len = 1.0f / sqrtf(mid_c * mid_c + mid_s * mid_s + 1e-12f);
+    mid_c *= inv_len;
+    mid_s *= inv_len;
+
+    // The robot can't be inside a wall, so neither can a particle
+    x[i] = fminf(fmaxf(x[i] + p_fwd * mid_c + p_side * mid_s, min_x), max_x);
+    y[i] = fminf(fmaxf(y[i] + p_fwd * mid_s - p_side * mid_c, min_y), max_y);
+    rot[i] = r;
+    cos_rot[i] = new_c;
+    sin_rot[i] = new_s;
+  }
+}
+
+/**
+ * Distance from each particle along a sensor's ray to the nearest wall.
+ *
+ * The ray leaves the field through whichever of the vertical walls and whichever of the horizontal walls it is
+ * heading toward, and the closer of the two is the one it hits.
+ */
+void ParticleFilter::ray_cast(const float *x, const float *y, const float *cos_rot, const float *sin_rot, int n,
+                              const ray_t &ray, const Rect &field, float *out) {
+  float cos_dir = cosf(ray.dir_rad), sin_dir = sinf(ray.dir_rad);
+  float min_x = field.min.x, min_y = field.min.y, max_x = field.max.x, max_y = field.max.y;
+
+  for (int i = 0; i < n; i++) {
+    float c = cos_rot[i];
+    float s = sin_rot[i];
+
+    // Sensor position: forward is along the rotation, right is the rotation turned 90 degrees clockwise
+    float sensor_x = x[i] + ray.y * c + ray.x * s;
+    float sensor_y = y[i] + ray.y * s - ray.x * c;
+
+    // Ray direction: the particle's rotation turned by the sensor's direction. Never exactly 0, so the division is safe
+    float dir_x = c * cos_dir - s * sin_dir;
+    float dir_y = s * cos_dir + c * sin_dir;
+    dir_x = (fabsf(dir_x) < 1e-6f) ? 1e-6f : dir_x;
+    dir_y = (fabsf(dir_y) < 1e-6f) ? 1e-6f : dir_y;
+
+    float dist_x = (((dir_x > 0) ? max_x : min_x) - sensor_x) / dir_x;
+    float dist_y = (((dir_y > 0) ? max_y : min_y) - sensor_y) / dir_y;
+    out[i] = fmaxf(fminf(dist_x, dist_y), 0.0f);
+  }
+}
+
+/**
+ * Score every particle against one distance sensor reading.
+ *
+ * The chance of the reading given a particle is a normal distribution around the distance the particle expects, mixed
+ * with a flat chance of the reading being something else entirely.
+ */
+void ParticleFilter::weigh(const ray_t &ray, float measured, float stddev, float outlier_prob) {
+  ray_cast(x.data(), y.data(), cos_rot.data(), sin_rot.data(), num_particles, ray, field, expected.data());
+
+  float inv_var = -0.5f / (stddev * stddev);
+  float hit_prob = 1.0f - outlier_prob;
+  float total = 0;
+  for (int i = 0; i < num_particles; i++) {
+    float err = expected[i] - measured;
+    weight[i] *= outlier_prob + hit_prob * expf(err * err * inv_var);
+    total += weight[i];
+  }
+
+  // Normalize, so the weights don't shrink away to nothing over many readings
+  if (total <= 0) {
+    for (int i = 0; i < num_particles; i++) {
+      weight[i] = 1.0f / num_particles;
+    }
+    return;
+  }
+  float scale = 1.0f / total;
+  for (int i = 0; i < num_particles; i++) {
+    weight[i] *= scale;
+  }
+}
+
+/**
+ * Replace the particles with a new set drawn in proportion to their weights, if too few of them carry most of the
+ * weight.
+ *
+ * Uses systematic resampling: one random offset, then evenly spaced picks along the running total of the weights.
+ * That keeps every particle with at least 1/N of the weight, and is a single pass.
+ */
+bool ParticleFilter::resample() {
+  // Effective number of particles: N if the weights are even, 1 if one particle has all of it
+  float sum_sq = 0;
+  for (int i = 0; i < num_particles; i++) {
+    sum_sq += weight[i] * weight[i];
+  }
+  if (sum_sq <= 0 || 1.0f / sum_sq > num_particles / 2.0f) {
+    return false;
+  }
+
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  float step = 1.0f / num_particles;
+  float pick = (rng_state >> 8) * (1.0f / 16777216.0f) * step;
+  float running = weight[0];
+  int src = 0;
+  for (int i = 0; i < num_particles; i++) {
+    while (pick > running && src < num_particles - 1) {
+      src++;
+      running += weight[src];
+    }
+    next_x[i] = x[src];
+    next_y[i] = y[src];
+    next_rot[i] = rot[src];
+    next_cos[i] = cos_rot[src];
+    next_sin[i] = sin_rot[src];
+    pick += step;
+  }
+
+  x.swap(next_x);
+  y.swap(next_y);
+  rot.swap(next_rot);
+  cos_rot.swap(next_cos);
+  sin_rot.swap(next_sin);
+  for (int i = 0; i < num_particles; i++) {
+    weight[i] = step;
+  }
+  return true;
+}
+
+/**
+ * Check the cloud's rotation against the wheels', once every window_in inches driven.
+ *
+ * Each window starts from the cloud's estimate, so only the drift within one window counts: the wheels' own error
+ * over a window stays small, while a cloud that has locked on to the wrong rotation keeps turning away from them.
+ * Starting over keeps the estimated position, which the walls still pin down, and takes the rotation from the wheels.
+ */
+bool ParticleFilter::check_rotation(double window_in, double max_rot_err_deg, double pos_stddev,
+                                    double rot_stddev_deg) {
+  if (window_dist < window_in) {
+    return false;
+  }
+
+  pose_t est = estimate();
+  double rot_err = remainder(est.rot - wheel_pose.rot, 360.0);
+  if (fabs(rot_err) > max_rot_err_deg) {
+    reset({est.x, est.y, wheel_pose.rot}, pos_stddev, rot_stddev_deg);
+    return true;
+  }
+
+  wheel_pose = est;
+  window_dist = 0;
+  return false;
+}
+
+/**
+ * The weighted average of the particles. Rotation is averaged as a direction, so 359 and 1 average to 0, not 180
+ */
+pose_t ParticleFilter::estimate() const {
+  double sum_x = 0, sum_y = 0, sum_cos = 0, sum_sin = 0;
+  for (int i = 0; i < num_particles; i++) {
+    sum_x += weight[i] * x[i];
+    sum_y += weight[i] * y[i];
+    sum_cos += weight[i] * cos_rot[i];
+    sum_sin += weight[i] * sin_rot[i];
+  }
+
+  double rot_deg = atan2(sum_sin, sum_cos) * (180.0 / M_PI);
+  if (rot_deg < 0) {
+    rot_deg += 360;
+  }
+  return {sum_x, sum_y, rot_deg};
+}
+
+/**
+ * The weighted standard deviation of the particles' positions
+ */
+double ParticleFilter::get_position_stddev() const {
+  pose_t mean = estimate();
+  double var = 0;
+  for (int i = 0; i < num_particles; i++) {
+    double dx = x[i] - mean.x;
+    double dy = y[i] - mean.y;
+    var += weight[i] * (dx * dx + dy * dy);
+  }
+  return sqrt(var);
+}
+
+/**
+ * @return the number of particles
+ */
+int ParticleFilter::size() const { return num_particles; }
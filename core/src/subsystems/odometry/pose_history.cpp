@@ -0,0 +1,154 @@
+#include "../core/include/subsystems/odometry/pose_history.h"
+#include "../core/include/subsystems/odometry/odometry_base.h"
+#include "../core/include/utils/math_util.h"
+
+/**
+ * Create a pose history
+ *
+ * @param capacity the most entries that will be kept
+ * @param min_interval_us the shortest time between two entries, in microseconds
+ */
+PoseHistory::PoseHistory(int capacity, uint64_t min_interval_us)
+    : buffer(capacity), head(0), count(0), min_interval_us(min_interval_us), seq(0) {}
+
+/**
+ * The i'th oldest entry. Outside of add() and clear(), only valid if seq hasn't changed since it was read
+ */
+const pose_history_entry_t &PoseHistory::entry(int i) const {
+  return buffer[(head.load(std::memory_order_relaxed) + i) % buffer.size()];
+}
+
+/**
+ * Record a new entry, overwriting the oldest if full.
+ * Ignored if it is less than min_interval_us after the newest entry.
+ *
+ * Sequence lock write: seq is odd while the buffer is being changed, so a get_at() that overlaps knows to try again.
+ */
+void PoseHistory::add(const pose_history_entry_t &new_entry) {
+  if (buffer.empty()) {
+    return;
+  }
+
+  // Only this task changes the buffer, so it can read it without checking seq
+  int n = count.load(std::memory_order_relaxed);
+  if (n > 0 && new_entry.timestamp_us < entry(n - 1).timestamp_us + min_interval_us) {
+    return;
+  }
+
+  uint32_t s = seq.load(std::memory_order_relaxed);
+  seq.store(s + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  int h = head.load(std::memory_order_relaxed);
+  if (n < (int)buffer.size()) {
+    buffer[(h + n) % buffer.size()] = new_entry;
+    count.store(n + 1, std::memory_order_relaxed);
+  } else {
+    buffer[h] = new_entry;
+    head.store((h + 1) % buffer.size(), std::memory_order_relaxed);
+  }
+
+  seq.store(s + 2, std::memory_order_release);
+}
+
+/**
+ * Forget all recorded entries
+ */
+void PoseHistory::clear() {
+  uint32_t s = seq.load(std::memory_order_relaxed);
+  seq.store(s + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  head.store(0, std::memory_order_relaxed);
+  count.store(0, std::memory_order_relaxed);
+
+  seq.store(s + 2, std::memory_order_release);
+}
+
+/**
+ * Copy out the entries around timestamp_us, without checking seq.
+ * Entries are in time order, so the pair around timestamp_us is found with a binary search.
+ *
+ * @return 0 if there is no history, 1 if clamped to before, 2 if timestamp_us is between before and after
+ */
+int PoseHistory::find(uint64_t timestamp_us, pose_history_entry_t &before, pose_history_entry_t &after) const {
+  // A count read while add() is running may not match head. The entries are still in the buffer, and seq rejects
+  // the copy
+  int n = count.load(std::memory_order_relaxed);
+  if (n <= 0) {
+    return 0;
+  }
+  if (timestamp_us <= entry(0).timestamp_us) {
+    before = entry(0);
+    return 1;
+  }
+  if (timestamp_us >= entry(n - 1).timestamp_us) {
+    before = entry(n - 1);
+    return 1;
+  }
+
+  // Find the last entry at or before timestamp_us. entry(lo) <= t < entry(hi) throughout
+  int lo = 0;
+  int hi = n - 1;
+  while (hi - lo > 1) {
+    int mid = (lo + hi) / 2;
+    if (entry(mid).timestamp_us <= timestamp_us) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  before = entry(lo);
+  after = entry(hi);
+  return 2;
+}
+
+/**
+ * Find the odometry state at a point in the past, linearly interpolating between the two entries around it.
+ * Times before the oldest entry or after the newest are clamped to that entry.
+ *
+ * Sequence lock read: if seq reads the same even value before and after the search, add() didn't change the buffer
+ * partway through it. Otherwise search again.
+ */
+bool PoseHistory::get_at(uint64_t timestamp_us, pose_history_entry_t &out) {
+  pose_history_entry_t before, after;
+  int found;
+  while (true) {
+    uint32_t seq_before = seq.load(std::memory_order_acquire);
+    found = find(timestamp_us, before, after);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint32_t seq_after = seq.load(std::memory_order_relaxed);
+
+    if (seq_before == seq_after && (seq_before & 1) == 0) {
+      break;
+    }
+    // The odometry task is partway through adding an entry. Let it finish
+    vex::this_thread::yield();
+  }
+
+  if (found == 0) {
+    return false;
+  }
+  if (found == 1) {
+    out = before;
+    return timestamp_us == before.timestamp_us;
+  }
+
+  double t = (double)(timestamp_us - before.timestamp_us) / (double)(after.timestamp_us - before.timestamp_us);
+
+  // Interpolate rotation the short way around, in case it wrapped between the two entries
+  double rot_change = OdometryBase::smallest_angle(before.pos.rot, after.pos.rot);
+
+  out.timestamp_us = timestamp_us;
+  out.pos.x = lerp(before.pos.x, after.pos.x, t);
+  out.pos.y = lerp(before.pos.y, after.pos.y, t);
+  out.pos.rot = wrap_angle_deg(before.pos.rot + rot_change * t);
+  out.speed = lerp(before.speed, after.speed, t);
+  out.ang_speed_deg = lerp(before.ang_speed_deg, after.ang_speed_deg, t);
+  return true;
+}
+
+/**
+ * @return the number of entries currently recorded
+ */
+int PoseHistory::size() { return count.load(std::memory_order_acquire); }
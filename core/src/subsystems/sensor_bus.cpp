@@ -0,0 +1,189 @@
+#include "../core/include/subsystems/sensor_bus.h"
+#include <stdio.h>
+
+/**
+ * Create the sensor bus and start reading in the background
+ *
+ * @param period_ms how often to read every sensor, in milliseconds
+ * @param use_snapshots false to skip the snapshots and read the device on every get(), for comparison
+ */
+SensorBus::SensorBus(uint32_t period_ms, bool use_snapshots)
+    : period_ms(period_ms), use_snapshots(use_snapshots), num_channels(0), seq(0), buffers(), reads(0),
+      reads_per_sec(0) {
+  handle = new vex::task(background_task, (void *)this);
+}
+
+/**
+ * Function that runs in the background task. Samples once per period, holding the period steady however long the
+ * reads take, and updates the reads per second once a second.
+ *
+ * @param ptr Pointer to SensorBus object
+ * @return Required integer return code. Unused.
+ */
+int SensorBus::background_task(void *ptr) {
+  SensorBus &bus = *((SensorBus *)ptr);
+
+  uint32_t next_ms = vex::timer::system();
+  uint32_t window_start_ms = next_ms;
+  uint32_t window_start_reads = 0;
+
+  while (!bus.end_task) {
+    if (bus.use_snapshots) {
+      bus.sample();
+    }
+
+    uint32_t now_ms = vex::timer::system();
+    if (now_ms - window_start_ms >= 1000) {
+      uint32_t total = bus.reads.load(std::memory_order_relaxed);
+      bus.reads_per_sec.store((uint64_t)(total - window_start_reads) * 1000 / (now_ms - window_start_ms),
+                              std::memory_order_relaxed);
+      window_start_ms = now_ms;
+      window_start_reads = total;
+    }
+
+    // Fall behind rather than try to catch up if a read stalled for more than a period
+    next_ms += bus.period_ms;
+    if ((int32_t)(next_ms - now_ms) > 0) {
+      vexDelay(next_ms - now_ms);
+    } else {
+      next_ms = now_ms;
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * Stop reading sensors in the background. Cannot be restarted.
+ */
+void SensorBus::end_async() { end_task = true; }
+
+/**
+ * Add a sensor value to every snapshot from now on
+ */
+int SensorBus::add_channel(std::function<double()> read) {
+  int channel = num_channels.load(std::memory_order_relaxed);
+  if (channel >= MAX_CHANNELS) {
+    fprintf(stderr, "SensorBus::add_channel - all %d channels are in use\n", MAX_CHANNELS);
+    return -1;
+  }
+
+  readers[channel] = read;
+  // Let the bus task see the reader only once it's fully written
+  num_channels.store(channel + 1, std::memory_order_release);
+  return channel;
+}
+
+/**
+ * Read every channel now and publish the snapshot.
+ *
+ * Writes into the buffer the latest snapshot isn't in, between marking the sequence odd and even again. Readers of the
+ * latest snapshot are undisturbed; only one still copying the snapshot before it, 2 periods late, has to retry.
+ */
+void SensorBus::sample() {
+  int count = num_channels.load(std::memory_order_acquire);
+  uint32_t s = seq.load(std::memory_order_relaxed);
+  sensor_snapshot_t &next = buffers[((s / 2) + 1) % 2];
+
+  seq.store(s + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  next.timestamp_us = vex::timer::systemHighResolution();
+  next.tick = (s / 2) + 1;
+  next.num_channels = count;
+  for (int i = 0; i < count; i++) {
+    next.values[i] = readers[i]();
+  }
+
+  seq.store(s + 2, std::memory_order_release);
+  reads.fetch_add(count, std::memory_order_relaxed);
+}
+
+/**
+ * Gets every channel from the same read, without blocking the bus task.
+ *
+ * The latest snapshot is only overwritten once the writer starts on the one after next, which it marks by moving the
+ * sequence 3 past where it was. If the sequence moved less than that during the copy, the copy wasn't torn.
+ */
+SensorBus::sensor_snapshot_t SensorBus::get_snapshot() {
+  sensor_snapshot_t out;
+  while (true) {
+    uint32_t before = seq.load(std::memory_order_acquire);
+    out = buffers[(before / 2) % 2];
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint32_t after = seq.load(std::memory_order_relaxed);
+
+    if (after - (before & ~1u) < 3) {
+      return out;
+    }
+    // The bus task lapped this copy. Try again with the newer snapshot
+  }
+}
+
+/**
+ * Gets one channel's latest value, the same way get_snapshot() does but copying only the one value
+ */
+double SensorBus::get(int channel) {
+  if (channel < 0 || channel >= num_channels.load(std::memory_order_acquire)) {
+    fprintf(stderr, "SensorBus::get - no channel %d\n", channel);
+    return 0;
+  }
+
+  while (use_snapshots) {
+    uint32_t before = seq.load(std::memory_order_acquire);
+    const sensor_snapshot_t &latest = buffers[(before / 2) % 2];
+    int sampled = latest.num_channels;
+    double value = latest.values[channel];
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint32_t after = seq.load(std::memory_order_relaxed);
+
+    if (after - (before & ~1u) >= 3) {
+      continue;
+    }
+    if (channel < sampled) {
+      return value;
+    }
+    // Added since the last snapshot, so there's nothing to return yet
+    break;
+  }
+
+  reads.fetch_add(1, std::memory_order_relaxed);
+  return readers[channel]();
+}
+
+/**
+ * How many device reads were made in the last whole second
+ */
+uint32_t SensorBus::get_reads_per_sec() const { return reads_per_sec.load(std::memory_order_relaxed); }
+
+/**
+ * @return how often every sensor is read, in milliseconds
+ */
+uint32_t SensorBus::get_period_ms() const { return period_ms; }
+
+/**
+ * Create the channel
+ * @param read reads the device and returns its value
+ */
+SensorChannel::SensorChannel(std::function<double()> read) : read(read) {}
+
+/**
+ * Read the value through a sensor bus from now on
+ */
+void SensorChannel::use_sensor_bus(SensorBus &bus) {
+  int new_channel = bus.add_channel(read);
+  if (new_channel >= 0) {
+    channel = new_channel;
+    this->bus = &bus;
+  }
+}
+
+/**
+ * Gets the latest value
+ */
+double SensorChannel::get() const {
+  if (bus == NULL) {
+    return read();
+  }
+  return bus->get(channel);
+}
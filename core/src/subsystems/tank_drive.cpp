@@ -5,12 +5,22 @@
 #include "../core/include/utils/math_util.h"
 
 TankDrive::TankDrive(motor_group &left_motors, motor_group &right_motors, robot_specs_t &config, OdometryBase *odom)
-    : left_motors(left_motors), right_motors(right_motors), correction_pid(config.correction_pid), odometry(odom),
-      config(config) {
+    : left_motors(left_motors), right_motors(right_motors),
+      left_vel([&left_motors]() { return left_motors.velocity(vex::velocityUnits::pct); }),
+      right_vel([&right_motors]() { return right_motors.velocity(vex::velocityUnits::pct); }),
+      correction_pid(config.correction_pid), odometry(odom), config(config) {
   drive_default_feedback = config.drive_feedback;
   turn_default_feedback = config.turn_feedback;
 }
 
+/**
+ * Read the drive motors' velocities through a sensor bus from now on, instead of from the motors
+ */
+void TankDrive::use_sensor_bus(SensorBus &bus) {
+  left_vel.use_sensor_bus(bus);
+  right_vel.use_sensor_bus(bus);
+}
+
 AutoCommand *TankDrive::DriveToPointCmd(Feedback &fb, point_t pt, vex::directionType dir, double max_speed,
                                         double end_speed) {
   return new DriveToPointCommand(*this, fb, pt, dir, max_speed, end_speed);
@@ -72,13 +82,34 @@ AutoCommand *TankDrive::TurnDegreesCmd(double degrees, double max_speed, double
 AutoCommand *TankDrive::TurnDegreesCmd(Feedback &fb, double degrees, double max_speed, double end_speed) {
   return new TurnDegreesCommand(*this, fb, degrees, max_speed, end_speed);
 }
-AutoCommand *TankDrive::PurePursuitCmd(PurePursuit::Path path, directionType dir, double max_speed, double end_speed) {
+AutoCommand *TankDrive::PurePursuitCmd(const PurePursuit::Path &path, directionType dir, double max_speed,
+                                       double end_speed) {
   return new PurePursuitCommand(*this, *drive_default_feedback, path, dir, max_speed, end_speed);
 }
-AutoCommand *TankDrive::PurePursuitCmd(Feedback &feedback, PurePursuit::Path path, directionType dir, double max_speed,
-                                       double end_speed) {
+AutoCommand *TankDrive::PurePursuitCmd(Feedback &feedback, const PurePursuit::Path &path, directionType dir,
+                                       double max_speed, double end_speed) {
   return new PurePursuitCommand(*this, feedback, path, dir, max_speed, end_speed);
 }
+AutoCommand *TankDrive::PurePursuitCmd(const PurePursuit::Path &path,
+                                       PurePursuit::adaptive_lookahead_cfg_t lookahead_cfg, directionType dir,
+                                       double max_speed, double end_speed) {
+  return new PurePursuitCommand(*this, *drive_default_feedback, path, lookahead_cfg, dir, max_speed, end_speed);
+}
+AutoCommand *TankDrive::PurePursuitCmd(Feedback &feedback, const PurePursuit::Path &path,
+                                       PurePursuit::adaptive_lookahead_cfg_t lookahead_cfg, directionType dir,
+                                       double max_speed, double end_speed) {
+  return new PurePursuitCommand(*this, feedback, path, lookahead_cfg, dir, max_speed, end_speed);
+}
+AutoCommand *TankDrive::PurePursuitCmd(const PurePursuit::Path &path,
+                                       PurePursuit::VelocityProfile::velocity_profile_cfg_t profile_cfg,
+                                       FeedForward &ff, PID &progress_pid, directionType dir, double end_vel) {
+  return new ProfiledPurePursuitCommand(*this, path, profile_cfg, ff, progress_pid, dir, end_vel);
+}
+AutoCommand *TankDrive::RamseteCmd(const PurePursuit::Path &path,
+                                   PurePursuit::VelocityProfile::velocity_profile_cfg_t profile_cfg, FeedForward &ff,
+                                   ramsete_cfg_t ramsete_cfg, directionType dir, double end_vel) {
+  return new RamseteCommand(*this, path, profile_cfg, ff, ramsete_cfg, dir, end_vel);
+}
 
 Condition *TankDrive::DriveStalledCondition(double stall_time) {
   class DriveStalledCondition : public Condition {
@@ -129,6 +160,7 @@ void TankDrive::reset_auto() { func_initialized = false; }
 void TankDrive::stop() {
   left_motors.stop();
   right_motors.stop();
+  carried_vel = 0;
 }
 
 void TankDrive::drive_tank_raw(double left_norm, double right_norm) {
@@ -163,7 +195,7 @@ void TankDrive::drive_tank(double left, double right, int power, BrakeType bt) {
 
   if (bt == BrakeType::ZeroVelocity) {
     zero_vel_pid.set_target(0);
-    double vel = left_motors.velocity(vex::velocityUnits::pct) + right_motors.velocity(vex::velocityUnits::pct);
+    double vel = left_vel.get() + right_vel.get();
     double outp = zero_vel_pid.update(vel);
     left_motors.spin(directionType::fwd, outp, voltageUnits::volt);
     right_motors.spin(directionType::fwd, outp, voltageUnits::volt);
@@ -368,9 +400,13 @@ bool TankDrive::drive_to_point(double x, double y, vex::directionType dir, Feedb
 
     double initial_dist = OdometryBase::pos_diff(odometry->get_position(), {.x = x, .y = y});
 
+    // Start at the speed the last drive ended at, so chained drives don't stop in between
+    double start_vel = (dir == directionType::rev) ? -carried_vel : carried_vel;
+    double end_vel = fabs(end_speed) * config.drive_max_vel;
+
     // Reset the control loops
     correction_pid.init(0, 0);
-    feedback.init(-initial_dist, 0);
+    feedback.init(-initial_dist, 0, start_vel, end_vel);
 
     correction_pid.set_limits(-1, 1);
     feedback.set_limits(-1, 1);
@@ -464,6 +500,9 @@ bool TankDrive::drive_to_point(double x, double y, vex::directionType dir, Feedb
   if (feedback.is_on_target()) {
     if (end_speed == 0) {
       stop();
+    } else {
+      // Carry the speed the robot actually reached, which is less than end_speed if the drive was too short for it
+      carried_vel = ((dir == directionType::rev) ? -1 : 1) * odometry->get_speed();
     }
     func_initialized = false;
     return true;
@@ -588,9 +627,46 @@ double TankDrive::modify_inputs(double input, int power) { return sign(input) *
  * @param max_speed Limit the speed of the robot (for pid / pidff feedbacks)
  * @return True when the path is complete
  */
-bool TankDrive::pure_pursuit(PurePursuit::Path path, directionType dir, Feedback &feedback, double max_speed,
+bool TankDrive::pure_pursuit(const PurePursuit::Path &path, directionType dir, Feedback &feedback, double max_speed,
                              double end_speed) {
-  std::vector<point_t> points = path.get_points();
+  return pure_pursuit(path, lookahead_tracker, dir, feedback, max_speed, end_speed);
+}
+
+/**
+ * Drive the robot autonomously using a pure-pursuit algorithm, keeping the lookahead search state in a
+ * caller-owned tracker. The tracker is reset when a new movement starts.
+ *
+ * @param path The list of coordinates to follow, in order
+ * @param tracker Lookahead search state for this path
+ * @param dir Run the bot forwards or backwards
+ * @param feedback The feedback controller determining speed
+ * @param max_speed Limit the speed of the robot (for pid / pidff feedbacks)
+ * @return True when the path is complete
+ */
+bool TankDrive::pure_pursuit(const PurePursuit::Path &path, PurePursuit::LookaheadTracker &tracker, directionType dir,
+                             Feedback &feedback, double max_speed, double end_speed) {
+  // A fixed radius is an adaptive radius that can't change
+  PurePursuit::adaptive_lookahead_cfg_t fixed_radius = {path.get_radius(), path.get_radius(), 0, 0};
+  return pure_pursuit(path, tracker, fixed_radius, dir, feedback, max_speed, end_speed);
+}
+
+/**
+ * Drive the robot autonomously using a pure-pursuit algorithm, choosing the lookahead radius every update from
+ * the robot's speed and the curvature of the path ahead instead of using the path's fixed radius.
+ * The tracker is reset when a new movement starts.
+ *
+ * @param path The list of coordinates to follow, in order
+ * @param tracker Lookahead search state for this path
+ * @param lookahead_cfg Limits and gains for the lookahead radius
+ * @param dir Run the bot forwards or backwards
+ * @param feedback The feedback controller determining speed
+ * @param max_speed Limit the speed of the robot (for pid / pidff feedbacks)
+ * @return True when the path is complete
+ */
+bool TankDrive::pure_pursuit(const PurePursuit::Path &path, PurePursuit::LookaheadTracker &tracker,
+                             const PurePursuit::adaptive_lookahead_cfg_t &lookahead_cfg, directionType dir,
+                             Feedback &feedback, double max_speed, double end_speed) {
+  const std::vector<point_t> &points = path.get_points();
   if (!path.is_valid()) {
     printf("WARNING: Unexpected pure pursuit path - some segments intersect or are too close\n");
   }
@@ -599,22 +675,26 @@ bool TankDrive::pure_pursuit(PurePursuit::Path path, directionType dir, Feedback
   // On function initialization, send the path-length estimate to the feedback controller
   if (!func_initialized) {
     if (dir != directionType::rev) {
-      feedback.init(-estimate_path_length(points), 0);
+      feedback.init(-path.get_length(), 0);
     } else {
-      feedback.init(estimate_path_length(points), 0);
+      feedback.init(path.get_length(), 0);
     }
+    tracker.reset();
 
     func_initialized = true;
   }
 
-  point_t lookahead = PurePursuit::get_lookahead(points, odometry->get_position(), path.get_radius());
+  double radius = PurePursuit::adaptive_lookahead_radius(path, tracker.get_segment(), odometry->get_speed(),
+                                                         lookahead_cfg);
+  point_t lookahead = tracker.get_lookahead(points, robot_pose, radius);
   point_t localized = lookahead - robot_pose.get_point();
 
   point_t last_point = points[points.size() - 1];
   bool is_last_point = (lookahead == last_point);
 
   double correction = 0;
-  double dist_remaining = PurePursuit::estimate_remaining_dist(points, robot_pose, path.get_radius());
+  double dist_remaining =
+      PurePursuit::estimate_remaining_dist(path, robot_pose, lookahead, tracker.get_segment(), radius);
   double angle_diff = 0;
 
   // Robot is facing forwards / backwards, change the bot's angle by 180
@@ -670,6 +750,188 @@ bool TankDrive::pure_pursuit(PurePursuit::Path path, directionType dir, Feedback
  * @param max_speed Limit the speed of the robot (for pid / pidff feedbacks)
  * @return True when the path is complete
  */
-bool TankDrive::pure_pursuit(PurePursuit::Path path, directionType dir, double max_speed, double end_speed) {
+bool TankDrive::pure_pursuit(const PurePursuit::Path &path, directionType dir, double max_speed, double end_speed) {
   return pure_pursuit(path, dir, *config.drive_feedback, max_speed, end_speed);
-}
\ No newline at end of file
+}
+
+/**
+ * Drive the robot along a path at the velocities planned by a velocity profile.
+ *
+ * The robot steers toward the pure pursuit lookahead point by splitting the profile's velocity and acceleration
+ * into left and right wheel targets for the curvature of the arc to that point, and turns each into a motor output
+ * with the feedforward. A PID on distance along the path corrects for falling behind or getting ahead of the profile.
+ *
+ * @param path The list of coordinates to follow, in order
+ * @param profile Velocities to drive the path at. Must have been generated from this path
+ * @param tracker Lookahead search state for this path
+ * @param dir Run the bot forwards or backwards
+ * @param ff Feedforward turning wheel velocity (inch/s) and acceleration (inch/s^2) into motor outputs
+ * @param progress_pid PID on distance along the path (inches)
+ * @return True when the profile has finished and the PID reports on target
+ */
+bool TankDrive::pure_pursuit(const PurePursuit::Path &path, const PurePursuit::VelocityProfile &profile,
+                             PurePursuit::LookaheadTracker &tracker, directionType dir, FeedForward &ff,
+                             PID &progress_pid) {
+  // We can't run the auto drive function without odometry
+  if (odometry == NULL) {
+    fprintf(stderr, "Odometry is NULL. Unable to run pure_pursuit()\n");
+    fflush(stderr);
+    return true;
+  }
+
+  const std::vector<point_t> &points = path.get_points();
+  if (points.empty()) {
+    return true;
+  }
+
+  if (!func_initialized) {
+    if (!path.is_valid()) {
+      printf("WARNING: Unexpected pure pursuit path - some segments intersect or are too close\n");
+    }
+    tracker.reset();
+    progress_pid.reset();
+    profile_tmr.reset();
+
+    func_initialized = true;
+  }
+
+  pose_t robot_pose = odometry->get_position();
+  point_t lookahead = tracker.get_lookahead(points, robot_pose, path.get_radius());
+  double dist_remaining =
+      PurePursuit::estimate_remaining_dist(path, robot_pose, lookahead, tracker.get_segment(), path.get_radius());
+
+  // Where the profile says we should be right now, and how far off we are
+  motion_t target = profile.calculate(profile_tmr.time(sec));
+  progress_pid.set_target(target.pos);
+  progress_pid.update(path.get_length() - dist_remaining, target.vel);
+
+  // Curvature of the arc from the robot to the lookahead point, in the direction of travel: 2 * lateral offset / L^2
+  double heading = deg2rad(robot_pose.rot);
+  if (dir == directionType::rev) {
+    heading += PI;
+  }
+  point_t localized = lookahead - robot_pose.get_point();
+  double lateral = (-sin(heading) * localized.x) + (cos(heading) * localized.y);
+  double dist_sq = (localized.x * localized.x) + (localized.y * localized.y);
+
+  double curvature = 0;
+  point_t last_point = points.back();
+  bool is_last_point = (lookahead == last_point);
+  // Stop steering when we're almost at the end, otherwise tiny offsets make huge curvatures
+  if (dist_sq > 0 && !(is_last_point && robot_pose.get_point().dist(last_point) < config.drive_correction_cutoff)) {
+    curvature = 2 * lateral / dist_sq;
+  }
+
+  // Split the forward motion between the sides: the outside of the turn travels further
+  double half_track = config.dist_between_wheels / 2.0;
+  double inner_scale = 1 - (curvature * half_track);
+  double outer_scale = 1 + (curvature * half_track);
+
+  double pid_out = progress_pid.get();
+  double left = ff.calculate(target.vel * inner_scale, target.accel * inner_scale, pid_out) + pid_out;
+  double right = ff.calculate(target.vel * outer_scale, target.accel * outer_scale, pid_out) + pid_out;
+
+  // Driving backwards, the robot's physical left side is on the right of the direction of travel
+  if (dir == directionType::rev) {
+    double tmp = left;
+    left = -right;
+    right = -tmp;
+  }
+
+  drive_tank(left, right);
+
+  if (profile_tmr.time(sec) > profile.get_movement_time() && progress_pid.is_on_target()) {
+    func_initialized = false;
+    if (profile.get_velocities().back() == 0) {
+      stop();
+    }
+    return true;
+  }
+  return false;
+}
+
+/**
+ * Follow a timed trajectory (a path and a velocity profile along it) with the Ramsete controller.
+ *
+ * Each update, the profile gives where the robot should be on the path right now, and how fast it should be
+ * moving and turning there. The position and heading error to that target, in the robot's frame, are fed back
+ * into the forward and turning velocities, which are split into wheel velocities and turned into motor outputs with
+ * the feedforward.
+ *
+ * @param path The list of coordinates to follow, in order
+ * @param profile Velocities to drive the path at. Must have been generated from this path
+ * @param dir Run the bot forwards or backwards
+ * @param ff Feedforward turning wheel velocity (inch/s) and acceleration (inch/s^2) into motor outputs
+ * @param cfg Ramsete gains
+ * @return True when the profile has finished
+ */
+bool TankDrive::ramsete(const PurePursuit::Path &path, const PurePursuit::VelocityProfile &profile,
+                        directionType dir, FeedForward &ff, ramsete_cfg_t cfg) {
+  // We can't run the auto drive function without odometry
+  if (odometry == NULL) {
+    fprintf(stderr, "Odometry is NULL. Unable to run ramsete()\n");
+    fflush(stderr);
+    return true;
+  }
+
+  if (path.get_points().size() < 2) {
+    return true;
+  }
+
+  if (!func_initialized) {
+    profile_tmr.reset();
+    func_initialized = true;
+  }
+
+  // Where the trajectory says we should be right now
+  motion_t target = profile.calculate(profile_tmr.time(sec));
+  point_t target_pt = path.point_at(target.pos);
+  double target_heading = path.heading_at(target.pos);
+  double target_curvature = path.curvature_at(target.pos);
+  double target_ang_vel = target.vel * target_curvature;
+  // Turning speeds up with the speed along the path and with the curvature changing under it: d(v * k)/dt is
+  // a * k + v^2 * dk/ds. Leaving out the second part makes the robot lag into every curve
+  const double ds = 1.0;
+  double dcurvature = (path.curvature_at(target.pos + ds) - path.curvature_at(target.pos - ds)) / (2 * ds);
+  double target_ang_accel = (target.accel * target_curvature) + (target.vel * target.vel * dcurvature);
+
+  // Error to the target in the robot's frame, facing the direction of travel
+  pose_t robot_pose = odometry->get_position();
+  double heading = deg2rad(robot_pose.rot);
+  if (dir == directionType::rev) {
+    heading += PI;
+  }
+  point_t err = target_pt - robot_pose.get_point();
+  double err_x = (cos(heading) * err.x) + (sin(heading) * err.y);
+  double err_y = (-sin(heading) * err.x) + (cos(heading) * err.y);
+  double err_heading = deg2rad(OdometryBase::smallest_angle(rad2deg(heading), rad2deg(target_heading)));
+
+  // Ramsete control law
+  double k = 2 * cfg.zeta * sqrt((target_ang_vel * target_ang_vel) + (cfg.b * target.vel * target.vel));
+  double sinc = fabs(err_heading) < 1e-9 ? 1.0 : sin(err_heading) / err_heading;
+  double vel = (target.vel * cos(err_heading)) + (k * err_x);
+  double ang_vel = target_ang_vel + (k * err_heading) + (cfg.b * target.vel * sinc * err_y);
+
+  // Split into wheel velocities: the outside of the turn travels further
+  double half_track = config.dist_between_wheels / 2.0;
+  double left = ff.calculate(vel - (ang_vel * half_track), target.accel - (target_ang_accel * half_track));
+  double right = ff.calculate(vel + (ang_vel * half_track), target.accel + (target_ang_accel * half_track));
+
+  // Driving backwards, the robot's physical left side is on the right of the direction of travel
+  if (dir == directionType::rev) {
+    double tmp = left;
+    left = -right;
+    right = -tmp;
+  }
+
+  drive_tank(left, right);
+
+  if (profile_tmr.time(sec) > profile.get_movement_time()) {
+    func_initialized = false;
+    if (profile.get_velocities().back() == 0) {
+      stop();
+    }
+    return true;
+  }
+  return false;
+}
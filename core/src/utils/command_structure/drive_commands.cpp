@@ -30,7 +30,13 @@
  */
 DriveForwardCommand::DriveForwardCommand(TankDrive &drive_sys, Feedback &feedback, double inches, directionType dir,
                                          double max_speed, double end_speed)
-    : drive_sys(drive_sys), feedback(feedback), inches(inches), dir(dir), max_speed(max_speed), end_speed(end_speed) {}
+    : drive_sys(drive_sys), feedback(feedback), inches(inches), dir(dir), max_speed(max_speed), end_speed(end_speed) {
+  // Plan the movement now rather than when it starts. Movements that end moving are planned when they start, from
+  // however fast the robot is going then
+  if (end_speed == 0) {
+    feedback.precompute(inches);
+  }
+}
 
 /**
  * Run drive_forward
@@ -56,7 +62,10 @@ void DriveForwardCommand::on_timeout() {
  */
 TurnDegreesCommand::TurnDegreesCommand(TankDrive &drive_sys, Feedback &feedback, double degrees, double max_speed,
                                        double end_speed)
-    : drive_sys(drive_sys), feedback(feedback), degrees(degrees), max_speed(max_speed), end_speed(end_speed) {}
+    : drive_sys(drive_sys), feedback(feedback), degrees(degrees), max_speed(max_speed), end_speed(end_speed) {
+  // Plan the movement now rather than when it starts
+  feedback.precompute(degrees);
+}
 
 /**
  * Run turn_degrees
@@ -145,14 +154,33 @@ void TurnToHeadingCommand::on_timeout() {
  * @param feedback The feedback controller determining speed
  * @param max_speed Limit the speed of the robot (for pid / pidff feedbacks)
  */
-PurePursuitCommand::PurePursuitCommand(TankDrive &drive_sys, Feedback &feedback, PurePursuit::Path path,
+PurePursuitCommand::PurePursuitCommand(TankDrive &drive_sys, Feedback &feedback, const PurePursuit::Path &path,
                                        directionType dir, double max_speed, double end_speed)
-    : drive_sys(drive_sys), path(path), dir(dir), feedback(feedback), max_speed(max_speed), end_speed(end_speed) {}
+    : drive_sys(drive_sys), path(path), lookahead_cfg({path.get_radius(), path.get_radius(), 0, 0}), dir(dir),
+      feedback(feedback), max_speed(max_speed), end_speed(end_speed) {}
+
+/**
+ * Construct a Pure Pursuit AutoCommand that picks its lookahead radius every update from the robot's speed and
+ * the curvature of the path ahead, instead of using the path's fixed radius
+ *
+ * @param path The list of coordinates to follow, in order
+ * @param lookahead_cfg Limits and gains for the lookahead radius
+ * @param dir Run the bot forwards or backwards
+ * @param feedback The feedback controller determining speed
+ * @param max_speed Limit the speed of the robot (for pid / pidff feedbacks)
+ */
+PurePursuitCommand::PurePursuitCommand(TankDrive &drive_sys, Feedback &feedback, const PurePursuit::Path &path,
+                                       PurePursuit::adaptive_lookahead_cfg_t lookahead_cfg, directionType dir,
+                                       double max_speed, double end_speed)
+    : drive_sys(drive_sys), path(path), lookahead_cfg(lookahead_cfg), dir(dir), feedback(feedback),
+      max_speed(max_speed), end_speed(end_speed) {}
 
 /**
  * Direct call to TankDrive::pure_pursuit
  */
-bool PurePursuitCommand::run() { return drive_sys.pure_pursuit(path, dir, feedback, max_speed, end_speed); }
+bool PurePursuitCommand::run() {
+  return drive_sys.pure_pursuit(path, tracker, lookahead_cfg, dir, feedback, max_speed, end_speed);
+}
 
 /**
  * Reset the drive system when it times out
@@ -162,6 +190,65 @@ void PurePursuitCommand::on_timeout() {
   drive_sys.reset_auto();
 }
 
+/**
+ * Construct a profiled Pure Pursuit AutoCommand. The velocity profile is generated here, not when the command runs.
+ *
+ * @param path The list of coordinates to follow, in order
+ * @param profile_cfg Velocity and acceleration limits for the profile
+ * @param ff Feedforward turning wheel velocity and acceleration into motor outputs
+ * @param progress_pid PID on distance along the path
+ * @param dir Run the bot forwards or backwards
+ * @param end_vel Velocity to be travelling at when the path ends (inch/s)
+ */
+ProfiledPurePursuitCommand::ProfiledPurePursuitCommand(TankDrive &drive_sys, const PurePursuit::Path &path,
+                                                       PurePursuit::VelocityProfile::velocity_profile_cfg_t profile_cfg,
+                                                       FeedForward &ff, PID &progress_pid, directionType dir,
+                                                       double end_vel)
+    : drive_sys(drive_sys), path(path), profile(path, profile_cfg, 0, end_vel), ff(ff), progress_pid(progress_pid),
+      dir(dir) {}
+
+/**
+ * Direct call to TankDrive::pure_pursuit
+ */
+bool ProfiledPurePursuitCommand::run() { return drive_sys.pure_pursuit(path, profile, tracker, dir, ff, progress_pid); }
+
+/**
+ * Reset the drive system when it times out
+ */
+void ProfiledPurePursuitCommand::on_timeout() {
+  drive_sys.stop();
+  drive_sys.reset_auto();
+}
+
+/**
+ * Construct a Ramsete AutoCommand. The velocity profile is generated here, not when the command runs.
+ *
+ * @param path The list of coordinates to follow, in order
+ * @param profile_cfg Velocity and acceleration limits for the profile
+ * @param ff Feedforward turning wheel velocity and acceleration into motor outputs
+ * @param ramsete_cfg Ramsete gains
+ * @param dir Run the bot forwards or backwards
+ * @param end_vel Velocity to be travelling at when the path ends (inch/s)
+ */
+RamseteCommand::RamseteCommand(TankDrive &drive_sys, const PurePursuit::Path &path,
+                               PurePursuit::VelocityProfile::velocity_profile_cfg_t profile_cfg, FeedForward &ff,
+                               TankDrive::ramsete_cfg_t ramsete_cfg, directionType dir, double end_vel)
+    : drive_sys(drive_sys), path(path), profile(path, profile_cfg, 0, end_vel), ff(ff), ramsete_cfg(ramsete_cfg),
+      dir(dir) {}
+
+/**
+ * Direct call to TankDrive::ramsete
+ */
+bool RamseteCommand::run() { return drive_sys.ramsete(path, profile, dir, ff, ramsete_cfg); }
+
+/**
+ * Reset the drive system when it times out
+ */
+void RamseteCommand::on_timeout() {
+  drive_sys.stop();
+  drive_sys.reset_auto();
+}
+
 /**
  * Construct a DriveStop Command
  * @param drive_sys the drive system we are commanding
@@ -180,6 +267,27 @@ bool DriveStopCommand::run() {
   return true;
 }
 
+// ==== MECANUM ====
+
+/**
+ * Construct a MecanumDriveToPose Command
+ * @param drive_sys the drive system we are commanding. Must have been given odometry
+ * @param target where to end up on the field
+ * @param max_speed the maximum speed to drive and turn at, 0 -> 1
+ */
+MecanumDriveToPoseCommand::MecanumDriveToPoseCommand(MecanumDrive &drive_sys, pose_t target, double max_speed)
+    : drive_sys(drive_sys), target(target), max_speed(max_speed) {}
+
+/**
+ * Direct call to MecanumDrive::auto_drive_to_pose
+ */
+bool MecanumDriveToPoseCommand::run() { return drive_sys.auto_drive_to_pose(target, max_speed); }
+
+/**
+ * Reset the drive system when it times out
+ */
+void MecanumDriveToPoseCommand::on_timeout() { drive_sys.reset_auto(); }
+
 // ==== ODOMETRY ====
 /**
  * Construct an Odometry set pos
@@ -8,24 +8,89 @@
  * @param config The definition of how the robot is able to move
  *    max_v Maximum velocity the movement is capable of
  *    accel Acceleration / deceleration of the movement
+ *    jerk Rate of change of acceleration, or 0 for a trapezoid profile
  *    pid_cfg Definitions of kP, kI, and kD
  *    ff_cfg Definitions of kS, kV, and kA
  */
 MotionController::MotionController(m_profile_cfg_t &config)
-    : config(config), pid(config.pid_cfg), ff(config.ff_cfg), profile(config.max_v, config.accel) {}
+    : config(config), pid(config.pid_cfg), ff(config.ff_cfg), trapezoid(config.max_v, config.accel),
+      scurve(config.max_v, config.accel, config.jerk), moving(config.max_v, config.accel, config.jerk) {
+  if (config.jerk > 0) {
+    profile = &scurve;
+  } else {
+    profile = &trapezoid;
+  }
+}
 
 /**
  * @brief Initialize the motion profile for a new movement
  * This will also reset the PID and profile timers.
  * @param start_pt Movement starting position
  * @param end_pt Movement ending posiiton
+ * @param start_vel Movement starting velocity
+ * @param end_vel Movement ending velocity
  */
-void MotionController::init(double start_pt, double end_pt) {
-  profile.set_endpts(start_pt, end_pt);
-  pid.reset();
+void MotionController::init(double start_pt, double end_pt, double start_vel, double end_vel) {
+  use_moving = (start_vel != 0 || end_vel != 0);
+  if (use_moving) {
+    // Coming in faster than the robot can slow down from in the distance would overshoot end_pt. Plan from the
+    // fastest start that still reaches end_vel in time; the PID catches up the difference. A jerk limit takes a little
+    // longer to slow down than this allows for, and the profile slows down the whole way to make up the rest
+    double dir = (end_pt < start_pt) ? -1 : 1;
+    double max_start_vel = sqrt(end_vel * end_vel + 2 * config.accel * fabs(end_pt - start_pt));
+    if (dir * start_vel > max_start_vel) {
+      start_vel = dir * max_start_vel;
+    }
+
+    moving.set_endpts(start_pt, end_pt);
+    moving.set_vel_endpts(start_vel, end_vel);
+  } else {
+    double distance = end_pt - start_pt;
+    active = &table_for(distance);
+    active_start = start_pt;
+    // A table within tolerance of the distance is stretched to fit, so the movement still ends exactly at end_pt
+    active_scale = (active == &stationary) ? 0 : distance / active->get_distance();
+  }
+
+  pid.init(start_pt, end_pt, start_vel, end_vel);
   tmr.reset();
 }
 
+/**
+ * Sample the profile for a movement of this length now, so init() can use it without building it
+ */
+void MotionController::precompute(double distance) { table_for(distance); }
+
+/**
+ * Find a kept table for a movement of about this length, or build one in place of the oldest.
+ * Tables within half a percent are close enough: stretching one that far changes the velocities by as much.
+ */
+const ProfileTable &MotionController::table_for(double distance) {
+  // Sample at the rate the control loops run
+  const double dt = 0.01;
+  double length = fabs(distance);
+  double tolerance = fmax(0.005 * length, 1e-3);
+  if (length == 0) {
+    return stationary;
+  }
+
+  for (int i = 0; i < NUM_TABLES; i++) {
+    double table_length = tables[i].get_distance();
+    if (table_length > 0 && fabs(table_length - length) <= tolerance) {
+      return tables[i];
+    }
+  }
+
+  // Never rebuild the table a movement is following
+  if (&tables[next_table] == active) {
+    next_table = (next_table + 1) % NUM_TABLES;
+  }
+  ProfileTable &table = tables[next_table];
+  next_table = (next_table + 1) % NUM_TABLES;
+  table.build(*profile, length, dt);
+  return table;
+}
+
 /**
  * @brief Update the motion profile with a new sensor value
  *
@@ -33,7 +98,12 @@ void MotionController::init(double start_pt, double end_pt) {
  * @return the motor input generated from the motion profile
  */
 double MotionController::update(double sensor_val) {
-  cur_motion = profile.calculate(tmr.time(timeUnits::sec));
+  if (use_moving) {
+    cur_motion = moving.calculate(tmr.time(timeUnits::sec));
+  } else {
+    motion_t m = active->lookup(tmr.time(timeUnits::sec));
+    cur_motion = {active_start + (active_scale * m.pos), active_scale * m.vel, active_scale * m.accel};
+  }
   pid.set_target(cur_motion.pos);
   pid.update(sensor_val, cur_motion.vel);
 
@@ -66,7 +136,8 @@ void MotionController::set_limits(double lower, double upper) {
  * confirms it is on target
  */
 bool MotionController::is_on_target() {
-  return (tmr.time(timeUnits::sec) > profile.get_movement_time()) && pid.is_on_target();
+  double movement_time = use_moving ? moving.get_movement_time() : active->get_movement_time();
+  return (tmr.time(timeUnits::sec) > movement_time) && pid.is_on_target();
 }
 
 /**
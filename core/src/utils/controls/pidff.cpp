@@ -12,8 +12,12 @@ PIDFF::PIDFF(PID::pid_config_t &pid_cfg, FeedForward::ff_config_t &ff_cfg) : pid
  *
  * @param start_pt the current sensor value
  * @param set_pt where the sensor value should be
+ * @param start_vel the current rate of change of the sensor value
+ * @param end_vel the desired ending rate of change of the sensor value
  */
-void PIDFF::init(double start_pt, double set_pt) { pid.init(start_pt, set_pt); }
+void PIDFF::init(double start_pt, double set_pt, double start_vel, double end_vel) {
+  pid.init(start_pt, set_pt, start_vel, end_vel);
+}
 
 void PIDFF::set_target(double set_pt) { pid.set_target(set_pt); }
 
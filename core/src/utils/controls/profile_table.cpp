@@ -0,0 +1,58 @@
+#include "../core/include/utils/controls/profile_table.h"
+#include <cmath>
+
+/**
+ * Create an empty table. Lookups return 0 until it is built
+ */
+ProfileTable::ProfileTable() : distance(0), movement_time(0), inv_dt(0) {}
+
+/**
+ * Sample a profile from 0 to distance.
+ * The last sample is at or after the end of the movement, so lookups between samples never run off the table.
+ */
+void ProfileTable::build(MotionProfile &profile, double distance, double dt) {
+  this->distance = fabs(distance);
+  this->inv_dt = 1.0 / dt;
+
+  profile.set_endpts(0, this->distance);
+  // calculate() works out the movement time as it goes
+  profile.calculate(0);
+  movement_time = profile.get_movement_time();
+
+  int num_samples = (int)ceil(movement_time * inv_dt) + 1;
+  samples.resize(num_samples);
+  for (int i = 0; i < num_samples; i++) {
+    motion_t m = profile.calculate(i * dt);
+    samples[i] = {(float)m.pos, (float)m.vel, (float)m.accel};
+  }
+}
+
+/**
+ * Get the motion at a point in time, interpolated between the nearest samples
+ */
+motion_t ProfileTable::lookup(double time_s) const {
+  if (samples.empty() || time_s <= 0) {
+    return {0, 0, 0};
+  }
+  if (time_s >= movement_time) {
+    return {distance, 0, 0};
+  }
+
+  double index = time_s * inv_dt;
+  int i = (int)index;
+  double frac = index - i;
+  const sample_t &a = samples[i];
+  const sample_t &b = samples[i + 1];
+
+  return {a.pos + (b.pos - a.pos) * frac, a.vel + (b.vel - a.vel) * frac, a.accel + (b.accel - a.accel) * frac};
+}
+
+/**
+ * @return how far the movement goes
+ */
+double ProfileTable::get_distance() const { return distance; }
+
+/**
+ * @return how long the movement takes (sec)
+ */
+double ProfileTable::get_movement_time() const { return movement_time; }
@@ -0,0 +1,199 @@
+#include "../core/include/utils/controls/scurve_profile.h"
+#include <cmath>
+
+/**
+ * @brief Construct a new S-Curve Profile object
+ *
+ * @param max_v Maximum velocity the robot can run at
+ * @param accel Maximum acceleration of the robot
+ * @param jerk Maximum rate of change of acceleration, or 0 for no limit
+ */
+SCurveProfile::SCurveProfile(double max_v, double accel, double jerk)
+    : start(0), end(0), start_vel(0), end_vel(0), max_v(max_v), accel(accel), jerk(jerk) {
+  solve();
+}
+
+void SCurveProfile::set_endpts(double start, double end) {
+  this->start = start;
+  this->end = end;
+  solve();
+}
+
+void SCurveProfile::set_vel_endpts(double start_vel, double end_vel) {
+  this->start_vel = start_vel;
+  this->end_vel = end_vel;
+  solve();
+}
+
+void SCurveProfile::set_max_v(double max_v) {
+  this->max_v = max_v;
+  solve();
+}
+
+void SCurveProfile::set_accel(double accel) {
+  this->accel = accel;
+  solve();
+}
+
+void SCurveProfile::set_jerk(double jerk) {
+  this->jerk = jerk;
+  solve();
+}
+
+/**
+ * How long changing velocity by dv takes, starting and ending with no acceleration: dv/a + a/j if full acceleration
+ * is reached (a*a/j <= dv), or 2*sqrt(dv/j) if it isn't
+ */
+static double ramp_time(double dv, double a, double jerk) {
+  dv = fabs(dv);
+  if (jerk <= 0) {
+    return dv / a;
+  }
+  return (dv >= a * a / jerk) ? dv / a + a / jerk : 2 * sqrt(dv / jerk);
+}
+
+/**
+ * How far changing velocity from v_from to v_to takes. The acceleration ramps up and down the same way, so the
+ * velocity passes the average halfway through the time, and the distance is the average velocity times the time
+ */
+static double ramp_dist(double v_from, double v_to, double a, double jerk) {
+  return (v_from + v_to) / 2 * ramp_time(v_to - v_from, a, jerk);
+}
+
+/**
+ * Bisect for the x between lo and hi where f(x) is target, if f(lo) <= target < f(hi). lo may be above hi
+ */
+template <typename F> static double bisect(F f, double lo, double hi, double target) {
+  for (int i = 0; i < 60; i++) {
+    double mid = (lo + hi) / 2;
+    if (f(mid) <= target) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/**
+ * Work out the segments for a movement of |end - start|, in the direction of travel.
+ *
+ * The movement speeds up (or slows down) from the start velocity to a top speed, cruises, and then changes to the end
+ * velocity. The further the top speed is from both, the more distance the two changes cover, so first try max_v with
+ * the rest of the distance spent cruising. If that's too far, bisect for the top speed that covers the distance
+ * exactly. If even going straight from the start velocity to the end velocity is too far, there's only that one
+ * change, cut short when it reaches the end. It's still accelerating (or decelerating) as hard as it can then.
+ */
+void SCurveProfile::solve() {
+  double distance = fabs(end - start);
+  double dir = (end < start) ? -1 : 1;
+  double a = accel;
+  double j = jerk;
+
+  double v0 = dir * start_vel;
+  double v1 = fmax(fmin(dir * end_vel, max_v), 0);
+  after_vel = v1;
+
+  // Closest to the start and end velocities the top speed can be, going straight from one to the other
+  double lowest_v = (v0 > max_v) ? v1 : fmax(v0, v1);
+  auto total_dist = [&](double top_v) { return ramp_dist(v0, top_v, a, j) + ramp_dist(top_v, v1, a, j); };
+
+  double top_v = max_v;
+  double t_cruise = 0;
+  bool cut_short = total_dist(lowest_v) > distance;
+  if (cut_short) {
+    // Can't reach end_vel in time: head straight for it the whole way, speeding up if it's too slow and slowing down
+    // if it's too fast
+    top_v = v1;
+  } else if (total_dist(max_v) > distance) {
+    top_v = bisect(total_dist, lowest_v, max_v, distance);
+  } else if (max_v > 0) {
+    t_cruise = (distance - total_dist(max_v)) / max_v;
+  }
+
+  // The two velocity changes, each as up to 3 segments: jerk to full acceleration, hold it, and jerk back to none
+  const double changes[2] = {top_v - v0, v1 - top_v};
+  double durations[7], jerks[7], accels[7];
+  for (int c = 0; c < 2; c++) {
+    double sign = (changes[c] < 0) ? -1 : 1;
+    double dv = fabs(changes[c]);
+    double peak_a = (j > 0) ? fmin(a, sqrt(dv * j)) : a;
+    double t_jerk = (j > 0) ? peak_a / j : 0;
+    double t_const = (peak_a > 0) ? dv / peak_a - t_jerk : 0;
+    double seg_j = (t_jerk > 0) ? sign * j : 0;
+
+    int first = c * 4;
+    durations[first] = t_jerk;
+    durations[first + 1] = t_const;
+    durations[first + 2] = t_jerk;
+    jerks[first] = seg_j;
+    jerks[first + 1] = 0;
+    jerks[first + 2] = -seg_j;
+    // Set the acceleration outright at the start of every segment, so rounding in the ramps doesn't carry through
+    accels[first] = 0;
+    accels[first + 1] = sign * peak_a;
+    accels[first + 2] = (t_jerk > 0) ? sign * peak_a : 0;
+  }
+  durations[3] = t_cruise;
+  jerks[3] = 0;
+  accels[3] = 0;
+
+  // Step through the segments to find the motion at the start of each one
+  double p = 0, v = v0;
+  time = 0;
+  for (int i = 0; i < 7; i++) {
+    double acc = accels[i];
+    segments[i] = {durations[i], jerks[i], p, v, acc};
+
+    double dt = durations[i];
+    p += v * dt + acc * dt * dt / 2 + jerks[i] * dt * dt * dt / 6;
+    v += acc * dt + jerks[i] * dt * dt / 2;
+    time += dt;
+  }
+
+  // The movement ends at whatever velocity it has when it gets there
+  if (cut_short) {
+    time = bisect([&](double t) { return along(t).pos; }, 0, time, distance);
+    after_vel = fmin(along(time).vel, v1);
+  }
+}
+
+/**
+ * @brief Run the profile based on the time that's ellapsed
+ *
+ * @param time_s Time since start of movement
+ * @return motion_t Position, velocity and acceleration
+ */
+motion_t SCurveProfile::calculate(double time_s) {
+  double dir = (end < start) ? -1 : 1;
+  if (time_s < 0) {
+    return {start, start_vel, 0};
+  }
+  if (time_s >= time) {
+    return {end, dir * after_vel, 0};
+  }
+
+  motion_t m = along(time_s);
+  return {start + dir * m.pos, dir * m.vel, dir * m.accel};
+}
+
+/**
+ * The motion time_s into the segments, measured from the start along the direction of travel
+ */
+motion_t SCurveProfile::along(double time_s) const {
+  int i = 0;
+  while (i < 6 && time_s >= segments[i].duration) {
+    time_s -= segments[i].duration;
+    i++;
+  }
+
+  const segment_t &seg = segments[i];
+  double t = time_s;
+  double pos = seg.pos + seg.vel * t + seg.accel * t * t / 2 + seg.jerk * t * t * t / 6;
+  double vel = seg.vel + seg.accel * t + seg.jerk * t * t / 2;
+  double acc = seg.accel + seg.jerk * t;
+
+  return {pos, vel, acc};
+}
+
+double SCurveProfile::get_movement_time() { return time; }
@@ -2,7 +2,8 @@
 #include "../core/include/utils/math_util.h"
 #include <cmath>
 
-TrapezoidProfile::TrapezoidProfile(double max_v, double accel) : start(0), end(0), max_v(max_v), accel(accel) {}
+TrapezoidProfile::TrapezoidProfile(double max_v, double accel)
+    : start(0), end(0), start_vel(0), end_vel(0), max_v(max_v), accel(accel) {}
 
 void TrapezoidProfile::set_max_v(double max_v) { this->max_v = max_v; }
 
@@ -13,6 +14,11 @@ void TrapezoidProfile::set_endpts(double start, double end) {
   this->end = end;
 }
 
+void TrapezoidProfile::set_vel_endpts(double start_vel, double end_vel) {
+  this->start_vel = start_vel;
+  this->end_vel = end_vel;
+}
+
 // Kinematic equations as macros
 #define CALC_POS(time_s, a, v, s) ((0.5 * (a) * (time_s) * (time_s)) + ((v) * (time_s)) + (s))
 #define CALC_VEL(time_s, a, v) (((a) * (time_s)) + (v))
@@ -20,46 +26,66 @@ void TrapezoidProfile::set_endpts(double start, double end) {
 /**
  * @brief Run the trapezoidal profile based on the time that's ellapsed
  *
+ * The profile is worked out in the direction of travel, so velocities along it are positive, then flipped back at the
+ * end. It goes from start_vel to a peak velocity, cruises at the peak, and then goes from the peak to end_vel.
+ *
  * @param time_s Time since start of movement
  * @return motion_t Position, velocity and acceleration
  */
 motion_t TrapezoidProfile::calculate(double time_s) {
   double delta_pos = end - start;
+  double dir = (delta_pos < 0) ? -1 : 1;
+  double distance = fabs(delta_pos);
 
-  // redefine accel and max_v in this scope for negative calcs
-  double accel_local = this->accel;
-  double max_v_local = this->max_v;
-  if (delta_pos < 0) {
-    accel_local = -this->accel;
-    max_v_local = -this->max_v;
-  }
+  double v0 = dir * start_vel;
+  double v1 = clamp(dir * end_vel, 0, max_v);
+  double v1_target = v1;
 
-  // Calculate the time spent during the acceleration / maximum velocity / deceleration stages
-  double accel_time = max_v_local / accel_local;
-  double max_vel_time = (delta_pos - (accel_local * accel_time * accel_time)) / max_v_local;
-  this->time = (2 * accel_time) + max_vel_time;
+  // First try reaching max velocity, with whatever distance is left over spent cruising.
+  // Starting faster than max velocity makes the first leg a deceleration
+  double peak_v = max_v;
+  double accel_time = fabs(peak_v - v0) / accel;
+  double decel_time = (peak_v - v1) / accel;
+  double max_vel_time = (distance - ((v0 + peak_v) / 2 * accel_time) - ((peak_v + v1) / 2 * decel_time)) / peak_v;
 
-  // If the time during the "max velocity" state is negative, use an S profile
+  // If the time during the "max velocity" state is negative, there's no room to cruise
   if (max_vel_time < 0) {
-    accel_time = sqrt(fabs(delta_pos / accel));
     max_vel_time = 0;
-    this->time = 2 * accel_time;
+    if (v1 * v1 - v0 * v0 > 2 * accel * distance) {
+      // Can't speed up to end_vel in time: accelerate the whole way
+      peak_v = sqrt(v0 * v0 + 2 * accel * distance);
+      v1 = peak_v;
+    } else if (v0 > 0 && v0 * v0 - v1 * v1 > 2 * accel * distance) {
+      // Can't slow down to end_vel in time: decelerate the whole way
+      peak_v = v0;
+      v1 = sqrt(v0 * v0 - 2 * accel * distance);
+    } else {
+      // Accelerate to whatever peak velocity leaves just enough room to decelerate
+      peak_v = sqrt(accel * distance + (v0 * v0 + v1 * v1) / 2);
+    }
+    accel_time = fabs(peak_v - v0) / accel;
+    decel_time = (peak_v - v1) / accel;
   }
+  this->time = accel_time + max_vel_time + decel_time;
+
+  double accel_local = (peak_v < v0) ? -accel : accel;
 
   motion_t out;
 
   // Handle if a bad time is put in
   if (time_s < 0) {
     out.pos = start;
-    out.vel = 0;
+    out.vel = dir * v0;
     out.accel = 0;
     return out;
   }
 
   // Handle after the setpoint is reached
-  if (time_s > 2 * accel_time + max_vel_time) {
+  if (time_s > this->time) {
     out.pos = end;
-    out.vel = 0;
+    // A movement that couldn't slow down in time arrives too fast and overshoots. Don't keep asking for that speed once
+    // it's parked at the end
+    out.vel = dir * fmin(v1, v1_target);
     out.accel = 0;
     return out;
   }
@@ -68,28 +94,28 @@ motion_t TrapezoidProfile::calculate(double time_s) {
 
   // Displacement from initial acceleration
   if (time_s < accel_time) {
-    out.pos = start + CALC_POS(time_s, accel_local, 0, 0);
-    out.vel = CALC_VEL(time_s, accel_local, 0);
-    out.accel = accel_local;
+    out.pos = start + dir * CALC_POS(time_s, accel_local, v0, 0);
+    out.vel = dir * CALC_VEL(time_s, accel_local, v0);
+    out.accel = dir * accel_local;
     return out;
   }
 
-  double s_accel = CALC_POS(accel_time, accel_local, 0, 0);
+  double s_accel = CALC_POS(accel_time, accel_local, v0, 0);
 
   // Displacement during maximum velocity
   if (time_s < accel_time + max_vel_time) {
-    out.pos = start + CALC_POS(time_s - accel_time, 0, max_v_local, s_accel);
-    out.vel = sign(delta_pos) * max_v;
+    out.pos = start + dir * CALC_POS(time_s - accel_time, 0, peak_v, s_accel);
+    out.vel = dir * peak_v;
     out.accel = 0;
     return out;
   }
 
-  double s_max_vel = CALC_POS(max_vel_time, 0, max_v_local, s_accel);
+  double s_max_vel = CALC_POS(max_vel_time, 0, peak_v, s_accel);
 
   // Displacement during deceleration
-  out.pos = start + CALC_POS(time_s - (2 * accel_time) - max_vel_time, -accel_local, 0, s_accel + s_max_vel);
-  out.vel = CALC_VEL(time_s - accel_time - max_vel_time, -accel_local, max_v_local);
-  out.accel = -accel_local;
+  out.pos = start + dir * CALC_POS(time_s - accel_time - max_vel_time, -accel, peak_v, s_max_vel);
+  out.vel = dir * CALC_VEL(time_s - accel_time - max_vel_time, -accel, peak_v);
+  out.accel = dir * -accel;
   return out;
 }
 
@@ -0,0 +1,187 @@
+#include "../core/include/utils/derivative_estimator.h"
+#include <cmath>
+
+/**
+ * Create an estimator. All memory is allocated here
+ *
+ * @param window_size  how many samples to fit over. More is smoother, fewer follows sudden changes faster
+ * @param min_interval the shortest time between samples kept in the window (sec)
+ */
+LeastSquaresDerivative::LeastSquaresDerivative(int window_size, double min_interval)
+    : times(window_size < 3 ? 3 : window_size, 0.0), values(window_size < 3 ? 3 : window_size, 0.0), newest(0),
+      count(0), min_interval(min_interval), last_slot_time(0), value(0), rate(0), accel(0) {}
+
+/**
+ * Add a reading and refit
+ *
+ * @param time  when the reading was taken (sec). Must not go backwards
+ * @param value the reading
+ */
+void LeastSquaresDerivative::add_sample(double time, double new_value) {
+  if (count == 0 || time - last_slot_time >= min_interval) {
+    // Start a new slot, pushing out the oldest if full
+    newest = (count == 0) ? 0 : (newest + 1) % times.size();
+    if (count < (int)times.size()) {
+      count++;
+    }
+    last_slot_time = time;
+  }
+  // Otherwise keep refreshing the newest slot with the latest reading
+  times[newest] = time;
+  values[newest] = new_value;
+
+  fit();
+}
+
+/**
+ * Forget all samples
+ */
+void LeastSquaresDerivative::reset() {
+  count = 0;
+  value = rate = accel = 0;
+}
+
+/**
+ * Fit the quadratic through the samples in the window.
+ *
+ * Times are measured back from the newest sample and divided by the window length, so the sums stay near 1 and the
+ * normal equations stay well conditioned.
+ */
+void LeastSquaresDerivative::fit() {
+  int size = times.size();
+  int oldest = (newest - count + 1 + size) % size;
+  double span = times[newest] - times[oldest];
+
+  value = values[newest];
+  rate = 0;
+  accel = 0;
+  if (count < 2 || span <= 0) {
+    return;
+  }
+
+  // Sums of u^k and v*u^k for the normal equations
+  double s0 = 0, s1 = 0, s2 = 0, s3 = 0, s4 = 0;
+  double t0 = 0, t1 = 0, t2 = 0;
+  for (int i = 0; i < count; i++) {
+    int idx = (oldest + i) % size;
+    double u = (times[idx] - times[newest]) / span;
+    double v = values[idx];
+    double u2 = u * u;
+    s0 += 1;
+    s1 += u;
+    s2 += u2;
+    s3 += u2 * u;
+    s4 += u2 * u2;
+    t0 += v;
+    t1 += v * u;
+    t2 += v * u2;
+  }
+
+  if (count == 2) {
+    // Not enough points for a curve, use the line through them
+    rate = (values[newest] - values[oldest]) / span;
+    return;
+  }
+
+  // Solve [s0 s1 s2; s1 s2 s3; s2 s3 s4] * [a b c] = [t0 t1 t2] by Cramer's rule
+  double det = s0 * (s2 * s4 - s3 * s3) - s1 * (s1 * s4 - s3 * s2) + s2 * (s1 * s3 - s2 * s2);
+  if (fabs(det) < 1e-12) {
+    rate = (values[newest] - values[oldest]) / span;
+    return;
+  }
+  double a = (t0 * (s2 * s4 - s3 * s3) - s1 * (t1 * s4 - s3 * t2) + s2 * (t1 * s3 - s2 * t2)) / det;
+  double b = (s0 * (t1 * s4 - t2 * s3) - t0 * (s1 * s4 - s3 * s2) + s2 * (s1 * t2 - t1 * s2)) / det;
+  double c = (s0 * (s2 * t2 - s3 * t1) - s1 * (s1 * t2 - s3 * t0) + (s1 * t1 - s2 * t0) * s2) / det;
+
+  value = a;
+  rate = b / span;
+  accel = 2 * c / (span * span);
+}
+
+/**
+ * @return the smoothed value at the newest sample
+ */
+double LeastSquaresDerivative::get_value() const { return value; }
+
+/**
+ * @return the rate of change at the newest sample (units/sec)
+ */
+double LeastSquaresDerivative::get_rate() const { return rate; }
+
+/**
+ * @return the rate of change of the rate of change at the newest sample (units/sec^2)
+ */
+double LeastSquaresDerivative::get_accel() const { return accel; }
+
+/**
+ * Create an estimator. All memory is allocated here
+ *
+ * @param window_size  how many samples to fit over
+ * @param min_interval the shortest time between samples kept in the window (sec)
+ */
+PoseDerivativeEstimator::PoseDerivativeEstimator(int window_size, double min_interval)
+    : x_fit(window_size, min_interval), y_fit(window_size, min_interval), rot_fit(window_size, min_interval),
+      has_rot(false), rot_unwrapped(0) {}
+
+/**
+ * Add a position and refit
+ */
+void PoseDerivativeEstimator::add_sample(double time, const pose_t &pos) {
+  if (!has_rot) {
+    rot_unwrapped = pos.rot;
+    has_rot = true;
+  } else {
+    // Follow the shortest way around from the last rotation, so 359 -> 1 is +2 and not -358
+    double diff = fmod(pos.rot - rot_unwrapped, 360.0);
+    if (diff > 180) {
+      diff -= 360;
+    } else if (diff < -180) {
+      diff += 360;
+    }
+    rot_unwrapped += diff;
+  }
+
+  x_fit.add_sample(time, pos.x);
+  y_fit.add_sample(time, pos.y);
+  rot_fit.add_sample(time, rot_unwrapped);
+}
+
+/**
+ * Forget all samples
+ */
+void PoseDerivativeEstimator::reset() {
+  x_fit.reset();
+  y_fit.reset();
+  rot_fit.reset();
+  has_rot = false;
+}
+
+/**
+ * @return how fast the robot is travelling, in any direction (inch/s)
+ */
+double PoseDerivativeEstimator::get_speed() const { return hypot(x_fit.get_rate(), y_fit.get_rate()); }
+
+/**
+ * The change in speed is the part of the acceleration along the direction of travel
+ *
+ * @return the rate the speed is changing (inch/s^2)
+ */
+double PoseDerivativeEstimator::get_accel() const {
+  double vx = x_fit.get_rate();
+  double vy = y_fit.get_rate();
+  double speed = hypot(vx, vy);
+  if (speed < 1e-6) {
+    return hypot(x_fit.get_accel(), y_fit.get_accel());
+  }
+  return (vx * x_fit.get_accel() + vy * y_fit.get_accel()) / speed;
+}
+
+/**
+ * @return how fast the robot is turning, CCW positive (deg/s)
+ */
+double PoseDerivativeEstimator::get_angular_speed_deg() const { return rot_fit.get_rate(); }
+
+/**
+ * @return the rate the turning speed is changing (deg/s^2)
+ */
+double PoseDerivativeEstimator::get_angular_accel_deg() const { return rot_fit.get_accel(); }
@@ -0,0 +1,176 @@
+#include "../core/include/utils/least_squares.h"
+#include <cmath>
+#include <vector>
+
+/**
+ * Sum of squares of a list of residuals
+ */
+static double sum_squares(const std::vector<double> &residuals) {
+  double total = 0;
+  for (double r : residuals) {
+    total += r * r;
+  }
+  return total;
+}
+
+/**
+ * Solve the n x n system a * x = b in place by Gaussian elimination with partial pivoting.
+ * a and b are destroyed, and the answer is left in b.
+ *
+ * @return false if a is singular
+ */
+static bool solve_in_place(std::vector<double> &a, std::vector<double> &b, int n) {
+  for (int col = 0; col < n; col++) {
+    // Swap up the row with the biggest value in this column, to keep the division stable
+    int pivot = col;
+    for (int row = col + 1; row < n; row++) {
+      if (fabs(a[row * n + col]) > fabs(a[pivot * n + col])) {
+        pivot = row;
+      }
+    }
+    if (fabs(a[pivot * n + col]) < 1e-300) {
+      return false;
+    }
+    if (pivot != col) {
+      for (int k = 0; k < n; k++) {
+        double tmp = a[col * n + k];
+        a[col * n + k] = a[pivot * n + k];
+        a[pivot * n + k] = tmp;
+      }
+      double tmp = b[col];
+      b[col] = b[pivot];
+      b[pivot] = tmp;
+    }
+
+    for (int row = col + 1; row < n; row++) {
+      double factor = a[row * n + col] / a[col * n + col];
+      for (int k = col; k < n; k++) {
+        a[row * n + k] -= factor * a[col * n + k];
+      }
+      b[row] -= factor * b[col];
+    }
+  }
+
+  for (int row = n - 1; row >= 0; row--) {
+    double total = b[row];
+    for (int k = row + 1; k < n; k++) {
+      total -= a[row * n + k] * b[k];
+    }
+    b[row] = total / a[row * n + row];
+  }
+  return true;
+}
+
+/**
+ * Fit params to minimize the sum of the squared residuals.
+ *
+ * Each step linearizes the residuals around the current parameters with a forward difference Jacobian J, then solves
+ * (J'J + lambda * diag(J'J)) * step = -J'r. A small lambda makes that a Gauss-Newton step, which converges quickly
+ * near the answer; a large one makes it a short gradient descent step, which is safe far from it. lambda shrinks
+ * after every step that helps and grows after every one that doesn't.
+ */
+least_squares_result_t levenberg_marquardt(residual_fn_t residual_fn, void *ctx, double *params, int num_params,
+                                           int num_residuals, int max_iterations) {
+  least_squares_result_t result = {0, 0, 0, false};
+  if (num_params <= 0 || num_residuals <= 0) {
+    return result;
+  }
+
+  std::vector<double> residuals(num_residuals, 0.0);
+  std::vector<double> trial_residuals(num_residuals, 0.0);
+  std::vector<double> jacobian(num_residuals * num_params, 0.0);
+  std::vector<double> jtj(num_params * num_params, 0.0);
+  std::vector<double> jtr(num_params, 0.0);
+  std::vector<double> lhs(num_params * num_params, 0.0);
+  std::vector<double> step(num_params, 0.0);
+  std::vector<double> trial(num_params, 0.0);
+
+  residual_fn(params, residuals.data(), ctx);
+  double cost = sum_squares(residuals);
+  result.rms_start = sqrt(cost / num_residuals);
+
+  double lambda = 1e-3;
+  for (result.iterations = 0; result.iterations < max_iterations; result.iterations++) {
+    // Numerical Jacobian, one column per parameter
+    for (int p = 0; p < num_params; p++) {
+      trial.assign(params, params + num_params);
+      double h = 1e-6 * fmax(fabs(params[p]), 1.0);
+      trial[p] += h;
+      trial_residuals.assign(num_residuals, 0.0);
+      residual_fn(trial.data(), trial_residuals.data(), ctx);
+      for (int i = 0; i < num_residuals; i++) {
+        jacobian[i * num_params + p] = (trial_residuals[i] - residuals[i]) / h;
+      }
+    }
+
+    // Normal equations
+    for (int a = 0; a < num_params; a++) {
+      jtr[a] = 0;
+      for (int b = 0; b < num_params; b++) {
+        jtj[a * num_params + b] = 0;
+      }
+    }
+    for (int i = 0; i < num_residuals; i++) {
+      const double *row = &jacobian[i * num_params];
+      for (int a = 0; a < num_params; a++) {
+        jtr[a] += row[a] * residuals[i];
+        for (int b = 0; b < num_params; b++) {
+          jtj[a * num_params + b] += row[a] * row[b];
+        }
+      }
+    }
+
+    // Keep trying steps until one reduces the cost, making them shorter each time
+    bool improved = false;
+    double new_cost = cost;
+    while (lambda < 1e12) {
+      lhs = jtj;
+      for (int a = 0; a < num_params; a++) {
+        // The 1e-12 keeps a parameter the residuals don't depend on from making the system singular
+        lhs[a * num_params + a] += lambda * jtj[a * num_params + a] + 1e-12;
+        step[a] = -jtr[a];
+      }
+
+      if (solve_in_place(lhs, step, num_params)) {
+        for (int p = 0; p < num_params; p++) {
+          trial[p] = params[p] + step[p];
+        }
+        trial_residuals.assign(num_residuals, 0.0);
+        residual_fn(trial.data(), trial_residuals.data(), ctx);
+        new_cost = sum_squares(trial_residuals);
+        if (new_cost < cost) {
+          improved = true;
+          break;
+        }
+      }
+      lambda *= 10;
+    }
+
+    if (!improved) {
+      // No step in any direction helps, so this is the bottom
+      result.converged = true;
+      break;
+    }
+
+    double step_size = 0, param_size = 0;
+    for (int p = 0; p < num_params; p++) {
+      params[p] = trial[p];
+      step_size += step[p] * step[p];
+      param_size += params[p] * params[p];
+    }
+    residuals.swap(trial_residuals);
+    double old_cost = cost;
+    cost = new_cost;
+    lambda = fmax(lambda / 10, 1e-12);
+
+    // Stop once the steps or the improvement become negligible
+    if (sqrt(step_size) < 1e-10 * (sqrt(param_size) + 1e-10) || old_cost - new_cost < 1e-14 * old_cost) {
+      result.iterations++;
+      result.converged = true;
+      break;
+    }
+  }
+
+  result.rms_end = sqrt(cost / num_residuals);
+  return result;
+}
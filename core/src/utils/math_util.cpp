@@ -53,6 +53,41 @@ double wrap_angle_rad(double input) {
 
   return angle;
 }
+
+/**
+ * Move a pose along the constant curvature arc that covers a given distance and turn (the SE(2) exponential map).
+ *
+ * Over an arc turning w radians, a robot driving d forward ends up d*sin(w)/w forward and d*(1-cos(w))/w to the
+ * left of where it started, in its starting frame. Odometry runs every few milliseconds so w is almost always tiny;
+ * there the series for sin(w)/w and (1-cos(w))/w are exact to double precision and skip the trig entirely, leaving
+ * one sin/cos pair for the starting heading.
+ */
+pose_t integrate_arc(const pose_t &start, double dist_fwd, double dist_side, double delta_rot_rad) {
+  double w = delta_rot_rad;
+  double sin_w_over_w, one_minus_cos_w_over_w;
+  if (fabs(w) < 1e-2) {
+    double w2 = w * w;
+    sin_w_over_w = 1.0 - w2 / 6.0 * (1.0 - w2 / 20.0);
+    one_minus_cos_w_over_w = w / 2.0 * (1.0 - w2 / 12.0 * (1.0 - w2 / 30.0));
+  } else {
+    sin_w_over_w = sin(w) / w;
+    one_minus_cos_w_over_w = (1.0 - cos(w)) / w;
+  }
+
+  // Displacement in the starting frame: forward, and left (the side input is to the right)
+  double local_fwd = dist_fwd * sin_w_over_w + dist_side * one_minus_cos_w_over_w;
+  double local_left = dist_fwd * one_minus_cos_w_over_w - dist_side * sin_w_over_w;
+
+  double start_rad = start.rot * (PI / 180.0);
+  double c = cos(start_rad);
+  double s = sin(start_rad);
+
+  pose_t end;
+  end.x = start.x + local_fwd * c - local_left * s;
+  end.y = start.y + local_fwd * s + local_left * c;
+  end.rot = wrap_angle_deg(start.rot + delta_rot_rad * (180.0 / PI));
+  return end;
+}
 /*
 Calculates the average of a vector of doubles
 @param values   the list of values for which the average is taken
@@ -120,20 +155,21 @@ std::pair<double, double> calculate_linear_regression(std::vector<std::pair<doub
   return std::pair<double, double>(slope, y_intercept);
 }
 
-double estimate_path_length(const std::vector<point_t> &points) {
-  double dist = 0;
-
-  for (point_t p : points) {
-    static point_t last_p = p;
-
-    // Ignore the first point
-    if (p == last_p) {
-      continue;
-    }
+/**
+ * Adds up the distances between consecutive points. If the path is a PurePursuit::Path, use its get_length()
+ * instead, which is already calculated.
+ * @param points the points making up the path
+ * @return the length of the path
+ */
+template <typename T> T estimate_path_length(const std::vector<point2<T>> &points) {
+  T dist = 0;
 
-    dist += p.dist(last_p);
-    last_p = p;
+  for (int i = 1; i < points.size(); i++) {
+    dist += points[i].dist(points[i - 1]);
   }
 
   return dist;
-}
\ No newline at end of file
+}
+
+template float estimate_path_length(const std::vector<pointf_t> &points);
+template double estimate_path_length(const std::vector<point_t> &points);
\ No newline at end of file
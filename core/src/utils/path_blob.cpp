@@ -0,0 +1,94 @@
+#include "../core/include/utils/path_blob.h"
+#include <string.h>
+
+// The header takes up this many point_t's at the start of the buffer
+#define HEADER_POINTS (sizeof(path_blob_header_t) / sizeof(point_t))
+
+using namespace PurePursuit;
+
+/**
+ * Create a loader, allocating enough room for the largest path it will hold
+ *
+ * @param max_points the most points a loaded path may contain
+ */
+PathBlob::PathBlob(int max_points) : buf(HEADER_POINTS + max_points), loaded(false) {}
+
+/**
+ * Read a path blob from the SD card, replacing whatever was loaded before.
+ * The file is read in a single loadfile() call into the preallocated buffer.
+ *
+ * @param filename the file on the SD card
+ * @return true if the file was read and is a valid path blob for this version
+ */
+bool PathBlob::load(const char *filename) {
+  loaded = false;
+
+  vex::brain::sdcard sd;
+  if (!sd.isInserted()) {
+    printf("!! Trying to load path %s with no SD card !!\n", filename);
+    return false;
+  }
+
+  int32_t capacity = buf.size() * sizeof(point_t);
+  int32_t size = sd.size(filename);
+  if (size <= 0 || size > capacity) {
+    printf("!! Path %s is missing or too big (%ld bytes, room for %ld) !!\n", filename, (long)size, (long)capacity);
+    return false;
+  }
+
+  int32_t read = sd.loadfile(filename, (uint8_t *)buf.data(), capacity);
+
+  path_blob_header_t header = get_header();
+  if (read < (int32_t)sizeof(path_blob_header_t) || header.magic != PATH_BLOB_MAGIC) {
+    printf("!! %s is not a path blob !!\n", filename);
+    return false;
+  }
+  if (header.version != PATH_BLOB_VERSION) {
+    printf("!! Path %s is version %lu, expected %lu. Recompile it !!\n", filename, (unsigned long)header.version,
+           (unsigned long)PATH_BLOB_VERSION);
+    return false;
+  }
+  // Check num_points against what was read before multiplying it, so a corrupt count can't overflow and pass
+  uint32_t body_bytes = read - sizeof(path_blob_header_t);
+  if (header.num_points > body_bytes / sizeof(point_t) || header.num_points * sizeof(point_t) != body_bytes) {
+    printf("!! Path %s is truncated or corrupt (%lu points in %lu bytes) !!\n", filename,
+           (unsigned long)header.num_points, (unsigned long)body_bytes);
+    return false;
+  }
+
+  loaded = true;
+  return true;
+}
+
+/**
+ * @return true if the last call to load() succeeded
+ */
+bool PathBlob::is_loaded() const { return loaded; }
+
+/**
+ * @return the metadata of the loaded path
+ */
+path_blob_header_t PathBlob::get_header() const {
+  path_blob_header_t header;
+  memcpy(&header, buf.data(), sizeof(header));
+  return header;
+}
+
+/**
+ * @return a pointer to the loaded points, directly inside the file buffer
+ */
+const point_t *PathBlob::get_points() const { return buf.data() + HEADER_POINTS; }
+
+/**
+ * @return the number of loaded points
+ */
+int PathBlob::get_num_points() const { return loaded ? get_header().num_points : 0; }
+
+/**
+ * Construct a pure pursuit path from the loaded points, with the radius it was baked for.
+ * Copies the points and bakes them like any other Path. If nothing is loaded, the path is empty and will report itself
+ * as invalid.
+ */
+Path PathBlob::get_path() const {
+  return Path(std::vector<point_t>(get_points(), get_points() + get_num_points()), get_header().radius);
+}
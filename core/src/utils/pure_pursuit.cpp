@@ -1,37 +1,201 @@
 #include "../core/include/utils/pure_pursuit.h"
+#include "../core/include/utils/math_util.h"
+#include <algorithm>
+#include <utility>
 
 /**
- * Create a Path
- * @param points the points that make up the path
+ * How far along the segment a -> b the closest point to p is, from 0 to 1
+ */
+template <typename T> static T project_onto_segment(point2<T> p, point2<T> a, point2<T> b) {
+  point2<T> ab = b - a;
+  T len_sq = (ab.x * ab.x) + (ab.y * ab.y);
+  T t = (((p.x - a.x) * ab.x) + ((p.y - a.y) * ab.y)) / (len_sq > 0 ? len_sq : 1);
+  return t < 0 ? 0 : (t > 1 ? 1 : t);
+}
+
+/**
+ * Distance from a point to the closest point on a line segment
+ */
+template <typename T> static T point_segment_dist(point2<T> p, point2<T> a, point2<T> b) {
+  return p.dist(a + ((b - a) * project_onto_segment(p, a, b)));
+}
+
+/**
+ * 2D cross product of (a - o) and (b - o). Positive if o->a->b turns counter-clockwise
+ */
+template <typename T> static T cross(point2<T> o, point2<T> a, point2<T> b) {
+  return ((a.x - o.x) * (b.y - o.y)) - ((a.y - o.y) * (b.x - o.x));
+}
+
+/**
+ * Returns the minimum distance between the line segments (a1, a2) and (b1, b2).
+ * If the segments cross, the distance is 0.
+ */
+template <typename T> T PurePursuit::segment_dist(point2<T> a1, point2<T> a2, point2<T> b1, point2<T> b2) {
+  T d1 = cross(a1, a2, b1);
+  T d2 = cross(a1, a2, b2);
+  T d3 = cross(b1, b2, a1);
+  T d4 = cross(b1, b2, a2);
+
+  // Each segment's endpoints are strictly on opposite sides of the other: a proper crossing
+  if (((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0))) {
+    return 0;
+  }
+
+  // Otherwise the closest approach always involves at least one endpoint (touching / collinear cases come out as 0)
+  return std::min(std::min(point_segment_dist(a1, b1, b2), point_segment_dist(a2, b1, b2)),
+                  std::min(point_segment_dist(b1, a1, a2), point_segment_dist(b2, a1, a2)));
+}
+
+template float PurePursuit::segment_dist(pointf_t, pointf_t, pointf_t, pointf_t);
+template double PurePursuit::segment_dist(point_t, point_t, point_t, point_t);
+
+/**
+ * Finds the segment (points[i] -> points[i + 1]) closest to a point, out of segments first through last.
+ * The loop is written without branches so it can be vectorized.
+ *
+ * @param points the points making up the segments
+ * @param first index of the first segment to check
+ * @param last index of the last segment to check. points[last + 1] must exist
+ * @param pt the point to search for
+ * @param t_out if not NULL, set to how far along the closest segment the closest point is, from 0 to 1
+ * @return the index of the closest segment, or -1 if first > last
+ */
+template <typename T>
+int PurePursuit::closest_segment(const point2<T> *points, int first, int last, point2<T> pt, T *t_out) {
+  int best = -1;
+  T best_dist_sq = INFINITY;
+  T best_t = 0;
+  for (int i = first; i <= last; i++) {
+    T t = project_onto_segment(pt, points[i], points[i + 1]);
+    T dx = points[i].x + ((points[i + 1].x - points[i].x) * t) - pt.x;
+    T dy = points[i].y + ((points[i + 1].y - points[i].y) * t) - pt.y;
+    T dist_sq = (dx * dx) + (dy * dy);
+
+    bool closer = dist_sq < best_dist_sq;
+    best = closer ? i : best;
+    best_t = closer ? t : best_t;
+    best_dist_sq = closer ? dist_sq : best_dist_sq;
+  }
+
+  if (t_out != NULL) {
+    *t_out = best_t;
+  }
+  return best;
+}
+
+template int PurePursuit::closest_segment(const pointf_t *, int, int, pointf_t, float *);
+template int PurePursuit::closest_segment(const point_t *, int, int, point_t, double *);
+
+/**
+ * Create a Path, taking over the points rather than copying them again
+ * @param path_points the points that make up the path
  * @param radius the lookahead radius for pure pursuit
  */
-PurePursuit::Path::Path(std::vector<point_t> points, double radius) {
-  this->points = points;
-  this->radius = radius;
-  this->valid = true;
-
-  for (int i = 0; i < points.size() - 1; i++) {
-    for (int j = i + 2; j < points.size() - 1; j++) {
-      // Iterate over points on the segments discretely and compare distances
-      double segment_i_dist = points[i].dist(points[i + 1]);
-      if (segment_i_dist == 0) {
-        segment_i_dist = 0.1;
+PurePursuit::Path::Path(std::vector<point_t> path_points, double radius)
+    : points(std::move(path_points)), radius(radius), valid(true) {
+
+  // Bake the per-point data used while driving
+  int num_points = points.size();
+  headings.resize(num_points, 0);
+  curvatures.resize(num_points, 0);
+  cumulative_dist.resize(num_points, 0);
+  for (int i = 1; i < num_points; i++) {
+    cumulative_dist[i] = cumulative_dist[i - 1] + points[i - 1].dist(points[i]);
+    headings[i - 1] = atan2(points[i].y - points[i - 1].y, points[i].x - points[i - 1].x);
+  }
+  if (num_points > 1) {
+    headings[num_points - 1] = headings[num_points - 2];
+  }
+  for (int i = 1; i < num_points - 1; i++) {
+    // Curvature of the circle through the point and its neighbors: 2 * sin(angle) / chord
+    double a = points[i - 1].dist(points[i]);
+    double b = points[i].dist(points[i + 1]);
+    double c = points[i - 1].dist(points[i + 1]);
+    if (a * b * c != 0) {
+      curvatures[i] = 2 * cross(points[i - 1], points[i], points[i + 1]) / (a * b * c);
+    }
+  }
+
+  // Segment i is only compared to segments i+2 and later, so there's nothing to check with fewer than 3 segments
+  if (points.size() < 4 || radius <= 0) {
+    return;
+  }
+  int num_segs = points.size() - 1;
+
+  // Bucket every segment into a uniform grid so each segment is only compared against its neighbors, instead of
+  // every other segment on the path.
+  point_t min = points[0], max = points[0];
+  for (const point_t &p : points) {
+    min.x = fmin(min.x, p.x);
+    min.y = fmin(min.y, p.y);
+    max.x = fmax(max.x, p.x);
+    max.y = fmax(max.y, p.y);
+  }
+
+  // Cells the size of the radius, unless that makes a huge, mostly empty grid for a sparse path
+  double cell_size = radius;
+  int max_cells = (4 * num_segs) + 16;
+  while (((max.x - min.x) / cell_size + 1) * ((max.y - min.y) / cell_size + 1) > max_cells) {
+    cell_size *= 2;
+  }
+  int cols = (int)((max.x - min.x) / cell_size) + 1;
+  int rows = (int)((max.y - min.y) / cell_size) + 1;
+
+  auto cell_x = [&](double x) { return (int)clamp(floor((x - min.x) / cell_size), 0, cols - 1); };
+  auto cell_y = [&](double y) { return (int)clamp(floor((y - min.y) / cell_size), 0, rows - 1); };
+
+  // Grid stored compressed: the segments in cell c are seg_idx[cell_start[c]] to seg_idx[cell_start[c+1] - 1]
+  std::vector<int> cell_start((cols * rows) + 1, 0);
+  std::vector<int> seg_idx;
+
+  // First pass counts how many segments touch each cell, second pass fills them in
+  for (int pass = 0; pass < 2; pass++) {
+    std::vector<int> fill_pos;
+    if (pass == 1) {
+      for (int c = 0; c < cols * rows; c++) {
+        cell_start[c + 1] += cell_start[c];
       }
-      double segment_j_dist = points[j].dist(points[j + 1]);
-      if (segment_j_dist == 0) {
-        segment_j_dist = 0.1;
+      seg_idx.resize(cell_start[cols * rows]);
+      fill_pos.assign(cell_start.begin(), cell_start.end() - 1);
+    }
+
+    for (int i = 0; i < num_segs; i++) {
+      int x0 = cell_x(fmin(points[i].x, points[i + 1].x)), x1 = cell_x(fmax(points[i].x, points[i + 1].x));
+      int y0 = cell_y(fmin(points[i].y, points[i + 1].y)), y1 = cell_y(fmax(points[i].y, points[i + 1].y));
+      for (int cy = y0; cy <= y1; cy++) {
+        for (int cx = x0; cx <= x1; cx++) {
+          int c = (cy * cols) + cx;
+          if (pass == 0) {
+            cell_start[c + 1]++;
+          } else {
+            seg_idx[fill_pos[c]++] = i;
+          }
+        }
       }
-      for (double t1 = 0; t1 <= 1; t1 += radius / segment_i_dist) {
-        point_t p1;
-        p1.x = points[i].x + t1 * (points[i + 1].x - points[i].x);
-        p1.y = points[i].y + t1 * (points[i + 1].y - points[i].y);
+    }
+  }
 
-        for (double t2 = 0; t2 <= 1; t2 += radius / segment_j_dist) {
-          point_t p2;
-          p2.x = points[j].x + t2 * (points[j + 1].x - points[j].x);
-          p2.y = points[j].y + t2 * (points[j + 1].y - points[j].y);
+  // Compare each segment against the non-adjacent segments in the cells within one radius of it.
+  // last_checked stops a pair from being tested again when both segments share several cells.
+  std::vector<int> last_checked(num_segs, -1);
+  for (int i = 0; i < num_segs; i++) {
+    int x0 = cell_x(fmin(points[i].x, points[i + 1].x) - radius);
+    int x1 = cell_x(fmax(points[i].x, points[i + 1].x) + radius);
+    int y0 = cell_y(fmin(points[i].y, points[i + 1].y) - radius);
+    int y1 = cell_y(fmax(points[i].y, points[i + 1].y) + radius);
+
+    for (int cy = y0; cy <= y1; cy++) {
+      for (int cx = x0; cx <= x1; cx++) {
+        int c = (cy * cols) + cx;
+        for (int k = cell_start[c]; k < cell_start[c + 1]; k++) {
+          int j = seg_idx[k];
+          if (j < i + 2 || last_checked[j] == i) {
+            continue;
+          }
+          last_checked[j] = i;
 
-          if (p1.dist(p2) < radius) {
+          if (segment_dist(points[i], points[i + 1], points[j], points[j + 1]) < radius) {
             this->valid = false;
             return;
           }
@@ -44,63 +208,304 @@ PurePursuit::Path::Path(std::vector<point_t> points, double radius) {
 /**
  * Get the points associated with this Path
  */
-std::vector<point_t> PurePursuit::Path::get_points() { return this->points; }
+const std::vector<point_t> &PurePursuit::Path::get_points() const { return this->points; }
 
 /**
  * Get the radius associated with this Path
  */
-double PurePursuit::Path::get_radius() { return this->radius; }
+double PurePursuit::Path::get_radius() const { return this->radius; }
 
 /**
  * Get whether this path will behave as expected
  */
-bool PurePursuit::Path::is_valid() { return this->valid; }
+bool PurePursuit::Path::is_valid() const { return this->valid; }
 
 /**
- * Returns points of the intersections of a line segment and a circle. The line
+ * Get the heading of the path at each point, in radians
+ */
+const std::vector<double> &PurePursuit::Path::get_headings() const { return this->headings; }
+
+/**
+ * Get the signed curvature of the path at each point
+ */
+const std::vector<double> &PurePursuit::Path::get_curvatures() const { return this->curvatures; }
+
+/**
+ * Get the distance along the path from the first point to each point
+ */
+const std::vector<double> &PurePursuit::Path::get_cumulative_dist() const { return this->cumulative_dist; }
+
+/**
+ * Get the total length of the path
+ */
+double PurePursuit::Path::get_length() const { return cumulative_dist.empty() ? 0 : cumulative_dist.back(); }
+
+/**
+ * Find the segment containing a distance along the path
+ */
+int PurePursuit::Path::segment_at(double s) const {
+  int num_segs = (int)points.size() - 1;
+  if (num_segs < 1) {
+    return 0;
+  }
+
+  // First point further along than s, and the segment that ends there
+  int seg = std::upper_bound(cumulative_dist.begin(), cumulative_dist.end(), s) - cumulative_dist.begin() - 1;
+  return (int)clamp(seg, 0, num_segs - 1);
+}
+
+/**
+ * Get the point a certain distance along the path
+ */
+point_t PurePursuit::Path::point_at(double s) const {
+  if (points.size() < 2) {
+    return points.empty() ? point_t{0, 0} : points[0];
+  }
+
+  int seg = segment_at(s);
+  double seg_len = cumulative_dist[seg + 1] - cumulative_dist[seg];
+  if (seg_len == 0) {
+    return points[seg];
+  }
+
+  double t = clamp((s - cumulative_dist[seg]) / seg_len, 0, 1);
+  return points[seg] + ((points[seg + 1] - points[seg]) * t);
+}
+
+/**
+ * Get the direction of travel a certain distance along the path
+ * @param s distance along the path, clamped between 0 and get_length()
+ * @return heading in radians, 0 along +X and counter-clockwise positive
+ */
+double PurePursuit::Path::heading_at(double s) const {
+  if (points.size() < 2) {
+    return 0;
+  }
+  return headings[segment_at(s)];
+}
+
+/**
+ * Get the curvature a certain distance along the path, interpolated between the points on either side
+ * @param s distance along the path, clamped between 0 and get_length()
+ * @return signed curvature (1 / inches), positive turning left
+ */
+double PurePursuit::Path::curvature_at(double s) const {
+  if (points.size() < 2) {
+    return 0;
+  }
+
+  int seg = segment_at(s);
+  double seg_len = cumulative_dist[seg + 1] - cumulative_dist[seg];
+  if (seg_len == 0) {
+    return curvatures[seg];
+  }
+
+  double t = clamp((s - cumulative_dist[seg]) / seg_len, 0, 1);
+  return curvatures[seg] + ((curvatures[seg + 1] - curvatures[seg]) * t);
+}
+
+/**
+ * Find how far along the path a point is, by projecting it onto the closest segment in a range of the path
+ */
+double PurePursuit::Path::progress_of(point_t pt, double s_min, double s_max) const {
+  if (points.size() < 2) {
+    return 0;
+  }
+
+  double t = 0;
+  int seg = closest_segment(points.data(), segment_at(s_min), segment_at(s_max), pt, &t);
+  if (seg < 0) {
+    return 0;
+  }
+
+  return cumulative_dist[seg] + (t * (cumulative_dist[seg + 1] - cumulative_dist[seg]));
+}
+
+/**
+ * Generate a velocity profile for a path
+ * @param path the path to profile
+ * @param cfg velocity and acceleration limits
+ * @param start_vel velocity the robot is already travelling at when the path starts (inch/s)
+ * @param end_vel velocity the robot should be travelling at when the path ends (inch/s)
+ */
+PurePursuit::VelocityProfile::VelocityProfile(const Path &path, velocity_profile_cfg_t cfg, double start_vel,
+                                              double end_vel)
+    : dist(path.get_cumulative_dist()) {
+  const std::vector<double> &curvatures = path.get_curvatures();
+  int num_points = dist.size();
+  vel.resize(num_points, 0);
+  accel.resize(num_points, 0);
+  time.resize(num_points, 0);
+  if (num_points == 0) {
+    return;
+  }
+
+  // Limit speed in turns by the sideways acceleration: a = v^2 * curvature
+  for (int i = 0; i < num_points; i++) {
+    vel[i] = cfg.max_v;
+    if (curvatures[i] != 0 && cfg.max_lat_accel > 0) {
+      vel[i] = fmin(vel[i], sqrt(cfg.max_lat_accel / fabs(curvatures[i])));
+    }
+  }
+  vel[0] = fmin(vel[0], fabs(start_vel));
+  vel[num_points - 1] = fmin(vel[num_points - 1], fabs(end_vel));
+
+  // Forward pass: can't speed up faster than accel (v1^2 = v0^2 + 2*a*ds)
+  for (int i = 1; i < num_points; i++) {
+    double ds = dist[i] - dist[i - 1];
+    vel[i] = fmin(vel[i], sqrt((vel[i - 1] * vel[i - 1]) + (2 * cfg.accel * ds)));
+  }
+
+  // Backward pass: can't slow down faster than accel either
+  for (int i = num_points - 2; i >= 0; i--) {
+    double ds = dist[i + 1] - dist[i];
+    vel[i] = fmin(vel[i], sqrt((vel[i + 1] * vel[i + 1]) + (2 * cfg.accel * ds)));
+  }
+
+  // Time parameterize, assuming constant acceleration between points
+  for (int i = 0; i < num_points - 1; i++) {
+    double ds = dist[i + 1] - dist[i];
+    double avg_vel = (vel[i] + vel[i + 1]) / 2.0;
+    double dt = (avg_vel > 0) ? ds / avg_vel : 0;
+
+    accel[i] = (dt > 0) ? (vel[i + 1] - vel[i]) / dt : 0;
+    time[i + 1] = time[i] + dt;
+  }
+}
+
+/**
+ * Motion a certain time after passing a point, accelerating constantly towards the next point
+ */
+motion_t PurePursuit::VelocityProfile::motion_from(int i, double dt) const {
+  motion_t out;
+  out.pos = dist[i] + (vel[i] * dt) + (0.5 * accel[i] * dt * dt);
+  out.vel = vel[i] + (accel[i] * dt);
+  out.accel = accel[i];
+  return out;
+}
+
+/**
+ * Get the target motion a certain time after starting the path
+ */
+motion_t PurePursuit::VelocityProfile::calculate(double time_s) const {
+  if (time.empty()) {
+    return motion_t{0, 0, 0};
+  }
+
+  // Before the start / after the end, hold the endpoints
+  if (time_s <= 0) {
+    return motion_t{dist.front(), vel.front(), 0};
+  }
+  if (time_s >= time.back()) {
+    return motion_t{dist.back(), vel.back(), 0};
+  }
+
+  int i = std::upper_bound(time.begin(), time.end(), time_s) - time.begin() - 1;
+  return motion_from(i, time_s - time[i]);
+}
+
+/**
+ * Get the target motion at a distance along the path
+ */
+motion_t PurePursuit::VelocityProfile::calculate_at_dist(double s) const {
+  if (dist.empty()) {
+    return motion_t{0, 0, 0};
+  }
+
+  if (s <= dist.front()) {
+    return motion_t{dist.front(), vel.front(), accel.front()};
+  }
+  if (s >= dist.back()) {
+    return motion_t{dist.back(), vel.back(), 0};
+  }
+
+  // Solve v^2 = v0^2 + 2*a*ds for the velocity at this distance
+  int i = std::upper_bound(dist.begin(), dist.end(), s) - dist.begin() - 1;
+  double ds = s - dist[i];
+  motion_t out;
+  out.pos = s;
+  out.vel = sqrt(fmax((vel[i] * vel[i]) + (2 * accel[i] * ds), 0));
+  out.accel = accel[i];
+  return out;
+}
+
+/**
+ * @return the time it takes to drive the whole path
+ */
+double PurePursuit::VelocityProfile::get_movement_time() const { return time.empty() ? 0 : time.back(); }
+
+/**
+ * Get the target velocity at each point of the path
+ */
+const std::vector<double> &PurePursuit::VelocityProfile::get_velocities() const { return vel; }
+
+/**
+ * Get the time at which each point of the path is reached
+ */
+const std::vector<double> &PurePursuit::VelocityProfile::get_times() const { return time; }
+
+/**
+ * Finds the intersections of a line segment and a circle without allocating. The line
  * segment is defined by two points, and the circle is defined by a center and radius.
+ *
+ * @param out array the intersections are written to, in order of the first solution then the second
+ * @return the number of intersections written to out (0, 1 or 2)
  */
-std::vector<point_t> PurePursuit::line_circle_intersections(point_t center, double r, point_t point1, point_t point2) {
-  std::vector<point_t> intersections = {};
+template <typename T>
+int PurePursuit::line_circle_intersections(point2<T> center, T r, point2<T> seg_start, point2<T> seg_end,
+                                           point2<T> out[2]) {
+  int num_intersections = 0;
 
   // Do future calculations relative to the circle's center
-  point1.y -= center.y;
-  point1.x -= center.x;
-  point2.y -= center.y;
-  point2.x -= center.x;
+  point2<T> p1 = seg_start - center;
+  point2<T> p2 = seg_end - center;
 
-  double x1, x2, y1, y2;
+  T x1, x2, y1, y2;
   // Handling an infinite slope using mx+b and x^2 + y^2 = r^2
-  if (point1.x - point2.x == 0) {
-    x1 = point1.x;
-    y1 = sqrt(pow(r, 2) - pow(x1, 2));
-    x2 = point1.x;
-    y2 = -sqrt(pow(r, 2) - pow(x2, 2));
+  if (p1.x - p2.x == 0) {
+    x1 = p1.x;
+    y1 = std::sqrt((r * r) - (x1 * x1));
+    x2 = p1.x;
+    y2 = -std::sqrt((r * r) - (x2 * x2));
   }
   // Non-infinite slope using mx+b and x^2 + y^2 = r^2
   else {
-    double m = (point1.y - point2.y) / (point1.x - point2.x);
-    double b = point1.y - (m * point1.x);
+    T m = (p1.y - p2.y) / (p1.x - p2.x);
+    T b = p1.y - (m * p1.x);
 
-    x1 = ((-m * b) + sqrt(pow(r, 2) + (pow(m, 2) * pow(r, 2)) - pow(b, 2))) / (1 + pow(m, 2));
+    T root = std::sqrt((r * r) + ((m * m) * (r * r)) - (b * b));
+    x1 = ((-m * b) + root) / (1 + (m * m));
     y1 = m * x1 + b;
-    x2 = ((-m * b) - sqrt(pow(r, 2) + (pow(m, 2) * pow(r, 2)) - pow(b, 2))) / (1 + pow(m, 2));
+    x2 = ((-m * b) - root) / (1 + (m * m));
     y2 = m * x2 + b;
   }
 
   // The equations used define an infinitely long line, so we check if the detected intersection falls on the line
   // segment.
-  if (x1 >= fmin(point1.x, point2.x) && x1 <= fmax(point1.x, point2.x) && y1 >= fmin(point1.y, point2.y) &&
-      y1 <= fmax(point1.y, point2.y)) {
-    intersections.push_back(point_t{.x = x1 + center.x, .y = y1 + center.y});
+  T min_x = std::min(p1.x, p2.x), max_x = std::max(p1.x, p2.x);
+  T min_y = std::min(p1.y, p2.y), max_y = std::max(p1.y, p2.y);
+  if (x1 >= min_x && x1 <= max_x && y1 >= min_y && y1 <= max_y) {
+    out[num_intersections++] = point2<T>{.x = x1 + center.x, .y = y1 + center.y};
   }
 
-  if (x2 >= fmin(point1.x, point2.x) && x2 <= fmax(point1.x, point2.x) && y2 >= fmin(point1.y, point2.y) &&
-      y2 <= fmax(point1.y, point2.y)) {
-    intersections.push_back(point_t{.x = x2 + center.x, .y = y2 + center.y});
+  if (x2 >= min_x && x2 <= max_x && y2 >= min_y && y2 <= max_y) {
+    out[num_intersections++] = point2<T>{.x = x2 + center.x, .y = y2 + center.y};
   }
 
-  return intersections;
+  return num_intersections;
+}
+
+template int PurePursuit::line_circle_intersections(pointf_t, float, pointf_t, pointf_t, pointf_t[2]);
+template int PurePursuit::line_circle_intersections(point_t, double, point_t, point_t, point_t[2]);
+
+/**
+ * Returns points of the intersections of a line segment and a circle. The line
+ * segment is defined by two points, and the circle is defined by a center and radius.
+ */
+std::vector<point_t> PurePursuit::line_circle_intersections(point_t center, double r, point_t point1, point_t point2) {
+  point_t found[2];
+  int num_found = line_circle_intersections(center, r, point1, point2, found);
+  return std::vector<point_t>(found, found + num_found);
 }
 
 /**
@@ -119,19 +524,119 @@ std::vector<point_t> PurePursuit::line_circle_intersections(point_t center, doub
     point_t start = path[i];
     point_t end = path[i + 1];
 
-    std::vector<point_t> intersections = line_circle_intersections(robot_loc.get_point(), radius, start, end);
+    point_t intersections[2];
+    int num_intersections = line_circle_intersections(robot_loc.get_point(), radius, start, end, intersections);
     // Choose the intersection that is closest to the end of the line segment
     // This prioritizes the closest intersection to the end of the path
-    for (point_t intersection : intersections) {
-      if (intersection.dist(end) < target.dist(end)) {
-        target = intersection;
+    for (int j = 0; j < num_intersections; j++) {
+      if (intersections[j].dist(end) < target.dist(end)) {
+        target = intersections[j];
+      }
+    }
+  }
+
+  return target;
+}
+
+/**
+ * Search segments first_seg through last_seg (inclusive) for the intersection that is furthest along the path.
+ *
+ * @param target set to the intersection, if one was found
+ * @return the segment the intersection is on, or -1 if none of the segments intersect the circle
+ */
+static int search_segments(const std::vector<point_t> &path, point_t center, double radius, int first_seg,
+                           int last_seg, point_t &target) {
+  int found_seg = -1;
+  for (int i = first_seg; i <= last_seg; i++) {
+    point_t intersections[2];
+    int num_intersections = PurePursuit::line_circle_intersections(center, radius, path[i], path[i + 1], intersections);
+
+    // Later segments override earlier ones. Within a segment, the intersection closest to its end is furthest along.
+    for (int j = 0; j < num_intersections; j++) {
+      if (found_seg != i || intersections[j].dist(path[i + 1]) < target.dist(path[i + 1])) {
+        target = intersections[j];
+        found_seg = i;
       }
     }
   }
+  return found_seg;
+}
+
+/**
+ * Create a LookaheadTracker
+ * @param window how many segments past the last lookahead's segment to search each update
+ */
+PurePursuit::LookaheadTracker::LookaheadTracker(int window) : window(window), segment(0) {}
+
+/**
+ * Start over from the beginning of the path
+ */
+void PurePursuit::LookaheadTracker::reset() { segment = 0; }
+
+/**
+ * Selects a look ahead from the intersections in the search window, moving the window forward as the robot
+ * progresses. The window never moves backwards along the path.
+ */
+point_t PurePursuit::LookaheadTracker::get_lookahead(const std::vector<point_t> &path, pose_t robot_loc,
+                                                     double radius) {
+  // Default: the end of the path
+  point_t target = path.back();
+  int last_seg = (int)path.size() - 2;
+
+  if (last_seg < 0 || target.dist(robot_loc.get_point()) <= radius) {
+    segment = std::max(last_seg, 0);
+    return target;
+  }
+
+  // Usually the lookahead is found within a few segments of where it was last time
+  int window_end = std::min(segment + window, last_seg);
+  int found_seg = search_segments(path, robot_loc.get_point(), radius, segment, window_end, target);
+
+  // If the robot got knocked off the path or jumped ahead, fall back to searching the rest of it once
+  if (found_seg < 0 && window_end < last_seg) {
+    found_seg = search_segments(path, robot_loc.get_point(), radius, window_end + 1, last_seg, target);
+  }
+
+  if (found_seg >= 0) {
+    segment = found_seg;
+  }
 
   return target;
 }
 
+/**
+ * Get the index of the segment (path[i] -> path[i + 1]) the last lookahead point was found on
+ */
+int PurePursuit::LookaheadTracker::get_segment() const { return segment; }
+
+/**
+ * Calculate the lookahead radius for this update.
+ * The curvature used is the sharpest point on the path within one speed-based radius past the given segment.
+ *
+ * @param path the path being followed
+ * @param segment the segment the last lookahead point was on (see LookaheadTracker::get_segment())
+ * @param speed the robot's current speed (inch/s)
+ * @param cfg the radius limits and gains
+ * @return the lookahead radius to use
+ */
+double PurePursuit::adaptive_lookahead_radius(const Path &path, int segment, double speed,
+                                              const adaptive_lookahead_cfg_t &cfg) {
+  double radius = cfg.min_radius + cfg.speed_gain * fabs(speed);
+
+  const std::vector<double> &curvatures = path.get_curvatures();
+  const std::vector<double> &cumulative_dist = path.get_cumulative_dist();
+  if (cfg.curvature_gain > 0 && segment >= 0 && segment < (int)curvatures.size()) {
+    double preview_end = cumulative_dist[segment] + radius;
+    double max_curvature = 0;
+    for (int i = segment; i < (int)curvatures.size() && cumulative_dist[i] <= preview_end; i++) {
+      max_curvature = fmax(max_curvature, fabs(curvatures[i]));
+    }
+    radius /= 1 + cfg.curvature_gain * max_curvature;
+  }
+
+  return clamp(radius, cfg.min_radius, cfg.max_radius);
+}
+
 /**
  Injects points in a path without changing the curvature with a certain spacing.
 */
@@ -167,31 +672,57 @@ std::vector<point_t> PurePursuit::line_circle_intersections(point_t center, doub
  *
  * Weight data is how much weight to update the data (alpha)
  * Weight smooth is how much weight to smooth the coordinates (beta)
- * Tolerance is how much change per iteration is necessary to continue iterating.
+ * Tolerance is no longer used - the smoothed path is solved for directly, see smooth_path_direct().
  *
- * Honestly have no idea if/how this works.
  * https://medium.com/@jaems33/understanding-robot-motion-path-smoothing-5970c8363bc4
  */
 [[maybe_unused]] std::vector<point_t> PurePursuit::smooth_path(const std::vector<point_t> &path, double weight_data,
                                                                double weight_smooth, double tolerance) {
-  std::vector<point_t> new_path = path;
-  double change = tolerance;
-  while (change >= tolerance) {
-    change = 0;
-    for (int i = 1; i < path.size() - 1; i++) {
-      point_t x_i = path[i];
-      point_t y_i = new_path[i];
-      point_t y_prev = new_path[i - 1];
-      point_t y_next = new_path[i + 1];
-
-      point_t y_i_saved = y_i;
-
-      y_i.x += weight_data * (x_i.x - y_i.x) + weight_smooth * (y_next.x + y_prev.x - (2 * y_i.x));
-      y_i.y += weight_data * (x_i.y - y_i.y) + weight_smooth * (y_next.y + y_prev.y - (2 * y_i.y));
-      new_path[i] = y_i;
-
-      change += y_i.dist(y_i_saved);
-    }
+  (void)tolerance;
+  return smooth_path_direct(path, weight_data, weight_smooth);
+}
+
+/**
+ * Smooths a path by solving for the points the iterative smoother converges to, in one pass.
+ *
+ * The iterative method stops changing a point when
+ *   weight_data * (x[i] - y[i]) + weight_smooth * (y[i-1] + y[i+1] - 2 * y[i]) = 0
+ * for every point except the (fixed) start and end. That is a tridiagonal system of equations:
+ *   -weight_smooth * y[i-1] + (weight_data + 2 * weight_smooth) * y[i] - weight_smooth * y[i+1] = weight_data * x[i]
+ * which is solved here with the Thomas algorithm in O(n), instead of iterating until it settles.
+ *
+ * @param path The path to smooth
+ * @param weight_data How strongly the smoothed points are pulled towards the original points (alpha)
+ * @param weight_smooth How strongly the smoothed points are pulled towards their neighbors (beta)
+ * @return The smoothed path
+ */
+std::vector<point_t> PurePursuit::smooth_path_direct(const std::vector<point_t> &path, double weight_data,
+                                                     double weight_smooth) {
+  int n = path.size();
+  if (n < 3 || weight_smooth == 0) {
+    return path;
+  }
+
+  double diag = weight_data + 2 * weight_smooth;
+  double off = -weight_smooth;
+
+  // Forward sweep. The fixed start point is treated as an already-solved row.
+  std::vector<double> c_prime(n - 1);
+  std::vector<point_t> d_prime(n - 1);
+  c_prime[0] = 0;
+  d_prime[0] = path[0];
+  for (int i = 1; i < n - 1; i++) {
+    double denom = diag - off * c_prime[i - 1];
+    c_prime[i] = off / denom;
+    d_prime[i] = (path[i] * weight_data - d_prime[i - 1] * off) / denom;
+  }
+
+  // Back substitution, starting from the fixed end point
+  std::vector<point_t> new_path(n);
+  new_path[0] = path[0];
+  new_path[n - 1] = path[n - 1];
+  for (int i = n - 2; i >= 1; i--) {
+    new_path[i] = d_prime[i] - new_path[i + 1] * c_prime[i];
   }
   return new_path;
 }
@@ -236,6 +767,152 @@ std::vector<point_t> PurePursuit::line_circle_intersections(point_t center, doub
   return new_path;
 }
 
+// Number of arc length table entries per hermite segment
+#define HERMITE_TABLE_SIZE 16
+
+// 5 point Gauss-Legendre quadrature nodes and weights on [-1, 1]
+static const double gauss_nodes[5] = {-0.9061798459386640, -0.5384693101056831, 0, 0.5384693101056831,
+                                      0.9061798459386640};
+static const double gauss_weights[5] = {0.2369268850561891, 0.4786286704993665, 0.5688888888888889,
+                                        0.4786286704993665, 0.2369268850561891};
+
+/**
+ * A hermite segment in cartesian form, so evaluating it doesn't go through Vector2D's polar math
+ */
+typedef struct {
+  point_t p1, p2, t1, t2;
+} hermite_segment_t;
+
+static hermite_segment_t make_hermite_segment(const PurePursuit::hermite_point &a, const PurePursuit::hermite_point &b) {
+  return {a.getPoint(), b.getPoint(), a.getTangent().point(), b.getTangent().point()};
+}
+
+/**
+ * Position along a hermite segment, with the same blending functions as smooth_path_hermite()
+ */
+static point_t hermite_position(const hermite_segment_t &seg, double s) {
+  double h1 = 2 * s * s * s - 3 * s * s + 1;
+  double h2 = -2 * s * s * s + 3 * s * s;
+  double h3 = s * s * s - 2 * s * s + s;
+  double h4 = s * s * s - s * s;
+  return seg.p1 * h1 + seg.p2 * h2 + seg.t1 * h3 + seg.t2 * h4;
+}
+
+/**
+ * Magnitude of the derivative of a hermite segment (distance per unit of s)
+ */
+static double hermite_speed(const hermite_segment_t &seg, double s) {
+  double dh1 = 6 * s * s - 6 * s;
+  double dh2 = -6 * s * s + 6 * s;
+  double dh3 = 3 * s * s - 4 * s + 1;
+  double dh4 = 3 * s * s - 2 * s;
+  point_t d = seg.p1 * dh1 + seg.p2 * dh2 + seg.t1 * dh3 + seg.t2 * dh4;
+  return sqrt(d.x * d.x + d.y * d.y);
+}
+
+/**
+ * Arc length of a hermite segment between s0 and s1, by Gauss-Legendre quadrature
+ */
+static double hermite_arc_length(const hermite_segment_t &seg, double s0, double s1) {
+  double half = (s1 - s0) / 2;
+  double mid = (s1 + s0) / 2;
+  double sum = 0;
+  for (int i = 0; i < 5; i++) {
+    sum += gauss_weights[i] * hermite_speed(seg, mid + half * gauss_nodes[i]);
+  }
+  return sum * half;
+}
+
+/**
+ * Interpolates a smooth path given a list of waypoints using hermite splines, placing the
+ * points an equal distance apart along the curve instead of at equal steps of the spline parameter.
+ *
+ * Each segment gets a table of cumulative arc length at evenly spaced s values. To place a point,
+ * the table gives the interval it falls in, and a few newton steps refine s within that interval.
+ * The total length is known before sampling, so the output is allocated once.
+ *
+ * @param path The path of hermite points to interpolate.
+ * @param spacing The distance along the curve between points.
+ * @return The smoothed path.
+ */
+std::vector<point_t> PurePursuit::smooth_path_hermite_uniform(const std::vector<hermite_point> &path,
+                                                               double spacing) {
+  std::vector<point_t> new_path;
+  if (path.size() < 2 || spacing <= 0) {
+    for (const hermite_point &p : path) {
+      new_path.push_back(p.getPoint());
+    }
+    return new_path;
+  }
+
+  int num_segs = path.size() - 1;
+
+  // Build the s -> distance tables
+  std::vector<hermite_segment_t> segs(num_segs);
+  std::vector<double> table(num_segs * (HERMITE_TABLE_SIZE + 1));
+  double total = 0;
+  for (int i = 0; i < num_segs; i++) {
+    segs[i] = make_hermite_segment(path[i], path[i + 1]);
+    double *seg_table = &table[i * (HERMITE_TABLE_SIZE + 1)];
+    seg_table[0] = total;
+    for (int k = 1; k <= HERMITE_TABLE_SIZE; k++) {
+      double s0 = (double)(k - 1) / HERMITE_TABLE_SIZE;
+      double s1 = (double)k / HERMITE_TABLE_SIZE;
+      seg_table[k] = seg_table[k - 1] + hermite_arc_length(segs[i], s0, s1);
+    }
+    total = seg_table[HERMITE_TABLE_SIZE];
+  }
+
+  // Points at every multiple of spacing, then the end. Skip the last even point if it lands on the end.
+  int num_even = (int)floor(total / spacing) + 1;
+  if ((num_even - 1) * spacing > total - 1e-6) {
+    num_even--;
+  }
+  new_path.reserve(num_even + 1);
+
+  int seg = 0;
+  int k = 0;
+  for (int n = 0; n < num_even; n++) {
+    double dist = n * spacing;
+
+    // Walk the table forward to the interval containing dist
+    while (seg < num_segs) {
+      const double *seg_table = &table[seg * (HERMITE_TABLE_SIZE + 1)];
+      while (k < HERMITE_TABLE_SIZE && seg_table[k + 1] < dist) {
+        k++;
+      }
+      if (k < HERMITE_TABLE_SIZE || seg == num_segs - 1) {
+        break;
+      }
+      seg++;
+      k = 0;
+    }
+    k = k < HERMITE_TABLE_SIZE ? k : HERMITE_TABLE_SIZE - 1;
+    const double *seg_table = &table[seg * (HERMITE_TABLE_SIZE + 1)];
+
+    // Linear guess within the interval, then refine with newton's method
+    double s_lo = (double)k / HERMITE_TABLE_SIZE;
+    double s_hi = (double)(k + 1) / HERMITE_TABLE_SIZE;
+    double interval_len = seg_table[k + 1] - seg_table[k];
+    double target = dist - seg_table[k];
+    double s = interval_len > 0 ? s_lo + (s_hi - s_lo) * target / interval_len : s_lo;
+    for (int iter = 0; iter < 3; iter++) {
+      double speed = hermite_speed(segs[seg], s);
+      if (speed < 1e-9) {
+        break;
+      }
+      s -= (hermite_arc_length(segs[seg], s_lo, s) - target) / speed;
+      s = clamp(s, s_lo, s_hi);
+    }
+
+    new_path.push_back(hermite_position(segs[seg], s));
+  }
+
+  // Adding last point
+  new_path.push_back(path.back().getPoint());
+  return new_path;
+}
+
 /**
  * Estimates the remaining distance from the robot's position to the end,
  * by "searching" for the robot along the path and running a "connect the dots"
@@ -256,13 +933,14 @@ double PurePursuit::estimate_remaining_dist(const std::vector<point_t> &path, po
   double dist = 0;
 
   // Run through the path backwards, adding distances
-  for (int i = path.size() - 1; i >= 0; i--) {
+  for (int i = path.size() - 1; i > 0; i--) {
     // Test if the robot is between the two points
-    auto pts = line_circle_intersections(robot_pose.get_point(), radius, path[i - 1], path[i]);
+    point_t pts[2];
+    int num_pts = line_circle_intersections(robot_pose.get_point(), radius, path[i - 1], path[i], pts);
 
     // There is an intersection? Robot is between the points so add the distance
     // from the bot to the next point and end.
-    if (!pts.empty()) {
+    if (num_pts > 0) {
       dist += robot_pose.get_point().dist(path[i]);
       return dist;
     }
@@ -274,3 +952,30 @@ double PurePursuit::estimate_remaining_dist(const std::vector<point_t> &path, po
 
   return dist;
 }
+
+/**
+ * Estimates the remaining distance from the robot's position to the end using the path's precomputed
+ * distances. Only the part of the path just behind the lookahead point is searched for the robot.
+ *
+ * @param path The pure pursuit path the robot is following
+ * @param robot_pose The robot's current position
+ * @param lookahead The current lookahead point
+ * @param lookahead_seg The segment the lookahead point is on (see LookaheadTracker::get_segment())
+ * @param radius The lookahead radius used to find the lookahead point
+ * @return The distance along the path from the robot to the end
+ */
+double PurePursuit::estimate_remaining_dist(const Path &path, pose_t robot_pose, point_t lookahead, int lookahead_seg,
+                                            double radius) {
+  const std::vector<point_t> &points = path.get_points();
+  if (points.size() < 2 || lookahead == points.back()) {
+    return points.empty() ? 0 : robot_pose.get_point().dist(points.back());
+  }
+
+  // The lookahead point is one radius away from the robot in a straight line. Search twice that along the path
+  // behind it so the robot is still found on tight curves.
+  const std::vector<double> &cumulative_dist = path.get_cumulative_dist();
+  double lookahead_s = cumulative_dist[lookahead_seg] + points[lookahead_seg].dist(lookahead);
+  double robot_s = path.progress_of(robot_pose.get_point(), lookahead_s - (2 * radius), lookahead_s);
+
+  return path.get_length() - robot_s;
+}
\ No newline at end of file
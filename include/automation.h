@@ -53,11 +53,12 @@ private:
   int radius;
 };
 
-void gps_localize_median();
-std::tuple<pose_t, double> gps_localize_stdev();
-
 enum FieldSide { RED, BLUE };
 
+void gps_localize_median(FieldSide side = RED);
+std::tuple<pose_t, double> gps_localize_stdev(FieldSide side = RED);
+uint32_t measure_gps_latency_us(FieldSide side = RED, double seconds = 10);
+
 class GPSLocalizeCommand : public AutoCommand {
 public:
   GPSLocalizeCommand(FieldSide s);
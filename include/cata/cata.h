@@ -1,4 +1,5 @@
 #pragma once
+#include "../core/include/subsystems/sensor_bus.h"
 #include "../core/include/utils/controls/pidff.h"
 #include "cata/common.h"
 #include "vex.h"
@@ -35,6 +36,8 @@ public:
   CataOnlySys(vex::pot &cata_pot, vex::optical &cata_watcher, vex::motor_group &cata_motor, PIDFF &cata_pid,
               DropMode drop, vex::pneumatics &l_endgame_sol, vex::pneumatics &r_endgame_sol, vex::pneumatics &cata_sol);
   bool intaking_allowed();
+  bool ball_in_cata() const;
+  void use_sensor_bus(SensorBus &bus);
 
 private:
   vex::pot &pot;
@@ -42,4 +45,6 @@ private:
   vex::motor_group &mot;
   PIDFF &pid;
   vex::pneumatics &l_endgame_sol, &r_endgame_sol, &cata_sol;
+  SensorChannel pot_angle;
+  SensorChannel ball_near;
 };
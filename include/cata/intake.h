@@ -1,3 +1,4 @@
+#include "../core/include/subsystems/sensor_bus.h"
 #include "cata/common.h"
 #include "vex.h"
 #include <../core/include/utils/state_machine.h>
@@ -35,7 +36,8 @@ public:
   IntakeSys(vex::distance &intake_watcher, vex::motor &intake_lower, vex::motor &intake_upper,
             std::function<bool()> can_intake, std::function<bool()> ball_in_cata, DropMode drop);
 
-  bool ball_in_intake();
+  bool ball_in_intake() const;
+  void use_sensor_bus(SensorBus &bus);
 
 private:
   vex::distance &intake_watcher;
@@ -43,4 +45,5 @@ private:
   vex::motor &intake_upper;
   std::function<bool()> can_intake;
   std::function<bool()> ball_in_cata;
+  SensorChannel intake_dist_mm;
 };
@@ -32,6 +32,8 @@ public:
   bool still_dropping();
   bool ball_in_intake();
   bool intake_running();
+  // Read the cata and intake sensors through a sensor bus from now on
+  void use_sensor_bus(SensorBus &bus);
 
   CataOnlyState get_cata_state();
   IntakeState get_intake_state();
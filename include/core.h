@@ -7,8 +7,16 @@
 #include "../core/include/subsystems/mecanum_drive.h"
 #include "../core/include/subsystems/odometry/odometry_3wheel.h"
 #include "../core/include/subsystems/odometry/odometry_base.h"
+#include "../core/include/subsystems/odometry/odometry_calibration.h"
+#include "../core/include/subsystems/odometry/odometry_ekf.h"
+#include "../core/include/subsystems/odometry/odometry_holonomic.h"
+#include "../core/include/subsystems/odometry/odometry_kinematics.h"
+#include "../core/include/subsystems/odometry/odometry_particle_filter.h"
+#include "../core/include/subsystems/odometry/odometry_recorder.h"
 #include "../core/include/subsystems/odometry/odometry_tank.h"
+#include "../core/include/subsystems/odometry/particle_filter.h"
 #include "../core/include/subsystems/screen.h"
+#include "../core/include/subsystems/sensor_bus.h"
 #include "../core/include/subsystems/tank_drive.h"
 
 // Utils package
@@ -20,11 +28,15 @@
 #include "../core/include/utils/command_structure/flywheel_commands.h"
 
 #include "../core/include/utils/auto_chooser.h"
+#include "../core/include/utils/baked_path.h"
+#include "../core/include/utils/derivative_estimator.h"
 #include "../core/include/utils/generic_auto.h"
 #include "../core/include/utils/geometry.h"
 #include "../core/include/utils/graph_drawer.h"
+#include "../core/include/utils/least_squares.h"
 #include "../core/include/utils/math_util.h"
 #include "../core/include/utils/moving_average.h"
+#include "../core/include/utils/path_blob.h"
 
 #include "../core/include/utils/controls/bang_bang.h"
 #include "../core/include/utils/controls/feedback_base.h"
@@ -34,6 +46,9 @@
 #include "../core/include/utils/controls/take_back_half.h"
 
 #include "../core/include/utils/controls/motion_controller.h"
+#include "../core/include/utils/controls/motion_profile.h"
+#include "../core/include/utils/controls/profile_table.h"
+#include "../core/include/utils/controls/scurve_profile.h"
 
 #include "../core/include/utils/controls/trapezoid_profile.h"
 #include "../core/include/utils/pure_pursuit.h"
@@ -33,7 +33,10 @@ extern motor cata_r;
 extern motor cata_l;
 
 // ================ SUBSYSTEMS ================
-extern OdometryTank odom;
+extern SensorBus sensor_bus;
+extern OdometryTank odom_wheels;
+extern OdometryEKF::ekf_cfg_t ekf_cfg;
+extern OdometryEKF odom;
 extern TankDrive drive_sys;
 
 extern CataSys cata_sys;
@@ -53,9 +56,11 @@ extern motor_group intake_motors;
 extern motor_group cata_motors;
 
 extern robot_specs_t robot_cfg;
+extern uint32_t gps_latency_us, vision_latency_us;
 extern MotionController drive_mc_fast, drive_mc_slow, turn_mc;
+extern TankDrive::ramsete_cfg_t ramsete_cfg;
 extern PID drive_pid;
-extern OdometryTank odom;
+extern OdometryEKF odom;
 extern TankDrive drive_sys;
 extern CataSys cata_sys;
 
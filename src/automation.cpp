@@ -133,7 +133,8 @@ bool VisionObjectExists::test() {
 
 // DOES NOT WORK, DO NOT USE!
 point_t estimate_triball_pos(vision::object &obj) {
-  pose_t robot_pose = odom.get_position();
+  // Where the robot was when the camera took the picture, not where it is now
+  pose_t robot_pose = odom.get_position_at(vex::timer::systemHighResolution() - vision_latency_us);
 
   double area = obj.width * obj.height;
   double dist = 3721 * pow(area, -0.634);                                    // Estimate found by spreadsheet
@@ -173,9 +174,29 @@ bool IsTriballInArea::test() {
 
 #define NUM_DATAPOINTS 100
 #define GPS_GATHER_SEC 1.0
+#define GPS_LATENCY_MAX_MS 100
+#define GPS_LATENCY_STEP_MS 5
+
+/**
+ * Turn a GPS reading, in inches from the field's corner, into the frame odometry uses on this side of the field.
+ * BLUE sees the field turned 180 degrees. gps_sensor is set up with turnType::left, so its heading already turns the
+ * same way as odometry's
+ */
+static pose_t gps_to_side(pose_t gps_pose, FieldSide side) {
+  if (side == BLUE) {
+    return {.x = 144 - gps_pose.x, .y = 144 - gps_pose.y, .rot = gps_pose.rot + 180};
+  }
+  return gps_pose;
+}
 
-std::vector<pose_t> gps_gather_data() {
+/**
+ * Sample the GPS for GPS_GATHER_SEC, in the frame odometry uses on this side of the field. Each sample is moved by
+ * however far odometry says the robot travelled between when the GPS measured it and the end of gathering, so they
+ * all describe where the robot is now. Odometry's movement is in its own frame, so the samples are turned first.
+ */
+std::vector<pose_t> gps_gather_data(FieldSide side) {
   std::vector<pose_t> pose_list;
+  std::vector<uint64_t> time_list;
   vex::timer tmr;
 
   // for(int i = 0; i < NUM_DATAPOINTS; i++)
@@ -185,13 +206,56 @@ std::vector<pose_t> gps_gather_data() {
     cur.y = gps_sensor.yPosition(distanceUnits::in) + 72;
     cur.rot = gps_sensor.heading(rotationUnits::deg);
 
-    pose_list.push_back(cur);
+    pose_list.push_back(gps_to_side(cur, side));
+    time_list.push_back(vex::timer::systemHighResolution() - gps_latency_us);
     vexDelay(1);
   }
 
+  pose_t now = odom.get_position();
+  for (int i = 0; i < pose_list.size(); i++) {
+    pose_t then = odom.get_position_at(time_list[i]);
+    pose_list[i].x += now.x - then.x;
+    pose_list[i].y += now.y - then.y;
+    pose_list[i].rot += OdometryBase::smallest_angle(then.rot, now.rot);
+  }
+
   return pose_list;
 }
 
+/**
+ * Measure gps_latency_us: while the robot drives around (by hand is fine), compare each GPS reading against where
+ * odometry says the robot was at every delay from 0 to GPS_LATENCY_MAX_MS, and return the delay they agree best at.
+ * Localize odometry first, and keep the robot moving; standing still, every delay agrees equally well.
+ */
+uint32_t measure_gps_latency_us(FieldSide side, double seconds) {
+  const int num_delays = (GPS_LATENCY_MAX_MS / GPS_LATENCY_STEP_MS) + 1;
+  double error_sum[num_delays] = {0};
+  vex::timer tmr;
+
+  while (tmr.time(sec) < seconds) {
+    uint64_t now_us = vex::timer::systemHighResolution();
+    pose_t reading = {.x = gps_sensor.xPosition(distanceUnits::in) + 72,
+                      .y = gps_sensor.yPosition(distanceUnits::in) + 72,
+                      .rot = gps_sensor.heading(rotationUnits::deg)};
+    reading = gps_to_side(reading, side);
+
+    for (int i = 0; i < num_delays; i++) {
+      pose_t then = odom.get_position_at(now_us - ((uint64_t)i * GPS_LATENCY_STEP_MS * 1000));
+      error_sum[i] += reading.get_point().dist(then.get_point());
+    }
+    vexDelay(20);
+  }
+
+  int best = 0;
+  for (int i = 1; i < num_delays; i++) {
+    if (error_sum[i] < error_sum[best]) {
+      best = i;
+    }
+  }
+  printf("GPS latency: %d ms\n", best * GPS_LATENCY_STEP_MS);
+  return best * GPS_LATENCY_STEP_MS * 1000;
+}
+
 void sort_by_distance_to_origin(std::vector<pose_t> &pose_list) {
   std::sort(pose_list.begin(), pose_list.end(), [](pose_t a, pose_t b) {
     point_t origin = {0, 0};
@@ -218,8 +282,8 @@ pose_t get_pose_avg(std::vector<pose_t> pose_list) {
   return avg;
 }
 
-void gps_localize_median() {
-  auto pose_list = gps_gather_data();
+void gps_localize_median(FieldSide side) {
+  auto pose_list = gps_gather_data(side);
   sort_by_distance_to_origin(pose_list);
 
   pose_t median;
@@ -231,8 +295,8 @@ void gps_localize_median() {
   printf("MEDIAN {%.2f, %.2f, %.2f}\n", median.x, median.y, median.rot);
 }
 
-std::tuple<pose_t, double> gps_localize_stdev() {
-  auto pose_list = gps_gather_data();
+std::tuple<pose_t, double> gps_localize_stdev(FieldSide side) {
+  auto pose_list = gps_gather_data(side);
 
   pose_t avg_unfiltered = get_pose_avg(pose_list);
   point_t avg_point = avg_unfiltered.get_point();
@@ -271,13 +335,7 @@ const int GPSLocalizeCommand::min_rotation_radius = 48;
 bool GPSLocalizeCommand::run() {
   // pose_t odom_pose = odom.get_position();
   vexDelay(500); // Let GPS settle
-  auto [new_pose, stddev] = gps_localize_stdev();
-
-  if (side == BLUE) {
-    new_pose.x = 144 - new_pose.x;
-    new_pose.y = 144 - new_pose.y;
-    new_pose.rot = new_pose.rot + 180;
-  }
+  auto [new_pose, stddev] = gps_localize_stdev(side);
 
   odom.set_position(new_pose);
 
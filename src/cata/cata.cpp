@@ -5,11 +5,11 @@ bool intake_can_be_enabled(double cata_pos) {
   return (cata_pos == 0.0) || (cata_pos > inake_enable_lower_threshold && cata_pos < intake_enable_upper_threshold);
 }
 bool CataOnlySys::intaking_allowed() {
-  double cata_pos = pot.angle(vex::deg);
+  double cata_pos = pot_angle.get();
 
   return (
     // (cata_pos == 0.0) || (cata_pos > inake_enable_lower_threshold && cata_pos < intake_enable_upper_threshold) &&
-                           !cata_watcher.isNearObject()
+                           !ball_in_cata()
   );
 }
 
@@ -39,7 +39,7 @@ private:
 struct Reloading : public CataOnlySys::State {
   void entry(CataOnlySys &sys) override {
 
-    sys.pid.update(sys.pot.angle(vex::deg));
+    sys.pid.update(sys.pot_angle.get());
     sys.pid.set_target(cata_target_charge);
     sys.l_endgame_sol.close();
     sys.r_endgame_sol.close();
@@ -48,7 +48,7 @@ struct Reloading : public CataOnlySys::State {
 
   CataOnlySys::MaybeMessage work(CataOnlySys &sys) override {
     // work on motor
-    double cata_deg = sys.pot.angle(vex::deg);
+    double cata_deg = sys.pot_angle.get();
     if (cata_deg == 0.0) {
       // adc hasnt warmed up yet, we're getting silly results
       return {};
@@ -79,7 +79,7 @@ public:
 
   CataOnlySys::MaybeMessage work(CataOnlySys &sys) override {
     // started goin up again
-    if (sys.pot.angle(vex::deg) > done_firing_angle) {
+    if (sys.pot_angle.get() > done_firing_angle) {
       return CataOnlyMessage::DoneFiring;
     }
     return {};
@@ -96,7 +96,7 @@ public:
 class ReadyToFire : public CataOnlySys::State {
 public:
   CataOnlySys::MaybeMessage work(CataOnlySys &sys) override {
-    double cata_deg = sys.pot.angle(vex::degrees);
+    double cata_deg = sys.pot_angle.get();
     sys.pid.update(cata_deg);
     sys.mot.spin(vex::fwd, sys.pid.get(), vex::volt);
 
@@ -124,7 +124,7 @@ class PrimeClimb : public CataOnlySys::State {
   };
 
   CataOnlySys::MaybeMessage work(CataOnlySys &sys) override {
-    double ang = sys.pot.angle(vex::deg);
+    double ang = sys.pot_angle.get();
 
     if(ang < cata_target_extension)
       sys.mot.spin(vex::directionType::fwd, 12, vex::volt);
@@ -155,7 +155,7 @@ class ClimbHold : public CataOnlySys::State {
   };
 
   CataOnlySys::MaybeMessage work(CataOnlySys &sys) override {
-    double ang = sys.pot.angle(vex::deg);
+    double ang = sys.pot_angle.get();
 
     if(ang > cata_target_charge)
       sys.mot.spin(vex::directionType::rev, 12, vex::volt);
@@ -201,7 +201,7 @@ CataOnlySys::State *Reloading::respond(CataOnlySys &sys, CataOnlyMessage m) {
   } else if (m == CataOnlyMessage::DisableCata) {
     return new CataOff();
   } else if (m == CataOnlyMessage::Fire) {
-    if (sys.cata_watcher.isNearObject()) {
+    if (sys.ball_in_cata()) {
       return new Firing();
     } else {
       return this;
@@ -214,7 +214,7 @@ CataOnlySys::State *Reloading::respond(CataOnlySys &sys, CataOnlyMessage m) {
 }
 CataOnlySys::State *ReadyToFire::respond(CataOnlySys &sys, CataOnlyMessage m) {
   if (m == CataOnlyMessage::Fire) {
-    if (sys.cata_watcher.isNearObject()) {
+    if (sys.ball_in_cata()) {
       return new Firing();
     } else {
       return this;
@@ -314,4 +314,13 @@ CataOnlySys::CataOnlySys(
     : StateMachine(
         (drop == DropMode::Required) ? (CataOnlySys::State *)(new CataOff()) : (CataOnlySys::State *)(new Reloading())
       ),
-      pot(cata_pot), cata_watcher(cata_watcher), mot(cata_motor), pid(cata_pid), l_endgame_sol(l_endgame_sol), r_endgame_sol(r_endgame_sol), cata_sol(cata_sol) {}
+      pot(cata_pot), cata_watcher(cata_watcher), mot(cata_motor), pid(cata_pid), l_endgame_sol(l_endgame_sol), r_endgame_sol(r_endgame_sol), cata_sol(cata_sol),
+      pot_angle([&cata_pot]() { return cata_pot.angle(vex::deg); }),
+      ball_near([&cata_watcher]() { return (double)cata_watcher.isNearObject(); }) {}
+
+bool CataOnlySys::ball_in_cata() const { return ball_near.get() != 0; }
+
+void CataOnlySys::use_sensor_bus(SensorBus &bus) {
+  pot_angle.use_sensor_bus(bus);
+  ball_near.use_sensor_bus(bus);
+}
@@ -4,9 +4,9 @@
 // INTAKE
 // ==============================================================================================================================
 
-bool IntakeSys::ball_in_intake() {
-  return intake_watcher.objectDistance(vex::distanceUnits::mm) < intake_sensor_dist_mm;
-}
+bool IntakeSys::ball_in_intake() const { return intake_dist_mm.get() < intake_sensor_dist_mm; }
+
+void IntakeSys::use_sensor_bus(SensorBus &bus) { intake_dist_mm.use_sensor_bus(bus); }
 std::string to_string(IntakeState s) {
   switch (s) {
   case IntakeState::Dropping:
@@ -217,4 +217,5 @@ IntakeSys::IntakeSys(
         drop == DropMode::Required ? (IntakeSys::State *)(new IntakeWaitForDrop()) : (IntakeSys::State *)(new Stopped())
       ),
       intake_watcher(intake_watcher), intake_lower(intake_lower), intake_upper(intake_upper), can_intake(can_intake),
-      ball_in_cata(ball_in_cata) {}
+      ball_in_cata(ball_in_cata),
+      intake_dist_mm([&intake_watcher]() { return intake_watcher.objectDistance(vex::distanceUnits::mm); }) {}
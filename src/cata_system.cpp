@@ -10,7 +10,7 @@ CataSys::CataSys(
       cata_sys(cata_pot, cata_watcher, cata_motor, cata_feedback, drop, l_endgame_sol, r_endgame_sol, cata_sol),
       intake_sys(
         intake_watcher, intake_lower, intake_upper, [&]() { return cata_sys.intaking_allowed(); },
-        [&]() { return cata_watcher.isNearObject(); }, drop
+        [&]() { return cata_sys.ball_in_cata(); }, drop
       ) {}
 
 void CataSys::send_command(Command next_cmd) {
@@ -56,6 +56,11 @@ void CataSys::send_command(Command next_cmd) {
   }
 }
 
+void CataSys::use_sensor_bus(SensorBus &bus) {
+  cata_sys.use_sensor_bus(bus);
+  intake_sys.use_sensor_bus(bus);
+}
+
 bool CataSys::intake_running() { return !(intake_sys.current_state() == IntakeState::Stopped); }
 
 bool CataSys::still_dropping() {
@@ -82,14 +87,15 @@ public:
     IntakeState intake_state = cs.intake_sys.current_state();
     std::string intake_str = to_string(intake_state);
 
-    gd.add_samples({cs.cata_pot.angle(vex::deg), cs.cata_sys.pid.get_target()});
-    const bool ball_in_intake = cs.intake_watcher.objectDistance(distanceUnits::mm) < intake_sensor_dist_mm;
+    const double cata_deg = cs.cata_sys.pot_angle.get();
+    gd.add_samples({cata_deg, cs.cata_sys.pid.get_target()});
+    const bool ball_in_intake = cs.intake_sys.ball_in_intake();
 
-    const bool ball_in_cata = cs.cata_watcher.isNearObject();
+    const bool ball_in_cata = cs.cata_sys.ball_in_cata();
 
     // Show it all
     scr.printAt(40, 20, true, "Cata: %s", cata_str.c_str());
-    scr.printAt(40, 60, true, "pot: %.2f", cs.cata_pot.angle(vex::degrees));
+    scr.printAt(40, 60, true, "pot: %.2f", cata_deg);
     scr.printAt(40, 100, true, "Intake: %s", intake_str.c_str());
     scr.printAt(40, 120, true, "Cata Temp: %.0fC", cs.cata_motor.temperature(vex::temperatureUnits::celsius));
 
@@ -136,7 +142,7 @@ AutoCommand *CataSys::IntakeToHold() {
 }
 
 AutoCommand *CataSys::WaitForIntake() {
-  return new FunctionCommand([&]() { return cata_watcher.isNearObject(); });
+  return new FunctionCommand([&]() { return cata_sys.ball_in_cata(); });
 }
 
 AutoCommand *CataSys::WaitForHold() {
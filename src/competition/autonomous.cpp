@@ -135,6 +135,9 @@ void awp_auto() {
     vexDelay(100);
   }
 
+  // The GPS sees the field turned around from the blue side
+  ekf_cfg.gps_field_rot_deg = (SIDE == BLUE) ? 180 : 0;
+
   static std::atomic<bool> end_vision_scan(false);
   // clang-format off
   DebugCommand *tempend = new DebugCommand();
@@ -194,9 +197,8 @@ void awp_auto() {
     drive_sys.DriveForwardCmd(drive_pid, 18, FWD, 0.9)->withCancelCondition(drive_sys.DriveStalledCondition(0.2)),
     cata_sys.StopIntake(),
 
-    // Reverse & localize
+    // Reverse. odom fuses the GPS the whole time, so there's no need to stop and localize here (136, 36 ish)
     drive_sys.DriveForwardCmd(drive_pid, 8, REV, 0.9)->withCancelCondition(drive_sys.DriveStalledCondition(0.2)),
-    new GPSLocalizeCommand(SIDE), // 136, 36 ish
 
     // ================ GRN TRIBALL 1-2 ================
     // Drive to position
@@ -154,6 +154,13 @@ MotionController::m_profile_cfg_t drive_mc_slow_cfg = {
   .ff_cfg = drive_mc_ff_cfg};
 MotionController drive_mc_slow(drive_mc_slow_cfg);
 
+// Ramsete trajectory following, for RamseteCmd. Tuned with tools/benchmark/ramsete_bench: a b well above the usual
+// 2 rad^2/m^2 (0.0013 rad^2/in^2) is what keeps it on the path when one side of the drive is weaker than the ff thinks
+TankDrive::ramsete_cfg_t ramsete_cfg = {
+  .b = 0.02,
+  .zeta = 0.7,
+};
+
 MotionController::m_profile_cfg_t turn_mc_cfg{
   .max_v = 520, // 520 deg/sec max
   .accel = 400, // 900 deg/sec2 max
@@ -179,6 +186,7 @@ robot_specs_t robot_cfg = {
   .odom_gear_ratio = .6667,
   .dist_between_wheels = 10.45, // inches
   .drive_correction_cutoff = 4, // inches
+  .drive_max_vel = 55,          // in/sec at 100%, same as drive_mc_fast
   .drive_feedback = &drive_mc_fast,
   .turn_feedback = &turn_mc, // new PID(turn_pid_cfg),
   .correction_pid = (PID::pid_config_t){
@@ -196,7 +204,35 @@ FeedForward::ff_config_t ffc = {.kG = -2};
 
 PIDFF cata_pid(pc, ffc);
 
-OdometryTank odom{left_motors, right_motors, robot_cfg, &imu};
+// How long after the GPS and the vision sensor measure something we read it (us), so latency compensation looks up
+// where the robot was then. Measure the GPS's with measure_gps_latency_us(). The vision sensor sends 50 frames a
+// second, so its readings are up to a frame old
+uint32_t gps_latency_us = 20000;
+uint32_t vision_latency_us = 20000;
+
+// Reads every subsystem's sensors once per 10ms. Use sensor_bus(10, false) to count reads/s without it, and see
+// tools/benchmark/sensor_bus_bench.cpp for both on a computer
+SensorBus sensor_bus(10);
+
+// Wheels and IMU, run by odom rather than in their own task
+OdometryTank odom_wheels{left_motors, right_motors, robot_cfg, &imu, false};
+
+OdometryEKF::ekf_cfg_t ekf_cfg = {
+  .fwd_var_per_in = 0.01,
+  .side_var_per_in = 0.002,
+  .rot_var_per_rad = 0.001,
+  .gps_pos_stddev = 1.0, // inches, at 100% quality
+  .gps_rot_stddev = 2.0, // degrees, at 100% quality
+  .gps_min_quality = 50,
+  .gps_interval_ms = 50,
+  .gps_gate = 16.3,           // 99.9% of good readings pass
+  .gps_field_rot_deg = 0,     // set for the side at the start of the auto
+  .gps_turn = turnType::left, // as gps_sensor is constructed above
+  .gps_zero_rot_deg = 0,      // its heading reads odometry's rotation directly, as gps_to_side() uses it
+};
+
+// Wheel odometry corrected by the GPS, continuously
+OdometryEKF odom{odom_wheels, ekf_cfg, &gps_sensor, &imu};
 TankDrive drive_sys(left_motors, right_motors, robot_cfg, &odom);
 CataSys cata_sys(
   intake_watcher, cata_pot, cata_watcher, cata_motors, intake_combine, intake_roller, cata_pid, DropMode::Unnecessary, l_endgame_sol, r_endgame_sol, cata_sol
@@ -219,10 +255,26 @@ void robot_init() {
     new screen::OdometryPage(odom, 12, 12, true),
     cata_sys.Page(),
     new screen::StatsPage(motor_names),
-    new VideoPlayer()
+    new VideoPlayer(),
+    new screen::FunctionPage(
+      [](bool, int, int) {},
+      [](vex::brain::lcd &scr, bool, unsigned int) {
+        scr.printAt(40, 40, true, "Sensor reads/s: %lu", (unsigned long)sensor_bus.get_reads_per_sec());
+      }
+    )
   };
 
   screen::start_screen(Brain.Screen, pages, 4);
+
+  // Plan the usual turns before the match, so turn_to_heading doesn't have to when it starts
+  const double common_turns_deg[] = {45, 90, 135, 180};
+  for (double turn_deg : common_turns_deg) {
+    turn_mc.precompute(turn_deg);
+  }
+
+  odom_wheels.use_sensor_bus(sensor_bus);
+  drive_sys.use_sensor_bus(sensor_bus);
+  cata_sys.use_sensor_bus(sensor_bus);
   imu.calibrate();
  
   l_endgame_sol.set(false);
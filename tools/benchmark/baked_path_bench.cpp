@@ -0,0 +1,87 @@
+/**
+ * Accuracy check and benchmark for the compile-time path baking in baked_path.h.
+ *
+ * Bakes a few paths with bake_hermite() / bake_inject() and compares every point against smooth_path_hermite() /
+ * inject_path() on the same waypoints, then times building the runtime version, which is what a routine skips by
+ * baking. The baked tables are static_asserted on as well, so they're known to be computed by the compiler.
+ *
+ * Build (from the repository root):
+ *   g++ -std=gnu++17 -O2 -Itools/host -Iinclude -o baked_path_bench tools/benchmark/baked_path_bench.cpp \
+ *       core/src/utils/pure_pursuit.cpp core/src/utils/math_util.cpp core/src/utils/vector2d.cpp
+ *
+ * Output is CSV:
+ *   match,path,function,points,max_diff_in,ok
+ *   benchmark,path,runtime_us
+ * The exit code is the number of paths that didn't match.
+ */
+#include "../../core/include/utils/baked_path.h"
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+
+using namespace PurePursuit;
+
+// An S across the field and a tight hook, like the autonomous routines drive
+static constexpr hermite_point s_curve[] = {{12, 12, 0, 60}, {60, 36, 1.2, 60}, {100, 100, 0.3, 80}, {132, 120, 0, 40}};
+static constexpr hermite_point hook[] = {{24, 24, 1.57, 30}, {30, 48, 0.8, 30}, {48, 40, -1.57, 40}};
+
+static constexpr auto s_curve_smoothed = bake_hermite<20>(s_curve);
+static constexpr auto s_curve_injected =
+    bake_inject<inject_count(s_curve_smoothed.points, 1)>(s_curve_smoothed.points, 1);
+static constexpr auto hook_smoothed = bake_hermite<10>(hook);
+static constexpr auto hook_injected = bake_inject<inject_count(hook_smoothed.points, 0.5)>(hook_smoothed.points, 0.5);
+
+// These only compile if the tables were computed at compile time
+static_assert(s_curve_smoothed[0].x == 12 && s_curve_smoothed[60].x == 132, "hermite endpoints");
+static_assert(hook_injected.size() == inject_count(hook_smoothed.points, 0.5), "injected size");
+
+// Keeps the optimizer from throwing away results
+static volatile double sink;
+
+/**
+ * Largest distance between matching points, or infinity if the sizes differ
+ */
+template <size_t N> static double max_diff(const baked_path_t<N> &baked, const std::vector<point_t> &runtime) {
+  if (runtime.size() != N) {
+    return INFINITY;
+  }
+  double worst = 0;
+  for (size_t i = 0; i < N; i++) {
+    worst = fmax(worst, baked[i].dist(runtime[i]));
+  }
+  return worst;
+}
+
+template <size_t W, size_t S, size_t I>
+static int check(const char *name, const hermite_point (&waypoints)[W], int steps, double spacing,
+                 const baked_path_t<S> &smoothed, const baked_path_t<I> &injected) {
+  const double tolerance = 1e-9;
+  std::vector<hermite_point> waypoint_vec(waypoints, waypoints + W);
+  std::vector<point_t> runtime_smoothed = smooth_path_hermite(waypoint_vec, steps);
+  std::vector<point_t> runtime_injected = inject_path(runtime_smoothed, spacing);
+
+  double smoothed_diff = max_diff(smoothed, runtime_smoothed);
+  double injected_diff = max_diff(injected, runtime_injected);
+  printf("match,%s,hermite,%zu,%.2g,%s\n", name, S, smoothed_diff, smoothed_diff < tolerance ? "ok" : "FAIL");
+  printf("match,%s,inject,%zu,%.2g,%s\n", name, I, injected_diff, injected_diff < tolerance ? "ok" : "FAIL");
+
+  const int reps = 20000;
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < reps; r++) {
+    std::vector<point_t> built = inject_path(smooth_path_hermite(waypoint_vec, steps), spacing);
+    sink = built.back().x;
+  }
+  double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / reps;
+  printf("benchmark,%s,%.2f\n", name, us);
+
+  return (smoothed_diff < tolerance ? 0 : 1) + (injected_diff < tolerance ? 0 : 1);
+}
+
+int main() {
+  int failed = 0;
+  printf("match,path,function,points,max_diff_in,ok\n");
+  printf("benchmark,path,runtime_us\n");
+  failed += check("s_curve", s_curve, 20, 1, s_curve_smoothed, s_curve_injected);
+  failed += check("hook", hook, 10, 0.5, hook_smoothed, hook_injected);
+  return failed;
+}
@@ -0,0 +1,265 @@
+/**
+ * Benchmark for odometry speed and acceleration: the least squares fit odometry now uses (PoseDerivativeEstimator)
+ * against the estimators it replaced.
+ *
+ * The old estimators are copied here. The tank one differenced the pose every 0.02 seconds and ran the speed through
+ * an ExponentialMovingAverage(3); the 3-wheel one differenced every 0.1 seconds with no smoothing. Both took the
+ * acceleration as the change in speed between two updates. Their angular speed is copied with its sign turned back to
+ * CCW positive: the old code took smallest_angle(now, then), which made it clockwise.
+ *
+ * Each estimator is given the same 1ms stream of poses from a synthetic trajectory, with the position quantized to an
+ * encoder tick and gaussian noise added on top, the way wheel odometry is noisy:
+ * - trapezoid: speed up to 40 in/s at 80 in/s^2, cruise, slow down and sit
+ * - sine:      speed rises and falls smoothly between 0 and 40 in/s once a second
+ * - turn:      rotation swings +-90 degrees every 2 seconds, in place
+ *
+ * Each estimate is compared against the truth: rms is the error as read, and lag_ms is how far the truth would have to
+ * be delayed to match the estimate best, searched in 1ms steps. rms_at_lag is the error left once the lag is taken out,
+ * which is just the noise.
+ *
+ * Build (from the repository root):
+ *   g++ -std=gnu++17 -O2 -Itools/host -Iinclude -o derivative_bench tools/benchmark/derivative_bench.cpp \
+ *       core/src/utils/derivative_estimator.cpp core/src/utils/moving_average.cpp
+ *
+ * Output is CSV:
+ *   derivative,trajectory,quantity,estimator,rms,lag_ms,rms_at_lag
+ * lag_ms is the 150ms search limit if the estimate never lined up better inside it.
+ */
+#include "../../core/include/utils/derivative_estimator.h"
+#include "../../core/include/utils/moving_average.h"
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <vector>
+
+static const double dt = 0.001;                  // odometry update period (sec)
+static const double tick_in = 2.75 * M_PI / 360; // one encoder tick on a 2.75" wheel (in)
+static const double tick_deg = 0.01;             // IMU resolution (deg)
+static const double pos_noise = 0.005;           // position noise on top of the tick (in)
+static const double rot_noise = 0.02;            // rotation noise on top of the resolution (deg)
+static const double settle = 0.2;                // time given to every estimator to fill up before scoring (sec)
+static const int max_lag_ms = 150;
+
+/**
+ * What every estimator reports after each sample
+ */
+typedef struct {
+  double speed;
+  double accel;
+  double ang_speed;
+  double ang_accel;
+} estimate_t;
+
+/**
+ * The estimator OdometryTank and Odometry3Wheel used before, unchanged apart from the angular speed's sign
+ */
+class DifferenceEstimator {
+public:
+  DifferenceEstimator(double period, int ema_size) : period(period), ema_size(ema_size), speed_ema(ema_size) {}
+
+  estimate_t add_sample(const pose_t &pos) {
+    if (!initialized) {
+      last_vel_pos = pos;
+      initialized = true;
+    }
+
+    vel_time += dt;
+    if (vel_time > period) {
+      double this_speed = hypot(pos.x - last_vel_pos.x, pos.y - last_vel_pos.y) / vel_time;
+      if (ema_size > 0) {
+        speed_ema.add_entry(this_speed);
+        out.speed = speed_ema.get_value();
+      } else {
+        out.speed = this_speed;
+      }
+      out.accel = (out.speed - last_speed) / vel_time;
+      out.ang_speed = -smallest_angle(pos.rot, last_vel_pos.rot) / vel_time;
+      out.ang_accel = (out.ang_speed - last_ang_speed) / vel_time;
+
+      vel_time = 0;
+      last_vel_pos = pos;
+      last_speed = out.speed;
+      last_ang_speed = out.ang_speed;
+    }
+    return out;
+  }
+
+private:
+  /**
+   * OdometryBase::smallest_angle, copied so this doesn't need the odometry task
+   */
+  static double smallest_angle(double start_deg, double end_deg) {
+    double retval = fmod(end_deg - start_deg, 360.0);
+    if (retval < 0) {
+      retval += 360.0;
+    }
+    return (retval > 180) ? retval - 360.0 : retval;
+  }
+
+  double period;
+  int ema_size;
+  ExponentialMovingAverage speed_ema;
+  bool initialized = false;
+  pose_t last_vel_pos = {0, 0, 0};
+  double vel_time = 0;
+  double last_speed = 0, last_ang_speed = 0;
+  estimate_t out = {0, 0, 0, 0};
+};
+
+/**
+ * The estimator odometry uses now, with its default window
+ */
+class FitEstimator {
+public:
+  estimate_t add_sample(const pose_t &pos) {
+    time += dt;
+    motion.add_sample(time, pos);
+    return {motion.get_speed(), motion.get_accel(), motion.get_angular_speed_deg(), motion.get_angular_accel_deg()};
+  }
+
+private:
+  PoseDerivativeEstimator motion;
+  double time = 0;
+};
+
+/**
+ * A trajectory sampled every dt: the true pose, and the true speed and acceleration of each quantity
+ */
+typedef struct {
+  std::vector<pose_t> pos;
+  std::vector<estimate_t> truth;
+} trajectory_t;
+
+/**
+ * Drive straight along 30 degrees, with speed and acceleration given as functions of time
+ */
+template <typename SpeedFn, typename AccelFn>
+static trajectory_t straight(double duration, SpeedFn speed_at, AccelFn accel_at) {
+  trajectory_t out;
+  double dist = 0;
+  double heading = 30 * M_PI / 180;
+  for (double t = 0; t < duration; t += dt) {
+    double v = speed_at(t), a = accel_at(t);
+    dist += (v * dt) + (0.5 * a * dt * dt);
+    out.pos.push_back({dist * cos(heading), dist * sin(heading), 30});
+    out.truth.push_back({speed_at(t + dt), accel_at(t + dt), 0, 0});
+  }
+  return out;
+}
+
+static trajectory_t trapezoid() {
+  const double max_v = 40, max_a = 80, ramp = max_v / max_a;
+  auto accel_at = [=](double t) {
+    if (t < ramp) {
+      return max_a;
+    } else if (t < ramp + 1) {
+      return 0.0;
+    } else if (t < (2 * ramp) + 1) {
+      return -max_a;
+    }
+    return 0.0;
+  };
+  auto speed_at = [=](double t) {
+    if (t < ramp) {
+      return max_a * t;
+    } else if (t < ramp + 1) {
+      return max_v;
+    } else if (t < (2 * ramp) + 1) {
+      return max_v - (max_a * (t - ramp - 1));
+    }
+    return 0.0;
+  };
+  return straight((2 * ramp) + 1.5, speed_at, accel_at);
+}
+
+static trajectory_t sine() {
+  const double w = 2 * M_PI;
+  auto speed_at = [=](double t) { return 20 * (1 - cos(w * t)); };
+  auto accel_at = [=](double t) { return 20 * w * sin(w * t); };
+  return straight(3, speed_at, accel_at);
+}
+
+static trajectory_t turn() {
+  trajectory_t out;
+  const double w = M_PI;
+  for (double t = 0; t < 4; t += dt) {
+    double next = t + dt;
+    out.pos.push_back({24, 24, fmod((90 * sin(w * next)) + 360, 360)});
+    out.truth.push_back({0, 0, 90 * w * cos(w * next), -90 * w * w * sin(w * next)});
+  }
+  return out;
+}
+
+/**
+ * What odometry would read: the pose rounded to the sensors' resolution, plus noise
+ */
+static std::vector<pose_t> measure(const std::vector<pose_t> &truth) {
+  std::mt19937 rng(1);
+  std::normal_distribution<double> noise(0, 1);
+  std::vector<pose_t> out;
+  for (const pose_t &p : truth) {
+    out.push_back({(round(p.x / tick_in) * tick_in) + (pos_noise * noise(rng)),
+                   (round(p.y / tick_in) * tick_in) + (pos_noise * noise(rng)),
+                   (round(p.rot / tick_deg) * tick_deg) + (rot_noise * noise(rng))});
+  }
+  return out;
+}
+
+/**
+ * RMS difference between the estimate and the truth delayed by lag samples, after the settling time
+ */
+static double rms(const std::vector<double> &estimate, const std::vector<double> &truth, int lag) {
+  double sum = 0;
+  int n = 0;
+  for (size_t i = (size_t)(settle / dt); i < estimate.size(); i++) {
+    double err = estimate[i] - truth[i - lag];
+    sum += err * err;
+    n++;
+  }
+  return sqrt(sum / n);
+}
+
+static void score(const char *trajectory, const char *quantity, const char *estimator,
+                  const std::vector<double> &estimate, const std::vector<double> &truth) {
+  int best_lag = 0;
+  double best = rms(estimate, truth, 0);
+  for (int lag = 1; lag <= max_lag_ms; lag++) {
+    double r = rms(estimate, truth, lag);
+    if (r < best) {
+      best = r;
+      best_lag = lag;
+    }
+  }
+  printf("derivative,%s,%s,%s,%.3f,%d,%.3f\n", trajectory, quantity, estimator, rms(estimate, truth, 0), best_lag,
+         best);
+}
+
+template <typename Estimator>
+static void run(const char *name, const trajectory_t &traj, Estimator estimator, const char *trajectory,
+                bool angular) {
+  std::vector<pose_t> measured = measure(traj.pos);
+  std::vector<double> speed, accel, true_speed, true_accel;
+  for (size_t i = 0; i < measured.size(); i++) {
+    estimate_t e = estimator.add_sample(measured[i]);
+    speed.push_back(angular ? e.ang_speed : e.speed);
+    accel.push_back(angular ? e.ang_accel : e.accel);
+    true_speed.push_back(angular ? traj.truth[i].ang_speed : traj.truth[i].speed);
+    true_accel.push_back(angular ? traj.truth[i].ang_accel : traj.truth[i].accel);
+  }
+  score(trajectory, angular ? "ang_speed" : "speed", name, speed, true_speed);
+  score(trajectory, angular ? "ang_accel" : "accel", name, accel, true_accel);
+}
+
+static void compare(const char *trajectory, const trajectory_t &traj, bool angular) {
+  run("old_tank", traj, DifferenceEstimator(0.02, 3), trajectory, angular);
+  run("old_3wheel", traj, DifferenceEstimator(0.1, 0), trajectory, angular);
+  run("least_squares", traj, FitEstimator(), trajectory, angular);
+}
+
+int main() {
+  printf("derivative,trajectory,quantity,estimator,rms,lag_ms,rms_at_lag\n");
+  compare("trapezoid", trapezoid(), false);
+  compare("sine", sine(), false);
+  compare("turn", turn(), true);
+  return 0;
+}
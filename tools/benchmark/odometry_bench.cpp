@@ -0,0 +1,156 @@
+/**
+ * Benchmark and drift check for the odometry pose integration.
+ *
+ * Compares integrate_arc() (the exact arc / SE(2) exponential map now used by OdometryTank and Odometry3Wheel) with
+ * the straight line polar round trip Odometry3Wheel used before it:
+ *  - time per update, in ns and (on x86) TSC cycles
+ *  - how far each ends up from the true position after driving synthetic constant curvature arcs in many small ticks
+ *
+ * Also times everything OdometryHolonomic::integrate() does per update besides reading the sensors: the wheel
+ * kinematics plus the speed / acceleration fit.
+ *
+ * Build (from the repository root):
+ *   g++ -std=gnu++17 -O2 -Itools/host -Iinclude -o odometry_bench tools/benchmark/odometry_bench.cpp \
+ *       core/src/utils/math_util.cpp core/src/utils/vector2d.cpp \
+ *       core/src/subsystems/odometry/odometry_kinematics.cpp core/src/utils/derivative_estimator.cpp
+ *
+ * Output is CSV:
+ *   benchmark,ns_per_op,cycles_per_op        (timing)
+ *   drift,method,radius,ticks,error_in       (drift)
+ */
+#include "../../core/include/subsystems/odometry/odometry_kinematics.h"
+#include "../../core/include/utils/derivative_estimator.h"
+#include "../../core/include/utils/math_util.h"
+#include "../../core/include/utils/vector2d.h"
+#include <chrono>
+#include <stdio.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC
+#endif
+
+// Keeps the optimizer from throwing away results
+static volatile double sink;
+
+/**
+ * The integration Odometry3Wheel used before integrate_arc: a straight line in the old heading's direction, built by
+ * converting the local displacement to polar and back
+ */
+static pose_t integrate_polar(const pose_t &old_pos, double dist_fwd, double dist_side, double delta_rot_rad) {
+  Vector2D local_displacement(point_t{dist_side, dist_fwd});
+  double dir_delta_from_trans_rad = local_displacement.get_dir() - (M_PI / 2.0);
+  double global_dir_rad = wrap_angle_rad(dir_delta_from_trans_rad + deg2rad(old_pos.rot));
+  Vector2D global_displacement(global_dir_rad, local_displacement.get_mag());
+
+  Vector2D new_pos_vec = Vector2D(point_t{old_pos.x, old_pos.y}) + global_displacement;
+  return {new_pos_vec.get_x(), new_pos_vec.get_y(), wrap_angle_deg(old_pos.rot + rad2deg(delta_rot_rad))};
+}
+
+typedef pose_t (*integrator_t)(const pose_t &, double, double, double);
+
+/**
+ * Time many small updates, like the odometry loop makes
+ */
+static void bench(const char *name, integrator_t integrate) {
+  const int iters = 20000000;
+  pose_t pos = {0, 0, 90};
+
+  auto start = std::chrono::steady_clock::now();
+#ifdef HAVE_TSC
+  unsigned long long start_tsc = __rdtsc();
+#endif
+  for (int i = 0; i < iters; i++) {
+    pos = integrate(pos, 0.05, 0.001 * (i & 1), 0.0005);
+  }
+#ifdef HAVE_TSC
+  double cycles = (double)(__rdtsc() - start_tsc) / iters;
+#else
+  double cycles = 0;
+#endif
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iters;
+  sink = pos.x + pos.y;
+
+  printf("%s,%.2f,%.1f\n", name, ns, cycles);
+}
+
+/**
+ * Time one OdometryHolonomic update: wheel distances through holonomic_kinematics, then the derivative fit.
+ *
+ * The background task has no fixed rate; it updates again as soon as the sensors have been read. Samples here are 10ms
+ * apart so that each one starts a new slot in the fit's window. Closer samples would overwrite the newest slot, but
+ * the fit covers the same full window either way, so an update costs the same at any spacing.
+ */
+static void bench_holonomic_update() {
+  const int iters = 2000000;
+  const double fwd_wheel_offset = 4.5, side_wheel_offset = -2.0;
+  pose_t pos = {0, 0, 90};
+  PoseDerivativeEstimator motion;
+
+  auto start = std::chrono::steady_clock::now();
+#ifdef HAVE_TSC
+  unsigned long long start_tsc = __rdtsc();
+#endif
+  for (int i = 0; i < iters; i++) {
+    double delta_rot_rad = 0.0005 * (i & 3);
+    pos = holonomic_kinematics(pos, 0.05, 0.02, delta_rot_rad, fwd_wheel_offset, side_wheel_offset);
+    motion.add_sample(i * 0.01, pos);
+  }
+#ifdef HAVE_TSC
+  double cycles = (double)(__rdtsc() - start_tsc) / iters;
+#else
+  double cycles = 0;
+#endif
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iters;
+  sink = pos.x + pos.y + motion.get_speed();
+
+  printf("holonomic_update,%.2f,%.1f\n", ns, cycles);
+}
+
+/**
+ * Drive a quarter circle of the given radius in equal ticks, with the side wheel seeing a constant slip,
+ * and return how far the integrated position ends up from the true one
+ */
+static double drift(integrator_t integrate, double radius, int ticks) {
+  const double arc_angle = M_PI / 2;
+  const double slip_per_rad = 2.0; // inches sideways per radian turned, as a strafing robot would see
+
+  double fwd = radius * arc_angle / ticks;
+  double side = slip_per_rad * arc_angle / ticks;
+  double turn = arc_angle / ticks;
+
+  pose_t pos = {0, 0, 90};
+  for (int i = 0; i < ticks; i++) {
+    pos = integrate(pos, fwd, side, turn);
+  }
+
+  // Reference: the same motion in a million straight steps along each step's middle heading
+  const int ref_steps = 1000000;
+  double x = 0, y = 0, heading = M_PI / 2;
+  for (int i = 0; i < ref_steps; i++) {
+    double mid = heading + arc_angle / ref_steps / 2;
+    double step_fwd = radius * arc_angle / ref_steps;
+    double step_side = slip_per_rad * arc_angle / ref_steps;
+    x += step_fwd * cos(mid) + step_side * sin(mid);
+    y += step_fwd * sin(mid) - step_side * cos(mid);
+    heading += arc_angle / ref_steps;
+  }
+  return hypot(pos.x - x, pos.y - y);
+}
+
+int main() {
+  printf("benchmark,ns_per_op,cycles_per_op\n");
+  bench("integrate_polar", integrate_polar);
+  bench("integrate_arc", integrate_arc);
+  bench_holonomic_update();
+
+  printf("\ndrift,method,radius,ticks,error_in\n");
+  const double radii[] = {6, 24, 72};
+  const int tick_counts[] = {10, 100, 1000};
+  for (double radius : radii) {
+    for (int ticks : tick_counts) {
+      printf("drift,polar,%g,%d,%.3g\n", radius, ticks, drift(integrate_polar, radius, ticks));
+      printf("drift,arc,%g,%d,%.3g\n", radius, ticks, drift(integrate_arc, radius, ticks));
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,189 @@
+/**
+ * Convergence check for odometry calibration (odometry_calibration.h).
+ *
+ * Drives a synthetic robot with known measurements through a run of straights, turns, arcs and (for 3 tracking wheels)
+ * strafes, stopping at a known position after each one. The truth comes from the same kinematics odometry uses, so a
+ * perfect fit recovers the measurements exactly. The sensors are recorded the way OdometryRecorder does (tank sides in
+ * raw revolutions, before the gear ratio), written out with format_calibration_* and read back with
+ * parse_calibration_line, with noise on the references and IMU. Each fit starts from guesses 8% off.
+ *
+ * Build (from the repository root):
+ *   g++ -std=gnu++17 -O2 -Itools/host -Iinclude -o odometry_calibration_bench \
+ *       tools/benchmark/odometry_calibration_bench.cpp core/src/subsystems/odometry/odometry_calibration.cpp \
+ *       core/src/subsystems/odometry/odometry_kinematics.cpp core/src/utils/least_squares.cpp \
+ *       core/src/utils/math_util.cpp core/src/utils/vector2d.cpp
+ *
+ * Output is CSV:
+ *   calibration,robot,imu,value,true,guess,fitted,err_pct,iterations,rms_end,ok
+ * The exit code is the number of fits that didn't converge or ended more than 1% from a true value (2% for
+ * off_axis_center_dist, which only shows in how far the off-axis wheel spins while turning).
+ */
+#include "../../core/include/subsystems/odometry/odometry_calibration.h"
+#include "../../core/include/subsystems/odometry/odometry_kinematics.h"
+#include "../../core/include/utils/math_util.h"
+#include <math.h>
+#include <random>
+#include <stdio.h>
+
+static const double dt = 0.01;           // sample period (sec)
+static const double ref_pos_noise = 0.1; // how far off the references are (in)
+static const double ref_rot_noise = 0.3; // how far off the reference rotations are (deg)
+static const double imu_noise = 0.05;    // IMU noise per sample (deg)
+
+// True measurements of the tank drive
+static const double tank_wheel_diam = 3.25, tank_gear_ratio = 0.6, tank_dist_between_wheels = 11.5;
+// True measurements of the 3 tracking wheel robot
+static const double tw_wheel_diam = 2.75, tw_wheelbase_dist = 5.5, tw_off_axis_center_dist = 3.25;
+
+/**
+ * One part of the run: how fast each wheel moves (in/s) and for how long, then a stop at a known position
+ */
+typedef struct {
+  double duration;
+  double lside, rside, offax;
+} segment_t;
+
+static const segment_t run[] = {
+    {1.5, 30, 30, 0},   // straight
+    {0.8, 20, -20, 0},  // turn in place
+    {2.0, 30, 15, 0},   // wide arc
+    {1.0, -25, -25, 0}, // reverse
+    {1.2, -15, 15, 0},  // turn in place the other way
+    {1.5, 10, 35, 0},   // tight arc
+    {1.0, 0, 0, 25},    // strafe (the tank drive doesn't see offax)
+    {1.0, 20, 20, -15}, // drive and strafe
+    {0.6, -20, 20, 10}, // turn and strafe
+    {1.0, 30, 30, 0},   // straight
+    {0.9, 25, -25, 0},  // turn in place
+    {1.5, -20, -10, 0}, // reverse arc
+};
+
+static std::mt19937 rng(1);
+static std::normal_distribution<double> gaussian(0, 1);
+
+/**
+ * Write a sample out and read it back, the way a saved recording would be
+ */
+static void record(calibration_log_t &log, const calibration_sample_t &sample) {
+  char line[128];
+  format_calibration_sample(line, sizeof(line), sample);
+  parse_calibration_line(line, log);
+}
+
+/**
+ * Mark the robot's true position, with some noise, at the sample just recorded
+ */
+static void mark(calibration_log_t &log, const pose_t &truth) {
+  pose_t measured = {truth.x + ref_pos_noise * gaussian(rng), truth.y + ref_pos_noise * gaussian(rng),
+                     wrap_angle_deg(truth.rot + ref_rot_noise * gaussian(rng))};
+  calibration_reference_t ref = {-1, measured, true, true};
+  char line[128];
+  format_calibration_reference(line, sizeof(line), ref);
+  parse_calibration_line(line, log);
+}
+
+/**
+ * Drive the tank drive through the run, recording raw revolutions and the IMU
+ */
+static calibration_log_t tank_run(bool has_imu) {
+  calibration_log_t log;
+  pose_t pos = {0, 0, 90};
+  double ltotal = 0, rtotal = 0;
+
+  record(log, {0, 0, 0, has_imu, 0});
+  log.references.push_back({0, pos, true, true});
+
+  for (const segment_t &seg : run) {
+    // Drive, then sit still for a moment at the end
+    for (double t = 0; t < seg.duration + 0.2; t += dt) {
+      double ldist = (t < seg.duration) ? seg.lside * dt : 0;
+      double rdist = (t < seg.duration) ? seg.rside * dt : 0;
+      ltotal += ldist;
+      rtotal += rdist;
+      double angle = tank_encoder_angle(ltotal, rtotal, tank_dist_between_wheels);
+      pos = tank_kinematics(pos, ldist, rdist, wrap_angle_deg(angle));
+
+      double to_raw_revs = tank_gear_ratio / (M_PI * tank_wheel_diam);
+      double imu_deg = -(angle - 90) + imu_noise * gaussian(rng);
+      record(log, {ltotal * to_raw_revs, rtotal * to_raw_revs, 0, has_imu, has_imu ? imu_deg : 0});
+    }
+    mark(log, pos);
+  }
+  return log;
+}
+
+/**
+ * Drive the 3 tracking wheel robot through the run, recording encoder degrees and the IMU
+ */
+static calibration_log_t three_wheel_run(bool has_imu) {
+  calibration_log_t log;
+  pose_t pos = {0, 0, 90};
+  double ltotal = 0, rtotal = 0, offtotal = 0, turned = 0;
+
+  record(log, {0, 0, 0, has_imu, 0});
+  log.references.push_back({0, pos, true, true});
+
+  for (const segment_t &seg : run) {
+    for (double t = 0; t < seg.duration + 0.2; t += dt) {
+      double ldist = (t < seg.duration) ? seg.lside * dt : 0;
+      double rdist = (t < seg.duration) ? seg.rside * dt : 0;
+      double offdist = (t < seg.duration) ? seg.offax * dt : 0;
+      ltotal += ldist;
+      rtotal += rdist;
+      offtotal += offdist;
+      pose_t next = three_wheel_kinematics(pos, ldist, rdist, offdist, tw_wheelbase_dist, tw_off_axis_center_dist);
+      turned += wrap_angle_deg(next.rot - pos.rot + 180) - 180;
+      pos = next;
+
+      double to_deg = 360 / (M_PI * tw_wheel_diam);
+      double imu_deg = -turned + imu_noise * gaussian(rng);
+      record(log, {ltotal * to_deg, rtotal * to_deg, offtotal * to_deg, has_imu, has_imu ? imu_deg : 0});
+    }
+    mark(log, pos);
+  }
+  return log;
+}
+
+/**
+ * Print one fitted value and check it's within tolerance_pct of the truth
+ */
+static bool check(const char *robot, bool has_imu, const char *name, double truth, double guess, double fitted,
+                  const calibration_result_t &result, double tolerance_pct = 1) {
+  double err_pct = 100 * fabs(fitted - truth) / truth;
+  bool ok = result.fit.converged && err_pct < tolerance_pct;
+  printf("calibration,%s,%d,%s,%g,%g,%.4f,%.3f,%d,%.3f,%s\n", robot, has_imu ? 1 : 0, name, truth, guess, fitted,
+         err_pct, result.fit.iterations, result.fit.rms_end, ok ? "ok" : "FAIL");
+  return ok;
+}
+
+int main() {
+  const double off = 1.08;
+  int failed = 0;
+  printf("calibration,robot,imu,value,true,guess,fitted,err_pct,iterations,rms_end,ok\n");
+
+  for (bool has_imu : {false, true}) {
+    calibration_log_t log = tank_run(has_imu);
+    double gear_ratio = tank_gear_ratio * off, dist_between_wheels = tank_dist_between_wheels * off;
+    calibration_result_t result = calibrate_tank(log, tank_wheel_diam, gear_ratio, dist_between_wheels);
+    failed += !check("tank", has_imu, "odom_gear_ratio", tank_gear_ratio, tank_gear_ratio * off, gear_ratio, result);
+    // With an IMU the rotation doesn't depend on dist_between_wheels, so there's nothing to fit it to
+    if (!has_imu) {
+      failed += !check("tank", has_imu, "dist_between_wheels", tank_dist_between_wheels,
+                       tank_dist_between_wheels * off, dist_between_wheels, result);
+    }
+  }
+
+  for (bool has_imu : {false, true}) {
+    calibration_log_t log = three_wheel_run(has_imu);
+    double wheel_diam = tw_wheel_diam * off, wheelbase_dist = tw_wheelbase_dist * off;
+    double off_axis_center_dist = tw_off_axis_center_dist * off;
+    calibration_result_t result = calibrate_three_wheel(log, wheel_diam, wheelbase_dist, off_axis_center_dist);
+    failed += !check("3wheel", has_imu, "wheel_diam", tw_wheel_diam, tw_wheel_diam * off, wheel_diam, result);
+    failed += !check("3wheel", has_imu, "wheelbase_dist", tw_wheelbase_dist, tw_wheelbase_dist * off,
+                     wheelbase_dist, result);
+    failed += !check("3wheel", has_imu, "off_axis_center_dist", tw_off_axis_center_dist,
+                     tw_off_axis_center_dist * off, off_axis_center_dist, result, 2);
+  }
+
+  return failed;
+}
@@ -0,0 +1,194 @@
+/**
+ * Host check of OdometryEKF against a simulated robot, with the sensors reading the way the real ones do: the IMU's
+ * rotation is clockwise, and the GPS reports inches from the center of the field. On the blue side the GPS sees the
+ * field turned 180 degrees. Every case runs with two GPS setups:
+ * - compass: the default turnType::right, facing forward, so its heading is a compass heading (0 = +y, clockwise)
+ * - left:    turnType::left, reading odometry's rotation directly, the way the robot's gps_sensor is set up
+ *
+ * - turn: turn in place from facing -x (180) to facing +y (90), with the IMU and GPS both measuring it. The IMU reads
+ *   the turn 2% short, so the filtered heading only ends up at 90 if the GPS heading is understood and not thrown out
+ *   for disagreeing.
+ * - accuracy: 15 seconds of arcs with wheels that read 3% long and turn 5% too far, with a noisy GPS, and every 2
+ *   seconds a reading 40 inches off. Reports how far the filter and the wheels alone end up from the truth.
+ *
+ * Build (from the repository root):
+ *   g++ -std=gnu++17 -O2 -Itools/host -Iinclude -o odometry_ekf_bench tools/benchmark/odometry_ekf_bench.cpp \
+ *       core/src/subsystems/odometry/odometry_ekf.cpp core/src/subsystems/odometry/odometry_base.cpp \
+ *       core/src/subsystems/odometry/pose_history.cpp core/src/utils/math_util.cpp core/src/utils/vector2d.cpp
+ *
+ * Output is CSV:
+ *   turn,side,gps,true_rot,ekf_rot,error_deg,ok
+ *   accuracy,side,gps,ekf_error_in,ekf_max_error_in,ekf_rot_error_deg,wheel_error_in,ekf_stddev_in
+ * The exit code is the number of checks that failed.
+ */
+#include "../../core/include/subsystems/odometry/odometry_ekf.h"
+#include "../../core/include/utils/math_util.h"
+#include "../../core/include/utils/vector2d.h"
+#include <math.h>
+#include <random>
+#include <stdio.h>
+
+/**
+ * How a GPS is set up: the turnType it was constructed with, and what it reads when the robot faces odometry's 0
+ */
+typedef struct {
+  const char *name;
+  vex::turnType turn;
+  double zero_rot_deg;
+} gps_setup_t;
+
+static const gps_setup_t gps_setups[] = {{"compass", vex::turnType::right, 90}, {"left", vex::turnType::left, 0}};
+
+/**
+ * Wheel odometry that integrates whatever motion it's given, scaled by its calibration error
+ */
+class SimWheels : public OdometryBase {
+public:
+  SimWheels(pose_t start, double dist_scale, double turn_scale)
+      : OdometryBase(false), dist_scale(dist_scale), turn_scale(turn_scale) {
+    current_pos = start;
+    publish();
+  }
+
+  pose_t update() override {
+    double rot = current_pos.rot + (turn_deg * turn_scale);
+    double mid_rad = deg2rad((current_pos.rot + rot) / 2.0);
+    current_pos.x += fwd * dist_scale * cos(mid_rad);
+    current_pos.y += fwd * dist_scale * sin(mid_rad);
+    current_pos.rot = wrap_angle_deg(rot);
+    publish();
+    return current_pos;
+  }
+
+  double fwd = 0, turn_deg = 0; ///< this tick's true motion
+
+private:
+  double dist_scale, turn_scale;
+};
+
+/**
+ * The robot, its sensors and the filter, stepped 1ms at a time
+ */
+class Sim {
+public:
+  Sim(pose_t start, double field_rot_deg, const gps_setup_t &setup, double dist_scale, double turn_scale)
+      : truth(start), start_rot(start.rot), field_rot_deg(field_rot_deg), setup(setup),
+        wheels(start, dist_scale, turn_scale),
+        cfg{0.01, 0.002, 0.001, 1.0, 2.0, 50, 50, 16.3, field_rot_deg, setup.turn, setup.zero_rot_deg},
+        ekf(wheels, cfg, &gps_sensor, &imu, false) {
+    ekf.set_position(start);
+    read_sensors(0, 0, 0);
+  }
+
+  /**
+   * Move the robot, update what the sensors read, and run the filter
+   */
+  void step(double fwd, double turn_deg, double gps_pos_noise, double gps_rot_noise, double gps_blunder = 0) {
+    vex::sim::time_us += 1000;
+
+    double rot = truth.rot + turn_deg;
+    double mid_rad = deg2rad((truth.rot + rot) / 2.0);
+    truth.x += fwd * cos(mid_rad);
+    truth.y += fwd * sin(mid_rad);
+    truth.rot = rot;
+
+    wheels.fwd = fwd;
+    wheels.turn_deg = turn_deg;
+    read_sensors(gps_pos_noise, gps_rot_noise, gps_blunder);
+    ekf.update();
+  }
+
+  pose_t truth;
+  double start_rot;
+  double field_rot_deg;
+  gps_setup_t setup;
+  SimWheels wheels;
+  vex::inertial imu;
+  vex::gps gps_sensor;
+  OdometryEKF::ekf_cfg_t cfg;
+  OdometryEKF ekf;
+  double imu_scale = 1; ///< how much of the true rotation the IMU reads
+  std::mt19937 rng{1};
+
+private:
+  void read_sensors(double gps_pos_noise, double gps_rot_noise, double gps_blunder) {
+    std::normal_distribution<double> noise(0, 1);
+
+    // The IMU starts at 0 and reads clockwise
+    imu.rotation_deg = -(truth.rot - start_rot) * imu_scale;
+
+    // The GPS sees the field turned by -field_rot_deg, from the center. Its heading counts from its zero, in the
+    // direction it was set up to turn
+    point_t from_center = {truth.x - 72, truth.y - 72};
+    point_t seen = Mat2::FromRotationDegrees(-field_rot_deg) * from_center;
+    gps_sensor.x_in = seen.x + (gps_pos_noise * noise(rng)) + gps_blunder;
+    gps_sensor.y_in = seen.y + (gps_pos_noise * noise(rng));
+    double from_zero = truth.rot - field_rot_deg - setup.zero_rot_deg;
+    double heading = ((setup.turn == vex::turnType::left) ? from_zero : -from_zero) + (gps_rot_noise * noise(rng));
+    gps_sensor.heading_deg = fmod(fmod(heading, 360) + 360, 360);
+    gps_sensor.quality_pct = 90;
+  }
+};
+
+/**
+ * Turn 90 degrees right in place over a second with perfect wheels and a short IMU, then sit for a second
+ */
+static int turn_check(const char *side, double field_rot_deg, const gps_setup_t &setup) {
+  Sim sim({36, 36, 180}, field_rot_deg, setup, 1, 1);
+  sim.imu_scale = 0.98;
+  for (int i = 0; i < 1000; i++) {
+    sim.step(0, -0.09, 0, 0);
+  }
+  for (int i = 0; i < 1000; i++) {
+    sim.step(0, 0, 0, 0);
+  }
+
+  double ekf_rot = sim.ekf.get_position().rot;
+  double error = OdometryBase::smallest_angle(sim.truth.rot, ekf_rot);
+  bool ok = fabs(error) < 0.5;
+  printf("turn,%s,%s,%.2f,%.2f,%.3f,%s\n", side, setup.name, sim.truth.rot, ekf_rot, error, ok ? "ok" : "FAIL");
+  return ok ? 0 : 1;
+}
+
+/**
+ * Drive arcs left then right at 30 in/s with miscalibrated wheels and a noisy, occasionally wrong GPS
+ */
+static void accuracy(const char *side, double field_rot_deg, const gps_setup_t &setup) {
+  Sim sim({36, 36, 90}, field_rot_deg, setup, 1.03, 1.05);
+  double max_error = 0;
+  for (int i = 0; i < 15000; i++) {
+    double turn_deg = (i < 7500) ? 0.02 : -0.035;
+    double blunder = (i % 2000 == 1000) ? 40 : 0;
+    sim.step(0.03, turn_deg, 1.0, 2.0, blunder);
+
+    pose_t pos = sim.ekf.get_position();
+    // Give the filter the first 2 seconds to settle
+    if (i > 2000) {
+      max_error = fmax(max_error, hypot(pos.x - sim.truth.x, pos.y - sim.truth.y));
+    }
+  }
+
+  pose_t pos = sim.ekf.get_position();
+  pose_t wheel_pos = sim.wheels.get_position();
+  printf("accuracy,%s,%s,%.2f,%.2f,%.2f,%.2f,%.2f\n", side, setup.name, hypot(pos.x - sim.truth.x, pos.y - sim.truth.y),
+         max_error, OdometryBase::smallest_angle(sim.truth.rot, pos.rot),
+         hypot(wheel_pos.x - sim.truth.x, wheel_pos.y - sim.truth.y), sim.ekf.get_position_stddev());
+}
+
+int main() {
+  vex::sim::use_sim_time = true;
+  int failed = 0;
+
+  printf("turn,side,gps,true_rot,ekf_rot,error_deg,ok\n");
+  for (const gps_setup_t &setup : gps_setups) {
+    failed += turn_check("red", 0, setup);
+    failed += turn_check("blue", 180, setup);
+  }
+
+  printf("\naccuracy,side,gps,ekf_error_in,ekf_max_error_in,ekf_rot_error_deg,wheel_error_in,ekf_stddev_in\n");
+  for (const gps_setup_t &setup : gps_setups) {
+    accuracy("red", 0, setup);
+    accuracy("blue", 180, setup);
+  }
+  return failed;
+}
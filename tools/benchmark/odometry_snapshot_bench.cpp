@@ -0,0 +1,178 @@
+/**
+ * Stress test for OdometryBase's snapshot: one writer updating at 1ms, like the odometry task, against readers
+ * copying the position in tight loops, like drive commands, conditions and the screen.
+ *
+ * Every update writes a state whose fields all come from one counter, so a reader that sees fields from two different
+ * updates has a torn read. Readers either go through get_snapshot() (the sequence lock), take the mutex and copy the
+ * fields the way get_position() / get_speed() / get_accel() each did before, or look up the past with get_history_at(),
+ * the way latency compensation does. History lookups sweep from 10ms ago to the oldest entry, which is the one add()
+ * overwrites. The writer always holds the mutex for update(), as
+ * background_task() does, and records how long each update took from taking the lock to releasing it.
+ *
+ * Build (from the repository root):
+ *   g++ -std=gnu++17 -O2 -Itools/host -Iinclude -o odometry_snapshot_bench \
+ *       tools/benchmark/odometry_snapshot_bench.cpp core/src/subsystems/odometry/odometry_base.cpp \
+ *       core/src/subsystems/odometry/pose_history.cpp core/src/utils/math_util.cpp core/src/utils/vector2d.cpp \
+ *       -lpthread
+ *
+ * Output is CSV:
+ *   stress,readers,reader,updates,reads,torn,update_mean_us,update_p99_us,update_max_us,period_stddev_us
+ * The exit code is the number of torn reads.
+ */
+#include "../../core/include/subsystems/odometry/odometry_base.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+using std::chrono::steady_clock;
+
+/**
+ * Odometry whose every field is a function of how many updates it has made
+ */
+class StressOdometry : public OdometryBase {
+public:
+  StressOdometry() : OdometryBase(false) {}
+
+  pose_t update() override {
+    count++;
+    double n = (double)count;
+    current_pos = {n, 2 * n, fmod(n, 360)};
+    speed = 3 * n;
+    accel = -n;
+    ang_speed_deg = 4 * n;
+    ang_accel_deg = 5 * n;
+    publish();
+    return current_pos;
+  }
+
+  /**
+   * Copy the state under the mutex, as the getters did before the snapshot
+   */
+  odometry_snapshot_t get_locked() {
+    mut.lock();
+    odometry_snapshot_t out = {current_pos, speed, accel, ang_speed_deg, ang_accel_deg, 0};
+    mut.unlock();
+    return out;
+  }
+
+  /**
+   * One update the way background_task() runs it
+   */
+  void locked_update() {
+    mut.lock();
+    update();
+    mut.unlock();
+  }
+
+private:
+  uint64_t count = 0;
+};
+
+/**
+ * True if the fields came from more than one update
+ */
+static bool is_torn(const odometry_snapshot_t &s) {
+  double n = s.pos.x;
+  return s.pos.y != 2 * n || s.pos.rot != fmod(n, 360) || s.speed != 3 * n || s.accel != -n ||
+         s.ang_speed_deg != 4 * n || s.ang_accel_deg != 5 * n;
+}
+
+/**
+ * True if an entry wasn't interpolated between two whole updates. Interpolating keeps the fields in proportion, up to
+ * rounding. The starting position the history begins with is all zeros apart from the rotation, which isn't checked
+ */
+static bool is_torn(const pose_history_entry_t &e) {
+  double n = e.pos.x;
+  double tolerance = 1e-9 * fmax(1, fabs(n));
+  return fabs(e.pos.y - 2 * n) > tolerance || fabs(e.speed - 3 * n) > tolerance ||
+         fabs(e.ang_speed_deg - 4 * n) > tolerance;
+}
+
+enum class reader_t { mutex, snapshot, history };
+
+static const char *reader_names[] = {"mutex", "snapshot", "history"};
+
+static int stress(int num_readers, reader_t reader) {
+  const int updates = 2000;
+  StressOdometry odom;
+  // The starting position doesn't follow the pattern
+  odom.locked_update();
+  std::atomic<bool> done(false);
+  std::atomic<long> reads(0), torn(0);
+
+  std::vector<std::thread> readers;
+  for (int r = 0; r < num_readers; r++) {
+    readers.emplace_back([&]() {
+      long my_reads = 0, my_torn = 0;
+      while (!done) {
+        if (reader == reader_t::history) {
+          pose_history_entry_t e;
+          uint64_t age_us = 10000 + (my_reads % 128) * 10000;
+          if (odom.get_history_at(vex::timer::systemHighResolution() - age_us, e)) {
+            my_torn += is_torn(e) ? 1 : 0;
+          }
+        } else {
+          odometry_snapshot_t s = (reader == reader_t::snapshot) ? odom.get_snapshot() : odom.get_locked();
+          my_torn += is_torn(s) ? 1 : 0;
+        }
+        my_reads++;
+      }
+      reads += my_reads;
+      torn += my_torn;
+    });
+  }
+
+  std::vector<double> update_us, publish_times_us;
+  steady_clock::time_point start = steady_clock::now();
+  steady_clock::time_point next = start;
+  for (int i = 0; i < updates; i++) {
+    next += std::chrono::milliseconds(1);
+    std::this_thread::sleep_until(next);
+    steady_clock::time_point before = steady_clock::now();
+    odom.locked_update();
+    steady_clock::time_point after = steady_clock::now();
+    update_us.push_back(std::chrono::duration<double, std::micro>(after - before).count());
+    publish_times_us.push_back(std::chrono::duration<double, std::micro>(after - start).count());
+  }
+  done = true;
+  for (std::thread &t : readers) {
+    t.join();
+  }
+
+  double mean = 0;
+  for (double us : update_us) {
+    mean += us;
+  }
+  mean /= update_us.size();
+
+  double period_mean = (publish_times_us.back() - publish_times_us.front()) / (publish_times_us.size() - 1);
+  double period_var = 0;
+  for (size_t i = 1; i < publish_times_us.size(); i++) {
+    double period = publish_times_us[i] - publish_times_us[i - 1];
+    period_var += (period - period_mean) * (period - period_mean);
+  }
+  period_var /= publish_times_us.size() - 1;
+
+  std::sort(update_us.begin(), update_us.end());
+  printf("stress,%d,%s,%d,%ld,%ld,%.2f,%.2f,%.1f,%.1f\n", num_readers, reader_names[(int)reader], updates,
+         (long)reads, (long)torn, mean, update_us[(size_t)(0.99 * update_us.size())], update_us.back(),
+         sqrt(period_var));
+  return (int)torn;
+}
+
+int main() {
+  const int reader_counts[] = {1, 3, 8};
+  int torn = 0;
+
+  printf("stress,readers,reader,updates,reads,torn,update_mean_us,update_p99_us,update_max_us,period_stddev_us\n");
+  for (int readers : reader_counts) {
+    torn += stress(readers, reader_t::mutex);
+    torn += stress(readers, reader_t::snapshot);
+    torn += stress(readers, reader_t::history);
+  }
+  return torn;
+}
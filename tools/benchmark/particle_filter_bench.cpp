@@ -0,0 +1,175 @@
+/**
+ * Benchmark for the wall-distance particle filter (ParticleFilter), to pick how many particles and sensors the V5 can
+ * afford in the odometry loop.
+ *
+ * Runs on a computer against the same core sources the robot uses. Absolute numbers are much higher than the V5's
+ * Cortex-A9 will manage; compare runs on the same machine, and scale by a benchmark run on both.
+ *
+ * Build (from the repository root):
+ *   g++ -std=gnu++17 -O2 -Itools/host -Iinclude -o particle_filter_bench tools/benchmark/particle_filter_bench.cpp \
+ *       core/src/subsystems/odometry/particle_filter.cpp
+ *
+ * Output is CSV:
+ *   benchmark,particles,rays,ns_per_op,particle_rays_per_ms
+ *     ray_cast: one ray against every particle
+ *     update:   one full odometry update (predict, weigh every ray, resample, estimate)
+ *   accuracy,wheels,particles,rays,odom_error_in,filter_error_in,restarts,ok
+ *     where a simulated robot with miscalibrated wheels ends up after driving around the field, by odometry alone and
+ *     corrected by the filter, and how many times check_rotation() started the filter over
+ * The exit code is the number of accuracy runs where the filter ended up further off than odometry alone.
+ */
+#include "../../core/include/subsystems/odometry/particle_filter.h"
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+
+static const Rect field = {{0, 0}, {144, 144}};
+
+// Sensors on the left, right, back and front of a robot, in the order they're added
+static const ParticleFilter::ray_t mounts[4] = {
+    {-7, 0, (float)(M_PI / 2)}, {7, 0, (float)(-M_PI / 2)}, {0, -7, (float)M_PI}, {0, 7, 0}};
+
+// Keeps the optimizer from throwing away results
+static volatile float sink;
+
+static double elapsed_ns(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Time ray casts and whole updates
+ */
+static void bench(int particles, int rays) {
+  ParticleFilter pf(particles, field);
+  pf.reset({72, 72, 90}, 3, 3);
+
+  // Ray cast alone, on a fixed set of particles. It doesn't depend on the number of rays, so only time it once
+  if (rays == 1) {
+    std::vector<float> x(particles), y(particles), c(particles), s(particles), out(particles);
+    for (int i = 0; i < particles; i++) {
+      x[i] = 20 + (i * 7919) % 100;
+      y[i] = 20 + (i * 104729) % 100;
+      c[i] = cosf(i * 0.1f);
+      s[i] = sinf(i * 0.1f);
+    }
+    int casts = 20000000 / particles;
+    auto start = std::chrono::steady_clock::now();
+    for (int k = 0; k < casts; k++) {
+      ParticleFilter::ray_cast(x.data(), y.data(), c.data(), s.data(), particles, mounts[k % 4], field, out.data());
+      sink = out[k % particles];
+    }
+    double ns = elapsed_ns(start) / casts;
+    printf("ray_cast,%d,1,%.1f,%.0f\n", particles, ns, particles * 1e6 / ns);
+  }
+
+  // Whole update, as OdometryParticleFilter runs it with every sensor reading
+  int updates = 2000000 / particles;
+  auto start = std::chrono::steady_clock::now();
+  for (int k = 0; k < updates; k++) {
+    pf.predict(0.2, 0, 0.001, 0.02, 0.01, 0.001);
+    for (int r = 0; r < rays; r++) {
+      pf.weigh(mounts[r], 50, 0.5, 0.05);
+    }
+    pf.resample();
+    sink = pf.estimate().x;
+  }
+  double ns = elapsed_ns(start) / updates;
+  printf("update,%d,%d,%.1f,%.0f\n", particles, rays, ns, particles * rays * 1e6 / ns);
+}
+
+/**
+ * Distance from a sensor to the wall, for the simulated robot
+ */
+static float true_range(const pose_t &pos, const ParticleFilter::ray_t &ray) {
+  float x = pos.x, y = pos.y;
+  float c = cosf(pos.rot * M_PI / 180), s = sinf(pos.rot * M_PI / 180);
+  float out;
+  ParticleFilter::ray_cast(&x, &y, &c, &s, 1, ray, field, &out);
+  return out;
+}
+
+/**
+ * Drive laps of a rounded rectangle with wheels that misread the distance driven and the turns by the given scales,
+ * measuring the walls every 50 ms, and checking the rotation as OdometryParticleFilter does with the suggested
+ * settings
+ *
+ * @return true if the filter ended up no further off than odometry
+ */
+static bool accuracy(const char *wheels, double fwd_scale, double turn_scale, int particles, int rays) {
+  ParticleFilter pf(particles, field);
+  pose_t truth = {36, 36, 0};
+  pose_t odom = truth;
+  pf.reset(truth, 1, 2);
+
+  unsigned noise = 1;
+  int restarts = 0;
+  for (int tick = 0; tick < 6000; tick++) { // 60 seconds at 10 ms
+    // Straight for 2 seconds, then a 90 degree left turn for 0.8 seconds
+    double fwd = 0.3;
+    double turn = (tick % 280 >= 200) ? (M_PI / 2) / 80 : 0;
+
+    double mid = truth.rot * M_PI / 180 + turn / 2;
+    truth.x += fwd * cos(mid);
+    truth.y += fwd * sin(mid);
+    truth.rot += turn * 180 / M_PI;
+
+    // What the wheels measure
+    double odom_fwd = fwd * fwd_scale;
+    double odom_turn = turn * turn_scale;
+    double odom_mid = odom.rot * M_PI / 180 + odom_turn / 2;
+    odom.x += odom_fwd * cos(odom_mid);
+    odom.y += odom_fwd * sin(odom_mid);
+    odom.rot += odom_turn * 180 / M_PI;
+
+    double dist = fabs(odom_fwd);
+    pf.predict(odom_fwd, 0, odom_turn, sqrt(0.002 * dist), sqrt(0.001 * dist),
+               sqrt(0.01 * fabs(odom_turn) + 0.0002 * dist));
+
+    if (tick % 5 == 0) {
+      for (int r = 0; r < rays; r++) {
+        noise = noise * 1103515245 + 12345;
+        float reading = true_range(truth, mounts[r]) + ((int)((noise >> 16) % 1000) - 500) / 1000.0f;
+        pf.weigh(mounts[r], reading, 0.5, 0.05);
+      }
+      pf.resample();
+    }
+    restarts += pf.check_rotation(36, 12, 2, 3);
+  }
+
+  pose_t est = pf.estimate();
+  double odom_error = hypot(odom.x - truth.x, odom.y - truth.y);
+  double filter_error = hypot(est.x - truth.x, est.y - truth.y);
+  bool ok = filter_error <= odom_error;
+  printf("accuracy,%s,%d,%d,%.2f,%.2f,%d,%s\n", wheels, particles, rays, odom_error, filter_error, restarts,
+         ok ? "ok" : "FAIL");
+  return ok;
+}
+
+int main() {
+  const int particle_counts[] = {100, 250, 500, 1000, 2000};
+  const int ray_counts[] = {1, 2, 4};
+
+  printf("benchmark,particles,rays,ns_per_op,particle_rays_per_ms\n");
+  for (int particles : particle_counts) {
+    for (int rays : ray_counts) {
+      bench(particles, rays);
+    }
+  }
+
+  // Wheels that read long and over-turn, and wheels that read longer still and under-turn
+  struct {
+    const char *name;
+    double fwd_scale, turn_scale;
+  } wheels[] = {{"long", 1.03, 1.02}, {"longer_under_turn", 1.05, 0.97}};
+
+  int failed = 0;
+  printf("\naccuracy,wheels,particles,rays,odom_error_in,filter_error_in,restarts,ok\n");
+  for (auto &w : wheels) {
+    for (int particles : particle_counts) {
+      for (int rays : ray_counts) {
+        failed += !accuracy(w.name, w.fwd_scale, w.turn_scale, particles, rays);
+      }
+    }
+  }
+  return failed;
+}
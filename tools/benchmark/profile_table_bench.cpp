@@ -0,0 +1,100 @@
+/**
+ * Benchmark and accuracy check for following a motion profile from a ProfileTable instead of solving it every update.
+ *
+ * Times the setpoint step of MotionController::update() both ways, the only part of the update that changes (the PID
+ * and feedforward after it are the same either way):
+ *  - closed_form: TrapezoidProfile::calculate(), as MotionController did before
+ *  - table: ProfileTable::lookup() plus moving it to the movement's start and direction, as MotionController does now
+ * and how long building a table takes, which now happens once per movement instead.
+ *
+ * Build (from the repository root):
+ *   g++ -std=gnu++17 -O2 -Itools/host -Iinclude -o profile_table_bench tools/benchmark/profile_table_bench.cpp \
+ *       core/src/utils/controls/profile_table.cpp core/src/utils/controls/trapezoid_profile.cpp \
+ *       core/src/utils/math_util.cpp core/src/utils/vector2d.cpp
+ *
+ * Output is CSV:
+ *   benchmark,distance,ns_per_op
+ *   error,distance,max_pos_err,max_vel_err     (table against closed form, at times between the samples)
+ */
+#include "../../core/include/utils/controls/profile_table.h"
+#include "../../core/include/utils/controls/trapezoid_profile.h"
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+
+// Keeps the optimizer from throwing away results
+static volatile double sink;
+
+// The fast drive profile from robot-config
+static const double max_v = 55, accel = 180;
+static const double dt = 0.01;
+
+/**
+ * Time fn over a whole movement, ticking at a jittery 10ms like a control loop does, and return ns per tick
+ */
+template <typename F> static double time_ticks(double movement_time, F fn) {
+  const int reps = 20000;
+  int ticks = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < reps; r++) {
+    for (double t = 0; t < movement_time + 0.1; t += dt + 0.0001 * (ticks & 7)) {
+      fn(t);
+      ticks++;
+    }
+  }
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ticks;
+}
+
+int main() {
+  const double distances[] = {6, 24, 48, 96};
+
+  printf("benchmark,distance,ns_per_op\n");
+  for (double distance : distances) {
+    const double start_pt = -distance, end_pt = 0;
+
+    TrapezoidProfile closed(max_v, accel);
+    closed.set_endpts(start_pt, end_pt);
+    closed.calculate(0);
+    double movement_time = closed.get_movement_time();
+
+    printf("closed_form,%g,%.2f\n", distance, time_ticks(movement_time, [&](double t) {
+             motion_t m = closed.calculate(t);
+             sink = m.pos + m.vel + m.accel;
+           }));
+
+    TrapezoidProfile sampled(max_v, accel);
+    ProfileTable table;
+    table.build(sampled, end_pt - start_pt, dt);
+    double scale = (end_pt - start_pt) / table.get_distance();
+    printf("table,%g,%.2f\n", distance, time_ticks(movement_time, [&](double t) {
+             motion_t m = table.lookup(t);
+             sink = (start_pt + scale * m.pos) + (scale * m.vel) + (scale * m.accel);
+           }));
+
+    const int builds = 20000;
+    auto build_start = std::chrono::steady_clock::now();
+    for (int i = 0; i < builds; i++) {
+      table.build(sampled, end_pt - start_pt, dt);
+    }
+    double build_ns =
+        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - build_start).count() / builds;
+    printf("build,%g,%.2f\n", distance, build_ns);
+  }
+
+  printf("\nerror,distance,max_pos_err,max_vel_err\n");
+  for (double distance : distances) {
+    TrapezoidProfile closed(max_v, accel), sampled(max_v, accel);
+    closed.set_endpts(0, distance);
+    ProfileTable table;
+    table.build(sampled, distance, dt);
+
+    double max_pos_err = 0, max_vel_err = 0;
+    for (double t = 0; t < table.get_movement_time() + 0.1; t += 0.0007) {
+      motion_t a = closed.calculate(t), b = table.lookup(t);
+      max_pos_err = fmax(max_pos_err, fabs(a.pos - b.pos));
+      max_vel_err = fmax(max_vel_err, fabs(a.vel - b.vel));
+    }
+    printf("error,%g,%.2g,%.2g\n", distance, max_pos_err, max_vel_err);
+  }
+  return 0;
+}
@@ -0,0 +1,222 @@
+/**
+ * Microbenchmarks for the pure pursuit and geometry code that runs in the control loop.
+ *
+ * Runs on a computer against the same core sources the robot uses, so a change can be measured before and after.
+ * Absolute numbers are much lower than on the V5's Cortex-A9; compare runs on the same machine.
+ *
+ * Build (from the repository root):
+ *   g++ -std=gnu++17 -O2 -Itools/host -Iinclude -o pure_pursuit_bench tools/benchmark/pure_pursuit_bench.cpp \
+ *       core/src/utils/pure_pursuit.cpp core/src/utils/math_util.cpp core/src/utils/vector2d.cpp
+ *
+ * Output is one CSV line per benchmark and path size:
+ *   benchmark,points,ns_per_op,allocs_per_op
+ * so two commits can be compared with a diff or a spreadsheet.
+ *
+ * The scalar-templated kernels are run in both float and double (suffixed _f / _d), and the largest difference
+ * between the two on a field-sized path is printed to stderr so the float error stays bounded.
+ *
+ * smooth_path_cubic() is declared but has no definition, so it isn't benchmarked.
+ */
+#include "../../core/include/utils/math_util.h"
+#include "../../core/include/utils/pure_pursuit.h"
+#include <chrono>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace PurePursuit;
+
+// Count every heap allocation so each benchmark can report allocations per operation
+static long alloc_count = 0;
+
+void *operator new(size_t size) {
+  alloc_count++;
+  void *p = malloc(size == 0 ? 1 : size);
+  if (p == NULL) {
+    abort();
+  }
+  return p;
+}
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+// Keeps the optimizer from throwing away results
+static volatile double sink;
+
+/**
+ * Run op() until at least min_time has passed, then print ns and allocations per call
+ */
+template <typename Op> static void bench(const char *name, int points, Op op) {
+  const double min_time_ns = 2e8;
+
+  op(); // warm up caches and any lazily allocated state
+  long iters = 0;
+  long allocs_before = alloc_count;
+  auto start = std::chrono::steady_clock::now();
+  double elapsed_ns = 0;
+  while (elapsed_ns < min_time_ns) {
+    op();
+    iters++;
+    elapsed_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  }
+  long allocs = alloc_count - allocs_before;
+
+  printf("%s,%d,%.1f,%.2f\n", name, points, elapsed_ns / iters, (double)allocs / iters);
+  fflush(stdout);
+}
+
+/**
+ * A gently winding path with the given number of points, about 1 inch apart
+ */
+static std::vector<point_t> make_path(int n) {
+  std::vector<point_t> path;
+  for (int i = 0; i < n; i++) {
+    path.push_back({(double)i, 12 * sin(i * 0.05)});
+  }
+  return path;
+}
+
+/**
+ * Benchmark the scalar-templated kernels in one precision, on a path scaled to fit the 144" field
+ */
+template <typename T> static void bench_kernels(const char *suffix, int n) {
+  std::vector<point2<T>> points;
+  for (point_t p : make_path(n)) {
+    points.push_back(point2<T>{(T)(p.x * 144 / n), (T)(72 + p.y)});
+  }
+  point2<T> mid = points[n / 2];
+  mid.y += 1;
+  point2<T> out[2];
+  T t;
+  char name[64];
+
+  snprintf(name, sizeof(name), "closest_segment%s", suffix);
+  bench(name, n, [&] { sink = closest_segment(points.data(), 0, n - 2, mid, &t); });
+  snprintf(name, sizeof(name), "estimate_path_length%s", suffix);
+  bench(name, n, [&] { sink = estimate_path_length(points); });
+  snprintf(name, sizeof(name), "segment_dist%s", suffix);
+  bench(name, n, [&] {
+    T min_dist = INFINITY;
+    for (int i = 2; i < n - 1; i++) {
+      min_dist = std::min(min_dist, segment_dist(points[0], points[1], points[i], points[i + 1]));
+    }
+    sink = min_dist;
+  });
+  snprintf(name, sizeof(name), "line_circle_intersections%s", suffix);
+  bench(name, n, [&] {
+    int found = 0;
+    for (int i = 0; i < n - 1; i++) {
+      found += line_circle_intersections(mid, (T)6, points[i], points[i + 1], out);
+    }
+    sink = found;
+  });
+}
+
+/**
+ * Largest difference between the float and double kernels along a field-sized path, in inches
+ */
+static void check_float_error(int n) {
+  std::vector<point_t> points;
+  std::vector<pointf_t> points_f;
+  for (point_t p : make_path(n)) {
+    points.push_back({p.x * 144 / n, 72 + p.y});
+    points_f.push_back(points.back().cast<float>());
+  }
+
+  double max_err = 0;
+  for (int i = 0; i < n - 1; i++) {
+    point_t robot = points[i] + point_t{0.3, 1.7};
+    double t;
+    float t_f;
+    int seg = closest_segment(points.data(), 0, n - 2, robot, &t);
+    int seg_f = closest_segment(points_f.data(), 0, n - 2, robot.cast<float>(), &t_f);
+    point_t closest = points[seg] + (points[seg + 1] - points[seg]) * t;
+    point_t closest_f = (points_f[seg_f] + (points_f[seg_f + 1] - points_f[seg_f]) * t_f).cast<double>();
+    max_err = fmax(max_err, closest.dist(closest_f));
+
+    point_t out[2];
+    pointf_t out_f[2];
+    int found = line_circle_intersections(robot, 6.0, points[i], points[i + 1], out);
+    int found_f = line_circle_intersections(robot.cast<float>(), 6.0f, points_f[i], points_f[i + 1], out_f);
+    for (int j = 0; j < found && j < found_f; j++) {
+      max_err = fmax(max_err, out[j].dist(out_f[j].cast<double>()));
+    }
+  }
+  max_err = fmax(max_err, fabs(estimate_path_length(points) - estimate_path_length(points_f)));
+
+  fprintf(stderr, "float vs double max error, %d points over 144 in: %g in\n", n, max_err);
+}
+
+static std::vector<hermite_point> make_waypoints(int n) {
+  std::vector<hermite_point> path;
+  for (int i = 0; i < n; i++) {
+    path.push_back({24.0 * i, 24 * sin(i * 0.7), cos(i * 0.7), 30});
+  }
+  return path;
+}
+
+int main() {
+  const int sizes[] = {10, 100, 1000, 5000};
+  const double radius = 6;
+
+  printf("benchmark,points,ns_per_op,allocs_per_op\n");
+
+  point_t out[2];
+  bench("line_circle_intersections", 2, [&] {
+    sink = line_circle_intersections({0, 0}, radius, {-10, 1}, {10, 2}, out);
+  });
+  bench("line_circle_intersections_vector", 2, [&] {
+    sink = line_circle_intersections({0, 0}, radius, {-10, 1}, {10, 2}).size();
+  });
+
+  for (int n : sizes) {
+    std::vector<point_t> points = make_path(n);
+    Path path(points, radius);
+    pose_t mid = {points[n / 2].x, points[n / 2].y + 1, 0};
+
+    bench("Path", n, [&] { sink = Path(points, radius).get_length(); });
+    bench("get_lookahead", n, [&] { sink = get_lookahead(points, mid, radius).x; });
+
+    // The tracker follows the robot along the path, so benchmark a full pass rather than one position
+    LookaheadTracker tracker;
+    int step = 0;
+    bench("LookaheadTracker::get_lookahead", n, [&] {
+      if (step >= n) {
+        step = 0;
+        tracker.reset();
+      }
+      pose_t pose = {points[step].x, points[step].y + 1, 0};
+      sink = tracker.get_lookahead(points, pose, radius).x;
+      step++;
+    });
+
+    bench("estimate_remaining_dist", n, [&] { sink = estimate_remaining_dist(points, mid, radius); });
+
+    point_t lookahead = get_lookahead(points, mid, radius);
+    int lookahead_seg = path.segment_at(path.progress_of(lookahead, 0, path.get_length()));
+    bench("estimate_remaining_dist_path", n, [&] {
+      sink = estimate_remaining_dist(path, mid, lookahead, lookahead_seg, radius);
+    });
+
+    bench("inject_path", n, [&] { sink = inject_path(points, 0.5).size(); });
+    bench("smooth_path", n, [&] { sink = smooth_path(points, 0.25, 0.75, 0.001).size(); });
+
+    VelocityProfile::velocity_profile_cfg_t profile_cfg = {40, 80, 80};
+    bench("VelocityProfile", n, [&] { sink = VelocityProfile(path, profile_cfg).get_movement_time(); });
+  }
+
+  for (int n : sizes) {
+    // Hermite paths are sized by output points, at 20 steps per waypoint
+    std::vector<hermite_point> waypoints = make_waypoints(n / 20 + 2);
+    bench("smooth_path_hermite", n, [&] { sink = smooth_path_hermite(waypoints, 20).size(); });
+    bench("smooth_path_hermite_uniform", n, [&] { sink = smooth_path_hermite_uniform(waypoints, 1).size(); });
+  }
+
+  for (int n : sizes) {
+    bench_kernels<float>("_f", n);
+    bench_kernels<double>("_d", n);
+    check_float_error(n);
+  }
+
+  return 0;
+}
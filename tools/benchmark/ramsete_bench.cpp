@@ -0,0 +1,331 @@
+/**
+ * Host simulation comparing TankDrive::ramsete() with TankDrive::pure_pursuit() on the same paths.
+ *
+ * Both control laws are copied from tank_drive.cpp (TankDrive needs real motors), and run every 10ms on the real
+ * Path, VelocityProfile, LookaheadTracker, PID, TrapezoidProfile and FeedForward code, with the gains and limits from
+ * robot-config.cpp. Pure pursuit's drive_mc_fast is the moving-profile half of MotionController::update().
+ *
+ * The drivetrain is the feedforward model run backwards - power = kS + kV * vel + kA * accel on each side. Each path is
+ * driven once with the model exact and once with the right side 5% weaker than the feedforward thinks, so the feedback
+ * has something to correct. Odometry is perfect.
+ *
+ * Build (from the repository root):
+ *   g++ -std=gnu++17 -O2 -Itools/host -Iinclude -o ramsete_bench tools/benchmark/ramsete_bench.cpp \
+ *       core/src/utils/pure_pursuit.cpp core/src/utils/math_util.cpp core/src/utils/vector2d.cpp \
+ *       core/src/utils/controls/pid.cpp core/src/utils/controls/trapezoid_profile.cpp \
+ *       core/src/subsystems/odometry/odometry_base.cpp core/src/subsystems/odometry/pose_history.cpp
+ *
+ * Output is CSV:
+ *   track,path,drive,controller,time_s,mean_error_in,max_error_in,end_error_in
+ * error is the distance from the robot's center to the nearest point of the path, sampled every update. end_error is
+ * how far the robot stopped from the last point, once the controller said it was done (or after 10 seconds).
+ * The exit code is the number of runs where Ramsete's mean or max error was worse than pure pursuit's.
+ */
+#include "../../core/include/subsystems/odometry/odometry_base.h"
+#include "../../core/include/utils/controls/feedforward.h"
+#include "../../core/include/utils/controls/pid.h"
+#include "../../core/include/utils/controls/trapezoid_profile.h"
+#include "../../core/include/utils/math_util.h"
+#include "../../core/include/utils/pure_pursuit.h"
+#include <math.h>
+#include <stdio.h>
+
+using namespace PurePursuit;
+
+// From robot-config.cpp
+static const double dist_between_wheels = 10.45, drive_correction_cutoff = 4;
+static FeedForward::ff_config_t drive_ff_cfg = {.kS = 0.03, .kV = 0.0145, .kA = 0.001, .kG = 0};
+static PID::pid_config_t drive_mc_pid_cfg = {
+    .p = 0.1, .i = 0, .d = 0.005, .deadband = 2, .on_target_time = 0.01, .error_method = PID::LINEAR};
+static PID::pid_config_t correction_pid_cfg = {
+    .p = .04, .i = 0, .d = .003, .deadband = 0, .on_target_time = 0, .error_method = PID::LINEAR};
+static const double drive_mc_max_v = 55, drive_mc_accel = 180;
+
+// Ramsete: the same speed and acceleration as drive_mc_fast, and ramsete_cfg
+static const VelocityProfile::velocity_profile_cfg_t profile_cfg = {55, 180, 100};
+static const double ramsete_b = 0.02, ramsete_zeta = 0.7;
+
+static const double dt = 0.01, timeout = 10;
+
+// An S across the field and a tight hook, like the autonomous routines drive
+static const std::vector<hermite_point> s_curve = {
+    {12, 12, 0, 60}, {60, 36, 1.2, 60}, {100, 100, 0.3, 80}, {132, 120, 0, 40}};
+static const std::vector<hermite_point> hook = {{24, 24, 1.57, 30}, {30, 48, 0.8, 30}, {48, 40, -1.57, 40}};
+
+/**
+ * A differential drive whose sides respond to power the way the feedforward model says, except that the right side
+ * needs right_scale times the power for the same speed. Power below kS doesn't move a stopped side.
+ */
+class SimDrive {
+public:
+  SimDrive(pose_t start, double right_scale) : pose(start), right_scale(right_scale) {}
+
+  void drive_tank(double left_power, double right_power) {
+    left_pow = clamp(left_power, -1, 1);
+    right_pow = clamp(right_power, -1, 1);
+  }
+
+  /**
+   * Integrate the motion over one control period in 1ms steps
+   */
+  void step(double period) {
+    const int substeps = 10;
+    double h = period / substeps;
+    for (int i = 0; i < substeps; i++) {
+      left_vel = side_step(left_vel, left_pow, drive_ff_cfg.kV, h);
+      right_vel = side_step(right_vel, right_pow, drive_ff_cfg.kV * right_scale, h);
+
+      double vel = (left_vel + right_vel) / 2.0;
+      double ang_vel = (right_vel - left_vel) / dist_between_wheels;
+      double mid = deg2rad(pose.rot) + (ang_vel * h / 2.0);
+      pose.x += vel * h * cos(mid);
+      pose.y += vel * h * sin(mid);
+      pose.rot = wrap_angle_deg(pose.rot + rad2deg(ang_vel * h));
+    }
+  }
+
+  double get_speed() const { return fabs(left_vel + right_vel) / 2.0; }
+
+  pose_t pose;
+
+private:
+  static double side_step(double vel, double power, double kV, double h) {
+    double friction = drive_ff_cfg.kS * sign(vel);
+    if (vel == 0) {
+      if (fabs(power) <= drive_ff_cfg.kS) {
+        return 0;
+      }
+      friction = drive_ff_cfg.kS * sign(power);
+    }
+    double accel = (power - friction - (kV * vel)) / drive_ff_cfg.kA;
+    double next = vel + (accel * h);
+    // Friction can stop a side, but not push it backwards
+    if (vel != 0 && sign(next) != sign(vel) && fabs(power) <= drive_ff_cfg.kS) {
+      return 0;
+    }
+    return next;
+  }
+
+  double right_scale;
+  double left_pow = 0, right_pow = 0;
+  double left_vel = 0, right_vel = 0;
+};
+
+/**
+ * MotionController::update() for a movement it plans with its TrapezoidProfile, as drive_mc_fast is used by
+ * pure_pursuit()
+ */
+class DriveMotionController {
+public:
+  DriveMotionController() : profile(drive_mc_max_v, drive_mc_accel), pid(drive_mc_pid_cfg), ff(drive_ff_cfg) {}
+
+  void init(double start_pt, double end_pt) {
+    profile.set_endpts(start_pt, end_pt);
+    profile.set_vel_endpts(0, 0);
+    pid.init(start_pt, end_pt);
+    start_s = vex::sim::now_us() / 1e6;
+  }
+
+  double update(double sensor_val) {
+    motion_t motion = profile.calculate(vex::sim::now_us() / 1e6 - start_s);
+    pid.set_target(motion.pos);
+    pid.update(sensor_val, motion.vel);
+    out = pid.get() + ff.calculate(motion.vel, motion.accel, pid.get());
+    return out;
+  }
+
+  double get() { return out; }
+
+  bool is_on_target() {
+    return (vex::sim::now_us() / 1e6 - start_s > profile.get_movement_time()) && pid.is_on_target();
+  }
+
+private:
+  TrapezoidProfile profile;
+  PID pid;
+  FeedForward ff;
+  double start_s = 0, out = 0;
+};
+
+/**
+ * Distance from a point to the nearest segment of the path
+ */
+static double dist_to_path(const std::vector<point_t> &points, point_t pt) {
+  double best = INFINITY;
+  for (size_t i = 0; i + 1 < points.size(); i++) {
+    point_t a = points[i], b = points[i + 1];
+    point_t ab = b - a;
+    double len2 = (ab.x * ab.x) + (ab.y * ab.y);
+    double t = len2 == 0 ? 0 : clamp(((pt.x - a.x) * ab.x + (pt.y - a.y) * ab.y) / len2, 0, 1);
+    best = fmin(best, pt.dist({a.x + (t * ab.x), a.y + (t * ab.y)}));
+  }
+  return best;
+}
+
+typedef struct {
+  double time_s;
+  double mean_error, max_error, end_error;
+} track_result_t;
+
+/**
+ * TankDrive::pure_pursuit() going forwards with a fixed lookahead, one update
+ */
+static bool pure_pursuit_step(SimDrive &drive, const Path &path, LookaheadTracker &tracker,
+                              DriveMotionController &feedback, PID &correction_pid, double max_speed) {
+  const std::vector<point_t> &points = path.get_points();
+  pose_t robot_pose = drive.pose;
+
+  adaptive_lookahead_cfg_t fixed_radius = {path.get_radius(), path.get_radius(), 0, 0};
+  double radius = adaptive_lookahead_radius(path, tracker.get_segment(), drive.get_speed(), fixed_radius);
+  point_t lookahead = tracker.get_lookahead(points, robot_pose, radius);
+  point_t localized = lookahead - robot_pose.get_point();
+
+  point_t last_point = points[points.size() - 1];
+  bool is_last_point = (lookahead == last_point);
+
+  double correction = 0;
+  double dist_remaining = estimate_remaining_dist(path, robot_pose, lookahead, tracker.get_segment(), radius);
+  double angle_diff = OdometryBase::smallest_angle(robot_pose.rot, rad2deg(atan2(localized.y, localized.x)));
+
+  if (!(is_last_point && robot_pose.get_point().dist(last_point) < drive_correction_cutoff)) {
+    correction_pid.update(angle_diff);
+    correction = correction_pid.get();
+  } else {
+    dist_remaining *= cos(angle_diff * (M_PI / 180.0));
+  }
+
+  feedback.update(-dist_remaining);
+
+  double left = clamp(feedback.get(), -max_speed, max_speed) + correction;
+  double right = clamp(feedback.get(), -max_speed, max_speed) - correction;
+  drive.drive_tank(left, right);
+
+  if (is_last_point && feedback.is_on_target()) {
+    drive.drive_tank(0, 0);
+    return true;
+  }
+  return false;
+}
+
+/**
+ * TankDrive::ramsete() going forwards, one update
+ */
+static bool ramsete_step(SimDrive &drive, const Path &path, const VelocityProfile &profile, FeedForward &ff,
+                         double time_s) {
+  motion_t target = profile.calculate(time_s);
+  point_t target_pt = path.point_at(target.pos);
+  double target_heading = path.heading_at(target.pos);
+  double target_curvature = path.curvature_at(target.pos);
+  double target_ang_vel = target.vel * target_curvature;
+  // Turning speeds up with the speed along the path and with the curvature changing under it: d(v * k)/dt is
+  // a * k + v^2 * dk/ds
+  const double ds = 1.0;
+  double dcurvature = (path.curvature_at(target.pos + ds) - path.curvature_at(target.pos - ds)) / (2 * ds);
+  double target_ang_accel = (target.accel * target_curvature) + (target.vel * target.vel * dcurvature);
+
+  pose_t robot_pose = drive.pose;
+  double heading = deg2rad(robot_pose.rot);
+  point_t err = target_pt - robot_pose.get_point();
+  double err_x = (cos(heading) * err.x) + (sin(heading) * err.y);
+  double err_y = (-sin(heading) * err.x) + (cos(heading) * err.y);
+  double err_heading = deg2rad(OdometryBase::smallest_angle(rad2deg(heading), rad2deg(target_heading)));
+
+  double k = 2 * ramsete_zeta * sqrt((target_ang_vel * target_ang_vel) + (ramsete_b * target.vel * target.vel));
+  double sinc = fabs(err_heading) < 1e-9 ? 1.0 : sin(err_heading) / err_heading;
+  double vel = (target.vel * cos(err_heading)) + (k * err_x);
+  double ang_vel = target_ang_vel + (k * err_heading) + (ramsete_b * target.vel * sinc * err_y);
+
+  double half_track = dist_between_wheels / 2.0;
+  double left = ff.calculate(vel - (ang_vel * half_track), target.accel - (target_ang_accel * half_track));
+  double right = ff.calculate(vel + (ang_vel * half_track), target.accel + (target_ang_accel * half_track));
+  drive.drive_tank(left, right);
+
+  if (time_s > profile.get_movement_time()) {
+    drive.drive_tank(0, 0);
+    return true;
+  }
+  return false;
+}
+
+/**
+ * Start the robot on the path's first point facing along it, and run one controller until it finishes
+ */
+static track_result_t track(const Path &path, bool use_ramsete, double right_scale) {
+  const std::vector<point_t> &points = path.get_points();
+  SimDrive drive({points[0].x, points[0].y, rad2deg(path.get_headings()[0])}, right_scale);
+
+  LookaheadTracker tracker;
+  DriveMotionController feedback;
+  PID correction_pid(correction_pid_cfg);
+  VelocityProfile profile(path, profile_cfg);
+  FeedForward ff(drive_ff_cfg);
+
+  feedback.init(-path.get_length(), 0);
+  correction_pid.init(0, 0);
+  correction_pid.set_limits(-1, 1);
+
+  track_result_t result = {0, 0, 0, 0};
+  int updates = 0;
+  bool done = false;
+  double start_s = vex::sim::now_us() / 1e6;
+  while (!done && result.time_s < timeout) {
+    vex::sim::time_us += (uint64_t)(dt * 1e6);
+    result.time_s = vex::sim::now_us() / 1e6 - start_s;
+
+    if (use_ramsete) {
+      done = ramsete_step(drive, path, profile, ff, result.time_s);
+    } else {
+      done = pure_pursuit_step(drive, path, tracker, feedback, correction_pid, 1);
+    }
+    drive.step(dt);
+
+    double error = dist_to_path(points, drive.pose.get_point());
+    result.mean_error += error;
+    result.max_error = fmax(result.max_error, error);
+    updates++;
+  }
+
+  // Let the robot coast to a stop before measuring where it ended up
+  for (int i = 0; i < 100; i++) {
+    drive.step(dt);
+  }
+  result.mean_error /= updates;
+  result.end_error = drive.pose.get_point().dist(points.back());
+  return result;
+}
+
+int main() {
+  vex::sim::use_sim_time = true;
+
+  struct {
+    const char *name;
+    const std::vector<hermite_point> &waypoints;
+    int steps;
+    double radius;
+  } paths[] = {{"s_curve", s_curve, 20, 8}, {"hook", hook, 10, 5}};
+
+  struct {
+    const char *name;
+    double right_scale;
+  } drives[] = {{"exact", 1.0}, {"weak_right", 1.05}};
+
+  int failed = 0;
+  printf("track,path,drive,controller,time_s,mean_error_in,max_error_in,end_error_in\n");
+  for (auto &p : paths) {
+    // Smoothed after injecting: the straight runs inject_path() adds between the hermite points would make the
+    // curvature Ramsete steers by jump between 0 and the curve's
+    Path path(smooth_path_direct(inject_path(smooth_path_hermite(p.waypoints, p.steps), 1), 0.1, 0.9), p.radius);
+    for (auto &d : drives) {
+      track_result_t pp = track(path, false, d.right_scale);
+      track_result_t rs = track(path, true, d.right_scale);
+      printf("track,%s,%s,pure_pursuit,%.2f,%.2f,%.2f,%.2f\n", p.name, d.name, pp.time_s, pp.mean_error,
+             pp.max_error, pp.end_error);
+      printf("track,%s,%s,ramsete,%.2f,%.2f,%.2f,%.2f\n", p.name, d.name, rs.time_s, rs.mean_error, rs.max_error,
+             rs.end_error);
+      if (rs.mean_error > pp.mean_error || rs.max_error > pp.max_error) {
+        failed++;
+      }
+    }
+  }
+  return failed;
+}
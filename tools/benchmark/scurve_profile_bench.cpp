@@ -0,0 +1,160 @@
+/**
+ * Limit check and move time comparison for SCurveProfile against TrapezoidProfile.
+ *
+ * Steps each S-curve through its movement in 10us ticks, checking the velocity, acceleration and jerk never go over
+ * their limits and that it ends at rest on the end point. Then does the same for movements that start or end moving,
+ * as chained drives do, including ones too short to reach the end velocity and ones starting faster than max_v. Those
+ * should end on the end point at the end velocity, or at a velocity between the start and end ones if it's out of
+ * reach, and with no jerk limit match TrapezoidProfile. Last, compares move times: the fast drive trapezoid from
+ * robot-config, an S-curve with the same acceleration, and S-curves with the higher acceleration a jerk limit allows.
+ *
+ * Build (from the repository root):
+ *   g++ -std=gnu++17 -O2 -Itools/host -Iinclude -o scurve_profile_bench tools/benchmark/scurve_profile_bench.cpp \
+ *       core/src/utils/controls/scurve_profile.cpp core/src/utils/controls/trapezoid_profile.cpp \
+ *       core/src/utils/math_util.cpp core/src/utils/vector2d.cpp
+ *
+ * Output is CSV:
+ *   limits,distance,accel,jerk,max_vel,max_accel,max_jerk,end_err,ok
+ *   chained,distance,start_vel,end_vel,max_vel,max_accel,max_jerk,end_err,arrive_vel,after_vel,trapezoid_diff,ok
+ *   time,distance,trapezoid,scurve(accel=...)...
+ * The exit code is the number of limit checks that failed.
+ */
+#include "../../core/include/utils/controls/scurve_profile.h"
+#include "../../core/include/utils/controls/trapezoid_profile.h"
+#include <math.h>
+#include <stdio.h>
+
+// The fast drive profile from robot-config
+static const double max_v = 55, accel = 180;
+static const double jerk = 3000;
+
+/**
+ * Step through a movement and check it stays inside its limits
+ * @return true if it did
+ */
+static bool check_limits(double distance, double a, double j) {
+  const double h = 1e-5;
+  SCurveProfile profile(max_v, a, j);
+  profile.set_endpts(0, distance);
+  double movement_time = profile.get_movement_time();
+
+  double max_vel = 0, max_accel = 0, max_jerk = 0;
+  motion_t prev = profile.calculate(0);
+  for (double t = h; t < movement_time; t += h) {
+    motion_t m = profile.calculate(t);
+    max_vel = fmax(max_vel, fabs(m.vel));
+    max_accel = fmax(max_accel, fabs(m.accel));
+    max_jerk = fmax(max_jerk, fabs(m.accel - prev.accel) / h);
+    prev = m;
+  }
+  motion_t last = profile.calculate(movement_time - 1e-9);
+  double end_err = fabs(last.pos - distance) + fabs(last.vel);
+
+  bool ok = max_vel <= max_v + 1e-9 && max_accel <= a + 1e-9 && max_jerk <= j * 1.001 && end_err < 1e-6;
+  printf("limits,%g,%g,%g,%.3f,%.3f,%.1f,%.2g,%s\n", distance, a, j, max_vel, max_accel, max_jerk, end_err,
+         ok ? "ok" : "FAIL");
+  return ok;
+}
+
+/**
+ * Step through a movement that starts or ends moving, check it stays inside its limits and arrives on the end point,
+ * and compare it with no jerk limit to the trapezoid profile
+ * @return true if it did
+ */
+static bool check_chained(double distance, double start_vel, double end_vel) {
+  const double h = 1e-5;
+  SCurveProfile profile(max_v, accel, jerk);
+  profile.set_endpts(0, distance);
+  profile.set_vel_endpts(start_vel, end_vel);
+  double movement_time = profile.get_movement_time();
+
+  double max_vel = 0, max_accel = 0, max_jerk = 0;
+  motion_t prev = profile.calculate(0);
+  for (double t = h; t < movement_time; t += h) {
+    motion_t m = profile.calculate(t);
+    max_vel = fmax(max_vel, fabs(m.vel));
+    max_accel = fmax(max_accel, fabs(m.accel));
+    max_jerk = fmax(max_jerk, fabs(m.accel - prev.accel) / h);
+    prev = m;
+  }
+  motion_t last = profile.calculate(movement_time - 1e-9);
+  double end_err = fabs(last.pos - distance);
+  double after_vel = profile.calculate(movement_time + 1).vel;
+
+  // Along the direction of travel: arrive at the end velocity, or between the start and end ones if it's out of reach
+  double dir = (distance < 0) ? -1 : 1;
+  double v0 = dir * start_vel, v1 = dir * end_vel, arrive = dir * last.vel;
+  bool arrive_ok = arrive >= fmin(v0, v1) - 1e-6 && arrive <= fmax(v0, v1) + 1e-6;
+  bool after_ok = fabs(dir * after_vel - fmin(arrive, v1)) < 1e-6;
+
+  TrapezoidProfile trapezoid(max_v, accel);
+  trapezoid.set_endpts(0, distance);
+  trapezoid.set_vel_endpts(start_vel, end_vel);
+  SCurveProfile no_jerk(max_v, accel, 0);
+  no_jerk.set_endpts(0, distance);
+  no_jerk.set_vel_endpts(start_vel, end_vel);
+  double trapezoid_diff = 0;
+  for (double t = 0; t < 2; t += 1e-3) {
+    motion_t a = trapezoid.calculate(t), b = no_jerk.calculate(t);
+    trapezoid_diff = fmax(trapezoid_diff, fabs(a.pos - b.pos) + fabs(a.vel - b.vel));
+  }
+
+  bool ok = max_vel <= fmax(max_v, fabs(start_vel)) + 1e-9 && max_accel <= accel + 1e-9 && max_jerk <= jerk * 1.001 &&
+            end_err < 1e-6 && arrive_ok && after_ok && trapezoid_diff < 1e-9;
+  printf("chained,%g,%g,%g,%.3f,%.3f,%.1f,%.2g,%.3f,%.3f,%.2g,%s\n", distance, start_vel, end_vel, max_vel, max_accel,
+         max_jerk, end_err, last.vel, after_vel, trapezoid_diff, ok ? "ok" : "FAIL");
+  return ok;
+}
+
+int main() {
+  const double distances[] = {0.5, 6, 24, 48, 96, -30};
+  const double accels[] = {accel, 250, 300};
+
+  int failed = 0;
+  printf("limits,distance,accel,jerk,max_vel,max_accel,max_jerk,end_err,ok\n");
+  for (double distance : distances) {
+    for (double a : accels) {
+      failed += !check_limits(distance, a, jerk);
+    }
+  }
+
+  // distance, start_vel, end_vel
+  const double chained[][3] = {
+      {24, 0, 30},      // end moving
+      {24, 30, 0},      // start moving
+      {24, 30, 30},     // both
+      {-24, -30, -20},  // both, backwards
+      {48, -10, 20},    // start going the wrong way
+      {24, 70, 0},      // start faster than max_v
+      {24, 70, 40},     // start faster than max_v and end moving
+      {6, 0, 55},       // too short to speed up to end_vel
+      {6, 55, 0},       // too short to slow down to end_vel
+      {3, 50, 10},      // too short to slow down, and end moving
+      {24, 40, 40},     // already at end_vel
+  };
+  printf("chained,distance,start_vel,end_vel,max_vel,max_accel,max_jerk,end_err,arrive_vel,after_vel,"
+         "trapezoid_diff,ok\n");
+  for (const auto &c : chained) {
+    failed += !check_chained(c[0], c[1], c[2]);
+  }
+
+  printf("time,distance,trapezoid");
+  for (double a : accels) {
+    printf(",scurve(accel=%g)", a);
+  }
+  printf("\n");
+  for (double distance : distances) {
+    TrapezoidProfile trapezoid(max_v, accel);
+    trapezoid.set_endpts(0, distance);
+    trapezoid.calculate(0);
+    printf("time,%g,%.3f", distance, trapezoid.get_movement_time());
+    for (double a : accels) {
+      SCurveProfile scurve(max_v, a, jerk);
+      scurve.set_endpts(0, distance);
+      printf(",%.3f", scurve.get_movement_time());
+    }
+    printf("\n");
+  }
+
+  return failed;
+}
@@ -0,0 +1,171 @@
+/**
+ * Check of OdometryTank running from a SensorBus, the way robot-config sets it up, against reading the devices itself.
+ *
+ * Odometry runs in its own background task. Three more threads stand in for the other subsystems (the drive, the
+ * catapult, the screen), each reading two sensor channels and odometry's position once a millisecond. One more copies
+ * whole snapshots from the bus as fast as it can. Each mode runs for a few seconds:
+ * - devices:  no bus. Odometry and the subsystems read the devices every time, and odometry updates as fast as it can
+ * - direct:   a bus built with use_snapshots = false. Every get() reads the device, odometry waits a period per update
+ * - snapshot: a bus taking snapshots every period, which odometry and the subsystems read instead of the devices
+ *
+ * The bus's first channel counts the snapshots and its last returns the count again, with odometry's channels between
+ * them, so a snapshot copied while the bus was writing it has a first and last value (or tick) that don't match.
+ *
+ * Build (from the repository root):
+ *   g++ -std=gnu++17 -O2 -Itools/host -Iinclude -o sensor_bus_bench tools/benchmark/sensor_bus_bench.cpp \
+ *       core/src/subsystems/sensor_bus.cpp core/src/subsystems/odometry/odometry_tank.cpp \
+ *       core/src/subsystems/odometry/odometry_base.cpp core/src/subsystems/odometry/odometry_kinematics.cpp \
+ *       core/src/subsystems/odometry/pose_history.cpp core/src/subsystems/custom_encoder.cpp \
+ *       core/src/utils/derivative_estimator.cpp core/src/utils/math_util.cpp core/src/utils/vector2d.cpp -lpthread
+ *
+ * Output is CSV:
+ *   sensor_bus,mode,loops_per_sec,updates_per_sec,reads_per_sec,snapshots_read,torn,ok
+ * loops_per_sec is how often odometry's task goes round, updates_per_sec how often it publishes a new position. With a
+ * bus both should be about one per period, and the snapshot mode should read the devices less than the direct one.
+ * The exit code is the number of modes that fail those checks, plus any torn snapshots.
+ */
+#include "../../core/include/subsystems/odometry/odometry_tank.h"
+#include "../../core/include/subsystems/sensor_bus.h"
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+static const uint32_t period_ms = 10;
+static const int run_ms = 3000; // after odometry's 1 second start up delay
+
+/**
+ * Tank odometry that counts its updates
+ */
+class CountingOdometry : public OdometryTank {
+public:
+  CountingOdometry(vex::motor_group &left, vex::motor_group &right, robot_specs_t &config, vex::inertial *imu)
+      : OdometryTank(left, right, config, imu, true) {}
+
+  pose_t update() override {
+    pose_t pos = OdometryTank::update();
+    loops++;
+    // Only a new sample is published, and every publish is timestamped
+    uint64_t published_us = get_snapshot().timestamp_us;
+    if (published_us != last_published_us) {
+      last_published_us = published_us;
+      updates++;
+    }
+    return pos;
+  }
+
+  std::atomic<long> loops{0}, updates{0};
+
+private:
+  uint64_t last_published_us = 0;
+};
+
+enum class bus_mode_t { devices, direct, snapshot };
+
+static const char *mode_names[] = {"devices", "direct", "snapshot"};
+
+/**
+ * Run odometry and the stand in subsystems in one mode, print its line and return how many checks failed
+ */
+static int run(bus_mode_t mode) {
+  // Everything here is left allocated: the background tasks are only told to stop, and may still be finishing
+  robot_specs_t *config = new robot_specs_t();
+  config->odom_wheel_diam = 3.25;
+  config->odom_gear_ratio = 1;
+  config->dist_between_wheels = 11.5;
+  vex::motor_group *left = new vex::motor_group(), *right = new vex::motor_group();
+  vex::inertial *imu = new vex::inertial();
+  CountingOdometry *odom = new CountingOdometry(*left, *right, *config, imu);
+
+  // Reads of the subsystems' own devices. The bus counts its reads itself
+  std::atomic<long> *device_reads = new std::atomic<long>(0);
+  SensorChannel *channels[2] = {
+      new SensorChannel([left, device_reads]() { return (double)(++*device_reads, left->position_rev); }),
+      new SensorChannel([right, device_reads]() { return (double)(++*device_reads, right->position_rev); })};
+
+  SensorBus *bus = NULL;
+  long *count = new long(0);
+  int first = -1, last = -1;
+  if (mode != bus_mode_t::devices) {
+    bus = new SensorBus(period_ms, mode == bus_mode_t::snapshot);
+    first = bus->add_channel([count]() { return (double)++*count; });
+    odom->use_sensor_bus(*bus);
+    channels[0]->use_sensor_bus(*bus);
+    channels[1]->use_sensor_bus(*bus);
+    last = bus->add_channel([count]() { return (double)*count; });
+  }
+
+  std::atomic<bool> done(false);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 3; i++) {
+    threads.emplace_back([&]() {
+      while (!done) {
+        channels[0]->get();
+        channels[1]->get();
+        odom->get_position();
+        vexDelay(1);
+      }
+    });
+  }
+
+  std::atomic<long> snapshots_read(0), torn(0);
+  if (mode == bus_mode_t::snapshot) {
+    threads.emplace_back([&]() {
+      while (!done) {
+        SensorBus::sensor_snapshot_t s = bus->get_snapshot();
+        if (s.num_channels > last && (s.values[first] != s.values[last] || s.values[first] != s.tick)) {
+          torn++;
+        }
+        snapshots_read++;
+        vex::this_thread::yield();
+      }
+    });
+  }
+
+  // Odometry's task waits a second before it starts
+  vexDelay(1100);
+  long loops_start = odom->loops, updates_start = odom->updates, device_reads_start = *device_reads;
+  vexDelay(run_ms);
+  double sec = run_ms / 1000.0;
+  double loops_per_sec = (odom->loops - loops_start) / sec;
+  double updates_per_sec = (odom->updates - updates_start) / sec;
+  // Without a bus odometry reads both sides and the IMU every loop
+  double reads_per_sec =
+      (bus != NULL) ? bus->get_reads_per_sec() : (3 * loops_per_sec + (*device_reads - device_reads_start) / sec);
+
+  done = true;
+  for (std::thread &t : threads) {
+    t.join();
+  }
+  odom->end_async();
+  if (bus != NULL) {
+    bus->end_async();
+  }
+
+  // Once a period, give or take the scheduler
+  bool ok = true;
+  if (mode != bus_mode_t::devices) {
+    double expected = 1000.0 / period_ms;
+    ok = updates_per_sec > 0.9 * expected && updates_per_sec < 1.05 * expected && loops_per_sec < 2.5 * expected;
+  }
+  if (mode == bus_mode_t::snapshot) {
+    // One read of every channel a period, and nothing else
+    double expected = (last + 1) * 1000.0 / period_ms;
+    ok = ok && torn == 0 && reads_per_sec > 0.9 * expected && reads_per_sec < 1.05 * expected;
+  }
+
+  printf("sensor_bus,%s,%.0f,%.1f,%.0f,%ld,%ld,%s\n", mode_names[(int)mode], loops_per_sec, updates_per_sec,
+         reads_per_sec, (long)snapshots_read, (long)torn, ok ? "ok" : "FAIL");
+  vexDelay(100);
+  return (ok ? 0 : 1) + torn;
+}
+
+int main() {
+  printf("sensor_bus,mode,loops_per_sec,updates_per_sec,reads_per_sec,snapshots_read,torn,ok\n");
+  int failed = 0;
+  failed += run(bus_mode_t::devices);
+  failed += run(bus_mode_t::direct);
+  failed += run(bus_mode_t::snapshot);
+  return failed;
+}
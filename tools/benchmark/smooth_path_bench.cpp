@@ -0,0 +1,99 @@
+/**
+ * Benchmark for path smoothing: the direct tridiagonal solve smooth_path() now uses (smooth_path_direct()) against the
+ * iterative loop it replaced.
+ *
+ * The old loop is copied here, with an iteration counter and a cap so a tolerance it can't reach doesn't hang the
+ * benchmark the way it could hang the robot. Both are run on the same noisy zig-zag paths, and the direct result is
+ * compared against what the loop converged to.
+ *
+ * Build (from the repository root):
+ *   g++ -std=gnu++17 -O2 -Itools/host -Iinclude -o smooth_path_bench tools/benchmark/smooth_path_bench.cpp \
+ *       core/src/utils/pure_pursuit.cpp core/src/utils/math_util.cpp core/src/utils/vector2d.cpp
+ *
+ * Output is CSV:
+ *   benchmark,points,tolerance,iterations,iterative_us,direct_us,max_diff_in
+ * iterations is the cap (and iterative_us the time to reach it) if the loop never got under the tolerance.
+ */
+#include "../../core/include/utils/pure_pursuit.h"
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+
+using namespace PurePursuit;
+
+static const double weight_data = 0.25, weight_smooth = 0.75;
+static const int max_iterations = 100000;
+
+/**
+ * The Gauss-Seidel style smoother smooth_path() used before, unchanged apart from counting and capping its iterations
+ */
+static std::vector<point_t> smooth_path_iterative(const std::vector<point_t> &path, double weight_data,
+                                                  double weight_smooth, double tolerance, int &iterations) {
+  std::vector<point_t> new_path = path;
+  double change = tolerance;
+  iterations = 0;
+  while (change >= tolerance && iterations < max_iterations) {
+    change = 0;
+    for (size_t i = 1; i < path.size() - 1; i++) {
+      point_t x_i = path[i];
+      point_t y_i = new_path[i];
+      point_t y_prev = new_path[i - 1];
+      point_t y_next = new_path[i + 1];
+
+      point_t y_i_saved = y_i;
+
+      y_i.x += weight_data * (x_i.x - y_i.x) + weight_smooth * (y_next.x + y_prev.x - (2 * y_i.x));
+      y_i.y += weight_data * (x_i.y - y_i.y) + weight_smooth * (y_next.y + y_prev.y - (2 * y_i.y));
+      new_path[i] = y_i;
+
+      change += y_i.dist(y_i_saved);
+    }
+    iterations++;
+  }
+  return new_path;
+}
+
+/**
+ * A zig-zag across the field with a little deterministic noise, with the requested number of points
+ */
+static std::vector<point_t> make_path(int points) {
+  std::vector<point_t> path;
+  for (int i = 0; i < points; i++) {
+    double t = (double)i / (points - 1);
+    double wobble = 0.3 * sin(i * 12.9898);
+    path.push_back({12 + 120 * t + wobble, 72 + 24 * ((i / 10) % 2 == 0 ? 1 : -1) * sin(M_PI * t * 4) + wobble});
+  }
+  return path;
+}
+
+int main() {
+  const int sizes[] = {50, 500, 5000};
+  const double tolerances[] = {1e-3, 1e-10};
+
+  printf("benchmark,points,tolerance,iterations,iterative_us,direct_us,max_diff_in\n");
+  for (int points : sizes) {
+    std::vector<point_t> path = make_path(points);
+    for (double tolerance : tolerances) {
+      int iterations = 0;
+      auto start = std::chrono::steady_clock::now();
+      std::vector<point_t> iterative = smooth_path_iterative(path, weight_data, weight_smooth, tolerance, iterations);
+      double iterative_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+      const int reps = 200;
+      std::vector<point_t> direct;
+      start = std::chrono::steady_clock::now();
+      for (int r = 0; r < reps; r++) {
+        direct = smooth_path_direct(path, weight_data, weight_smooth);
+      }
+      double direct_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+      direct_us /= reps;
+
+      double max_diff = 0;
+      for (int i = 0; i < points; i++) {
+        max_diff = fmax(max_diff, iterative[i].dist(direct[i]));
+      }
+      printf("smooth_path,%d,%g,%d,%.1f,%.1f,%.2g\n", points, tolerance, iterations, iterative_us, direct_us, max_diff);
+    }
+  }
+  return 0;
+}
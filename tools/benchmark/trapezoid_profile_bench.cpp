@@ -0,0 +1,151 @@
+/**
+ * Check of TrapezoidProfile for movements that start or end moving, the way chained drives use it.
+ *
+ * Steps each movement through in 10us ticks, checking the acceleration never goes over its limit, the velocity never
+ * goes over max_v (or the start velocity, if that's faster), and that it ends on the end point. The velocity it
+ * arrives at is checked against the kinematic equations: the end velocity if there's room to reach it, the fastest it
+ * can get to if there isn't room to speed up, and the slowest it can get to if it's coming in too fast to slow down
+ * (decelerating the whole way, then overshooting). Afterwards it should report the slower of the end velocity and the
+ * one it arrived at.
+ *
+ * Then chains drives the way TankDrive does with carried_vel: each drive starts at the speed the robot reached at the
+ * end of the last one, assuming the robot follows the profile exactly. Each join should have no jump in velocity, and
+ * the last drive should stop.
+ *
+ * Build (from the repository root):
+ *   g++ -std=gnu++17 -O2 -Itools/host -Iinclude -o trapezoid_profile_bench \
+ *       tools/benchmark/trapezoid_profile_bench.cpp core/src/utils/controls/trapezoid_profile.cpp \
+ *       core/src/utils/math_util.cpp core/src/utils/vector2d.cpp
+ *
+ * Output is CSV:
+ *   case,name,distance,start_vel,end_vel,time,max_vel,max_accel,end_err,arrive_vel,expected_arrive_vel,after_vel,ok
+ *   chain,leg,distance,start_vel,end_vel,arrive_vel,join_err,ok
+ * The exit code is the number of cases and legs that failed.
+ */
+#include "../../core/include/utils/controls/trapezoid_profile.h"
+#include <math.h>
+#include <stdio.h>
+
+// The fast drive profile from robot-config
+static const double max_v = 55, accel = 180;
+
+/**
+ * One movement to check
+ */
+typedef struct {
+  const char *name;
+  double distance, start_vel, end_vel;
+} case_t;
+
+static const case_t cases[] = {
+    {"rest_to_rest", 24, 0, 0},
+    {"end_moving", 24, 0, 30},
+    {"start_moving", 24, 30, 0},
+    {"both_moving_backwards", -24, -30, -20},
+    {"start_wrong_way", 48, -10, 20},
+    {"end_vel_over_max_v", 24, 0, 80},
+    {"unreachable_end_vel", 6, 0, 55},
+    {"unreachable_end_vel_moving", 4, 20, 55},
+    {"start_over_max_v", 24, 70, 0},
+    {"start_over_max_v_end_moving", 24, 70, 40},
+    {"decelerate_only", 6, 55, 0},
+    {"decelerate_only_end_moving", 3, 50, 10},
+    {"decelerate_only_over_max_v", 4, 70, 0},
+    {"decelerate_only_backwards", -6, -55, 0},
+};
+
+/**
+ * The velocity a movement should arrive at, along the direction of travel
+ */
+static double expected_arrive(double distance, double v0, double v1) {
+  double d = fabs(distance);
+  if (v1 * v1 - v0 * v0 > 2 * accel * d) {
+    // Too short to speed up to v1
+    return sqrt(v0 * v0 + 2 * accel * d);
+  }
+  if (v0 > 0 && v0 * v0 - v1 * v1 > 2 * accel * d) {
+    // Too fast to slow down to v1
+    return sqrt(v0 * v0 - 2 * accel * d);
+  }
+  return v1;
+}
+
+/**
+ * Step through a movement and check it against its limits and the velocity it should arrive at
+ * @return true if it passed
+ */
+static bool check_case(const case_t &c) {
+  const double h = 1e-5;
+  TrapezoidProfile profile(max_v, accel);
+  profile.set_endpts(0, c.distance);
+  profile.set_vel_endpts(c.start_vel, c.end_vel);
+  profile.calculate(0);
+  double movement_time = profile.get_movement_time();
+
+  double max_vel = 0, max_accel = 0;
+  for (double t = 0; t < movement_time; t += h) {
+    motion_t m = profile.calculate(t);
+    max_vel = fmax(max_vel, fabs(m.vel));
+    max_accel = fmax(max_accel, fabs(m.accel));
+  }
+  motion_t last = profile.calculate(movement_time - 1e-9);
+  double end_err = fabs(last.pos - c.distance);
+  double after_vel = profile.calculate(movement_time + 1).vel;
+
+  // Along the direction of travel, with the end velocity limited the way the profile limits it
+  double dir = (c.distance < 0) ? -1 : 1;
+  double v0 = dir * c.start_vel;
+  double v1 = fmax(fmin(dir * c.end_vel, max_v), 0);
+  double expected = expected_arrive(c.distance, v0, v1);
+  double arrive = dir * last.vel;
+
+  bool ok = max_vel <= fmax(max_v, fabs(c.start_vel)) + 1e-9 && max_accel <= accel + 1e-9 && end_err < 1e-6 &&
+            fabs(arrive - expected) < 1e-4 && fabs(dir * after_vel - fmin(expected, v1)) < 1e-9;
+  printf("case,%s,%g,%g,%g,%.3f,%.3f,%.1f,%.2g,%.3f,%.3f,%.3f,%s\n", c.name, c.distance, c.start_vel, c.end_vel,
+         movement_time, max_vel, max_accel, end_err, last.vel, dir * expected, after_vel, ok ? "ok" : "FAIL");
+  return ok;
+}
+
+/**
+ * Chain drives, each starting at the speed the last arrived at, like TankDrive's carried_vel
+ * @return how many legs failed
+ */
+static int check_chain() {
+  // distance, end velocity. The second is too short to reach its end velocity, the third too short to slow down to
+  // its own, and the last stops
+  const double legs[][2] = {{24, 40}, {3, 55}, {3, 10}, {12, 0}};
+  const int num_legs = sizeof(legs) / sizeof(legs[0]);
+
+  int failed = 0;
+  double carried_vel = 0;
+  for (int i = 0; i < num_legs; i++) {
+    double distance = legs[i][0], end_vel = legs[i][1];
+    TrapezoidProfile profile(max_v, accel);
+    profile.set_endpts(0, distance);
+    profile.set_vel_endpts(carried_vel, end_vel);
+    double join_err = fabs(profile.calculate(0).vel - carried_vel);
+    motion_t last = profile.calculate(profile.get_movement_time() - 1e-9);
+
+    bool ok = join_err < 1e-9 && fabs(last.pos - distance) < 1e-6 && (i < num_legs - 1 || fabs(last.vel) < 1e-6);
+    printf("chain,%d,%g,%.3f,%g,%.3f,%.2g,%s\n", i, distance, carried_vel, end_vel, last.vel, join_err,
+           ok ? "ok" : "FAIL");
+    failed += ok ? 0 : 1;
+
+    // The speed the robot reached, which odometry would report, rather than the end velocity asked for
+    carried_vel = last.vel;
+  }
+  return failed;
+}
+
+int main() {
+  int failed = 0;
+  printf("case,name,distance,start_vel,end_vel,time,max_vel,max_accel,end_err,arrive_vel,expected_arrive_vel,"
+         "after_vel,ok\n");
+  for (const case_t &c : cases) {
+    failed += !check_case(c);
+  }
+
+  printf("chain,leg,distance,start_vel,end_vel,arrive_vel,join_err,ok\n");
+  failed += check_chain();
+  return failed;
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+// Stand-in for the VEX SDK header when building core code on a computer, for the programs in tools/benchmark.
+// Path code only needs the standard headers and the vex namespace to exist. Odometry code also needs tasks, mutexes,
+// timers and the sensors it reads: tasks run as threads, and sensors hold whatever values a benchmark gives them.
+//
+// Timers follow the computer's clock, unless a benchmark sets vex::sim::use_sim_time and steps vex::sim::time_us
+// itself.
+
+#include <atomic>
+#include <chrono>
+#include <math.h>
+#include <mutex>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+namespace vex {
+
+enum class rotationUnits { deg, rev, raw };
+enum class distanceUnits { mm, in, cm };
+enum class timeUnits { sec, msec };
+enum class velocityUnits { pct, rpm, dps };
+enum class turnType { left, right };
+
+namespace sim {
+inline std::atomic<bool> use_sim_time{false};
+inline std::atomic<uint64_t> time_us{0};
+
+inline uint64_t now_us() {
+  if (use_sim_time) {
+    return time_us;
+  }
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+} // namespace sim
+
+class timer {
+public:
+  void reset() { start_us = sim::now_us(); }
+  double time(timeUnits units = timeUnits::msec) {
+    double ms = (sim::now_us() - start_us) / 1000.0;
+    return (units == timeUnits::sec) ? ms / 1000.0 : ms;
+  }
+  double value() { return time(timeUnits::sec); }
+  static uint32_t system() { return (uint32_t)(sim::now_us() / 1000); }
+  static uint64_t systemHighResolution() { return sim::now_us(); }
+
+private:
+  uint64_t start_us = sim::now_us();
+};
+
+class mutex {
+public:
+  void lock() { m.lock(); }
+  void unlock() { m.unlock(); }
+  bool try_lock() { return m.try_lock(); }
+
+private:
+  std::mutex m;
+};
+
+class task {
+public:
+  task(int (*fn)(void *), void *arg) { std::thread(fn, arg).detach(); }
+  void stop() {}
+};
+
+namespace this_thread {
+inline void yield() { std::this_thread::yield(); }
+inline void sleep_for(uint32_t ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+} // namespace this_thread
+
+class device {
+public:
+  bool installed() { return true; }
+};
+
+// Rotation is clockwise positive, like the real sensor
+class inertial : public device {
+public:
+  double rotation(rotationUnits = rotationUnits::deg) { return rotation_deg; }
+  double rotation_deg = 0;
+};
+
+// Position is from the center of the field, heading is clockwise from the field's +y, like the real sensor
+class gps : public device {
+public:
+  double xPosition(distanceUnits = distanceUnits::in) { return x_in; }
+  double yPosition(distanceUnits = distanceUnits::in) { return y_in; }
+  double heading(rotationUnits = rotationUnits::deg) { return heading_deg; }
+  int32_t quality() { return quality_pct; }
+  double x_in = 0, y_in = 0, heading_deg = 0;
+  int32_t quality_pct = 100;
+};
+
+// Only here to be named: encoders take one when they're constructed
+class triport {
+public:
+  class port {};
+};
+
+// Position and velocity are whatever a benchmark gives them, in revolutions and revolutions per minute
+class encoder : public device {
+public:
+  encoder(triport::port &) {}
+  void setRotation(double val, rotationUnits units) { position_rev = (units == rotationUnits::rev) ? val : val / 360; }
+  void setPosition(double val, rotationUnits units) { setRotation(val, units); }
+  double rotation(rotationUnits units) { return (units == rotationUnits::rev) ? position_rev : position_rev * 360; }
+  double position(rotationUnits units) { return rotation(units); }
+  double velocity(velocityUnits units) { return (units == velocityUnits::dps) ? velocity_rpm * 6 : velocity_rpm; }
+  double position_rev = 0, velocity_rpm = 0;
+};
+
+// Only the position, in revolutions, for odometry to read
+class motor_group {
+public:
+  double position(rotationUnits units) { return (units == rotationUnits::rev) ? position_rev : position_rev * 360; }
+  double position_rev = 0;
+};
+
+} // namespace vex
+
+inline void vexDelay(uint32_t ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+using namespace vex;
@@ -0,0 +1,115 @@
+/**
+ * Odometry calibration: fits the measurements odometry depends on from a recording of the robot driving.
+ *
+ * Runs on a computer, using the same core/src/subsystems/odometry/odometry_kinematics.cpp the robot does, so the
+ * fitted values mean exactly what they will on the brain. Record with OdometryRecorder (odometry_recorder.h); see
+ * odometry_calibration.h for what a recording holds.
+ *
+ * Build (from the repository root):
+ *   g++ -std=gnu++17 -O2 -Itools/host -Iinclude -o fit_odometry tools/odometry_calibration/fit_odometry.cpp \
+ *       core/src/subsystems/odometry/odometry_calibration.cpp core/src/subsystems/odometry/odometry_kinematics.cpp \
+ *       core/src/utils/least_squares.cpp core/src/utils/math_util.cpp core/src/utils/vector2d.cpp
+ *
+ * Usage:
+ *   ./fit_odometry 3wheel run.csv <wheel_diam> <wheelbase_dist> <off_axis_center_dist>
+ *   ./fit_odometry tank run.csv <odom_wheel_diam> <odom_gear_ratio> <dist_between_wheels>
+ * The numbers are starting guesses; measure them roughly with a ruler.
+ *
+ * Recording format, one line each, as written by format_calibration_sample() / format_calibration_reference():
+ *   sample,<lside>,<rside>,<offax>,<has_imu 0/1>,<imu_rotation_deg>
+ *   reference,<sample index, -1 for the sample just before>,<x>,<y>,<rot>,<use_position 0/1>,<use_rotation 0/1>
+ * Optional settings lines change how much each measurement is trusted:
+ *   pos_stddev 0.5 | rot_stddev 1 | imu_stddev 2 | imu_stride 25
+ */
+#include "../../core/include/subsystems/odometry/odometry_calibration.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static bool read_log(const char *filename, calibration_log_t &log) {
+  FILE *f = fopen(filename, "r");
+  if (f == NULL) {
+    fprintf(stderr, "Can't open %s\n", filename);
+    return false;
+  }
+
+  char line[256];
+  int line_num = 0;
+  bool ok = true;
+  while (fgets(line, sizeof(line), f) != NULL) {
+    line_num++;
+    bool parsed;
+    if (strncmp(line, "pos_stddev", 10) == 0) {
+      parsed = sscanf(line, "%*s %lf", &log.pos_stddev) == 1;
+    } else if (strncmp(line, "rot_stddev", 10) == 0) {
+      parsed = sscanf(line, "%*s %lf", &log.rot_stddev_deg) == 1;
+    } else if (strncmp(line, "imu_stddev", 10) == 0) {
+      parsed = sscanf(line, "%*s %lf", &log.imu_stddev_deg) == 1;
+    } else if (strncmp(line, "imu_stride", 10) == 0) {
+      parsed = sscanf(line, "%*s %d", &log.imu_stride) == 1;
+    } else {
+      parsed = parse_calibration_line(line, log);
+    }
+
+    if (!parsed) {
+      fprintf(stderr, "%s:%d: can't understand '%s'\n", filename, line_num, line);
+      ok = false;
+    }
+  }
+  fclose(f);
+
+  if (log.references.empty()) {
+    fprintf(stderr, "%s: needs at least a starting reference\n", filename);
+    ok = false;
+  }
+  return ok;
+}
+
+static void print_result(const calibration_result_t &result) {
+  printf("\n%s after %d iterations, rms error %.3f -> %.3f standard deviations\n",
+         result.fit.converged ? "Converged" : "Did not converge", result.fit.iterations, result.fit.rms_start,
+         result.fit.rms_end);
+
+  printf("\nsample,x_err,y_err,rot_err_deg\n");
+  for (const calibration_residual_t &res : result.residuals) {
+    printf("%d,%.3f,%.3f,%.3f\n", res.sample, res.x_err, res.y_err, res.rot_err_deg);
+  }
+}
+
+int main(int argc, char **argv) {
+  if (argc != 6 || (strcmp(argv[1], "3wheel") != 0 && strcmp(argv[1], "tank") != 0)) {
+    fprintf(stderr, "Usage: %s 3wheel <recording> <wheel_diam> <wheelbase_dist> <off_axis_center_dist>\n", argv[0]);
+    fprintf(stderr, "       %s tank <recording> <odom_wheel_diam> <odom_gear_ratio> <dist_between_wheels>\n", argv[0]);
+    return 1;
+  }
+
+  calibration_log_t log;
+  if (!read_log(argv[2], log)) {
+    return 1;
+  }
+  printf("%d samples, %d references\n", (int)log.samples.size(), (int)log.references.size());
+
+  calibration_result_t result;
+  if (strcmp(argv[1], "3wheel") == 0) {
+    double wheel_diam = atof(argv[3]);
+    double wheelbase_dist = atof(argv[4]);
+    double off_axis_center_dist = atof(argv[5]);
+    result = calibrate_three_wheel(log, wheel_diam, wheelbase_dist, off_axis_center_dist);
+    printf("\nodometry3wheel_cfg_t:\n");
+    printf("  .wheelbase_dist = %.4f,\n", wheelbase_dist);
+    printf("  .off_axis_center_dist = %.4f,\n", off_axis_center_dist);
+    printf("  .wheel_diam = %.4f,\n", wheel_diam);
+  } else {
+    double wheel_diam = atof(argv[3]);
+    double gear_ratio = atof(argv[4]);
+    double dist_between_wheels = atof(argv[5]);
+    result = calibrate_tank(log, wheel_diam, gear_ratio, dist_between_wheels);
+    printf("\nrobot_specs_t:\n");
+    printf("  .odom_wheel_diam = %.4f,\n", wheel_diam);
+    printf("  .odom_gear_ratio = %.4f,\n", gear_ratio);
+    printf("  .dist_between_wheels = %.4f,\n", dist_between_wheels);
+  }
+
+  print_result(result);
+  return result.fit.converged ? 0 : 2;
+}
@@ -0,0 +1,159 @@
+/**
+ * Path compiler: turns a plain text waypoint file into a binary path blob for PurePursuit::PathBlob.
+ *
+ * Runs on a computer, using the same core/src/utils/pure_pursuit.cpp the robot does, so the baked
+ * points are exactly what smooth_path_hermite() / inject_path() / smooth_path() would produce on the brain.
+ *
+ * Build (from the repository root):
+ *   g++ -std=gnu++17 -O2 -Itools/host -Iinclude -o path_compiler tools/path_compiler/path_compiler.cpp \
+ *       core/src/utils/pure_pursuit.cpp core/src/utils/math_util.cpp core/src/utils/vector2d.cpp
+ *
+ * Usage:
+ *   ./path_compiler skills_1.txt skills_1.path
+ * then copy skills_1.path to the SD card.
+ *
+ * Waypoint file format, one command per line, '#' starts a comment:
+ *   radius 8                  pure pursuit lookahead radius (required)
+ *   steps 20                  hermite interpolation steps between waypoints (0 = use the waypoints as is)
+ *   spacing 1                 inject points this far apart (0 = don't inject)
+ *   smooth 0.25 0.75 0.001    smooth_path() weight_data, weight_smooth, tolerance (omit to skip)
+ *   point 0 0 0 40            hermite waypoint: x y direction(radians) tangent_magnitude
+ *   point 24 24 1.57 40
+ *
+ * Processing order is hermite interpolation, then injection, then smoothing.
+ */
+#include "../../core/include/utils/path_blob.h"
+#include <stdio.h>
+#include <string.h>
+
+using namespace PurePursuit;
+
+typedef struct {
+  double radius;
+  int steps;
+  double spacing;
+  bool smooth;
+  double weight_data, weight_smooth, tolerance;
+  std::vector<hermite_point> waypoints;
+} path_file_t;
+
+static bool read_path_file(const char *filename, path_file_t &out) {
+  FILE *f = fopen(filename, "r");
+  if (f == NULL) {
+    fprintf(stderr, "Can't open %s\n", filename);
+    return false;
+  }
+
+  out = path_file_t{0, 0, 0, false, 0, 0, 0, {}};
+
+  char line[256];
+  int line_num = 0;
+  bool ok = true;
+  while (fgets(line, sizeof(line), f) != NULL) {
+    line_num++;
+    char *comment = strchr(line, '#');
+    if (comment != NULL) {
+      *comment = '\0';
+    }
+
+    char cmd[32];
+    if (sscanf(line, "%31s", cmd) != 1) {
+      continue; // blank line
+    }
+
+    hermite_point p;
+    bool parsed;
+    if (strcmp(cmd, "radius") == 0) {
+      parsed = sscanf(line, "%*s %lf", &out.radius) == 1;
+    } else if (strcmp(cmd, "steps") == 0) {
+      parsed = sscanf(line, "%*s %d", &out.steps) == 1;
+    } else if (strcmp(cmd, "spacing") == 0) {
+      parsed = sscanf(line, "%*s %lf", &out.spacing) == 1;
+    } else if (strcmp(cmd, "smooth") == 0) {
+      parsed = sscanf(line, "%*s %lf %lf %lf", &out.weight_data, &out.weight_smooth, &out.tolerance) == 3;
+      out.smooth = true;
+    } else if (strcmp(cmd, "point") == 0) {
+      parsed = sscanf(line, "%*s %lf %lf %lf %lf", &p.x, &p.y, &p.dir, &p.mag) == 4;
+      out.waypoints.push_back(p);
+    } else {
+      parsed = false;
+    }
+
+    if (!parsed) {
+      fprintf(stderr, "%s:%d: can't understand '%s'\n", filename, line_num, cmd);
+      ok = false;
+    }
+  }
+  fclose(f);
+
+  if (out.radius <= 0) {
+    fprintf(stderr, "%s: missing radius\n", filename);
+    ok = false;
+  }
+  if (out.waypoints.size() < 2) {
+    fprintf(stderr, "%s: need at least 2 points\n", filename);
+    ok = false;
+  }
+  return ok;
+}
+
+static bool write_blob(const char *filename, const std::vector<point_t> &points, const path_file_t &cfg) {
+  path_blob_header_t header;
+  memset(&header, 0, sizeof(header));
+  header.magic = PATH_BLOB_MAGIC;
+  header.version = PATH_BLOB_VERSION;
+  header.num_points = points.size();
+  header.radius = cfg.radius;
+  header.spacing = cfg.spacing;
+
+  FILE *f = fopen(filename, "wb");
+  if (f == NULL) {
+    fprintf(stderr, "Can't open %s for writing\n", filename);
+    return false;
+  }
+  bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+            fwrite(points.data(), sizeof(point_t), points.size(), f) == points.size();
+  fclose(f);
+  if (!ok) {
+    fprintf(stderr, "Error writing %s\n", filename);
+  }
+  return ok;
+}
+
+int main(int argc, char **argv) {
+  if (argc != 3) {
+    fprintf(stderr, "Usage: %s <waypoint file> <output blob>\n", argv[0]);
+    return 1;
+  }
+
+  path_file_t cfg;
+  if (!read_path_file(argv[1], cfg)) {
+    return 1;
+  }
+
+  std::vector<point_t> points;
+  if (cfg.steps > 0) {
+    points = smooth_path_hermite(cfg.waypoints, cfg.steps);
+  } else {
+    for (const hermite_point &p : cfg.waypoints) {
+      points.push_back(p.getPoint());
+    }
+  }
+  if (cfg.spacing > 0) {
+    points = inject_path(points, cfg.spacing);
+  }
+  if (cfg.smooth) {
+    points = smooth_path(points, cfg.weight_data, cfg.weight_smooth, cfg.tolerance);
+  }
+
+  Path path(points, cfg.radius);
+  if (!path.is_valid()) {
+    fprintf(stderr, "Warning: some segments intersect or are closer than the radius (Path::is_valid)\n");
+  }
+
+  if (!write_blob(argv[2], points, cfg)) {
+    return 1;
+  }
+  printf("Wrote %s: %d points, %.2f in long\n", argv[2], (int)points.size(), path.get_length());
+  return 0;
+}